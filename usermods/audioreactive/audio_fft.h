@@ -0,0 +1,286 @@
+#pragma once
+/*
+   FFT backends for the audioreactive usermod
+
+   All backends (except ArduinoFFT) exploit that the input is real-valued: the N samples are packed
+   as N/2 complex values, a complex FFT of half the size is computed and the result is split into
+   the spectrum of the real input. Windowing and twiddle factors are precomputed by fftInit(), which
+   can be called again when the FFT size changes.
+
+   SR_FFT_ARDUINOFFT  ArduinoFFT library, full size complex FFT (original implementation)
+   SR_FFT_REAL        real-input FFT, float (default on MCUs with FPU)
+   SR_FFT_FIXED       real-input FFT, int32 data with Q15 twiddles (default on ESP32-S2 and -C3, which have no FPU)
+   SR_FFT_ESPDSP      real-input FFT, complex part done by ESP-DSP (dsps_fft2r_fc32) - falls back to SR_FFT_REAL if ESP-DSP is not available
+
+   Output of fftComputeMagnitudes() matches the ArduinoFFT sequence dcRemoval() -> windowing(Flat_top) -> compute() -> complexToMagnitude()
+   for bins 0 ... samples/2+1; the remaining (mirrored) bins are set to 0.
+*/
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SR_FFT_ARDUINOFFT 0
+#define SR_FFT_REAL       1
+#define SR_FFT_FIXED      2
+#define SR_FFT_ESPDSP     3
+
+#ifndef SR_FFT_BACKEND
+  #if defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32C3)
+    #define SR_FFT_BACKEND SR_FFT_FIXED
+  #else
+    #define SR_FFT_BACKEND SR_FFT_REAL
+  #endif
+#endif
+
+#if SR_FFT_BACKEND == SR_FFT_ESPDSP
+  #if __has_include(<dsps_fft2r.h>)
+    #include <dsps_fft2r.h>
+  #else
+    #warning ESP-DSP not available, using SR_FFT_REAL backend.
+    #undef  SR_FFT_BACKEND
+    #define SR_FFT_BACKEND SR_FFT_REAL
+  #endif
+#endif
+
+#if SR_FFT_BACKEND != SR_FFT_ARDUINOFFT
+
+#if SR_FFT_BACKEND == SR_FFT_FIXED
+#define FFT_FIXED_FRAC 4                 // fractional bits of input samples (Q4) - keeps 3 bits headroom for 512 samples
+typedef int16_t fftCoeff_t;              // Q15
+#else
+typedef float   fftCoeff_t;
+#endif
+
+static fftCoeff_t* fftWindow = nullptr;  // precomputed "Flat Top" window, one factor per sample
+static fftCoeff_t* fftCos = nullptr;     // twiddle factors cos(2*pi*k/N), k = 0 ... N/2-1
+static fftCoeff_t* fftSin = nullptr;     // twiddle factors sin(2*pi*k/N)
+static uint16_t    fftSize = 0;          // number of samples the tables were computed for
+#if SR_FFT_BACKEND == SR_FFT_FIXED
+static uint8_t     fftFrac = FFT_FIXED_FRAC; // fractional bits actually used - one less per doubling of FFT size above 512
+#endif
+
+static inline fftCoeff_t fftCoeff(float v) {
+#if SR_FFT_BACKEND == SR_FFT_FIXED
+  return (fftCoeff_t)constrain(lrintf(v * 32768.0f), -32767L, 32767L);
+#else
+  return v;
+#endif
+}
+
+// release window and twiddle tables
+static void fftEnd(void) {
+  free(fftWindow); fftWindow = nullptr;
+  free(fftCos);    fftCos = nullptr;
+  free(fftSin);    fftSin = nullptr;
+#if SR_FFT_BACKEND == SR_FFT_ESPDSP
+  if (fftSize > 0) dsps_fft2r_deinit_fc32();
+#endif
+  fftSize = 0;
+}
+
+// allocate and fill window and twiddle tables; can be called again with a different size. returns false if out of memory
+static bool fftInit(uint16_t samples) {
+  if (samples == fftSize) return true;
+  fftEnd();
+  fftWindow = (fftCoeff_t*) malloc(samples * sizeof(fftCoeff_t));
+  fftCos    = (fftCoeff_t*) malloc(samples / 2 * sizeof(fftCoeff_t));
+  fftSin    = (fftCoeff_t*) malloc(samples / 2 * sizeof(fftCoeff_t));
+  if ((fftWindow == nullptr) || (fftCos == nullptr) || (fftSin == nullptr)) {
+    fftEnd();
+    return false;
+  }
+#if SR_FFT_BACKEND == SR_FFT_ESPDSP
+  if (dsps_fft2r_init_fc32(nullptr, samples / 2) != ESP_OK) {
+    fftEnd();
+    return false;
+  }
+#endif
+  fftSize = samples;
+#if SR_FFT_BACKEND == SR_FFT_FIXED
+  fftFrac = FFT_FIXED_FRAC;
+  for (unsigned n = 512; (n < samples) && (fftFrac > 0); n <<= 1) fftFrac--;  // keep headroom constant for larger FFT sizes
+#endif
+  constexpr float twoPi = 2.0f * float(M_PI);
+  // same factors as ArduinoFFT windowing(FFTWindow::Flat_top)
+  const float samplesMinusOne = float(samples) - 1.0f;
+  for (unsigned i = 0; i < samples / 2; i++) {
+    float ratio = float(i) / samplesMinusOne;
+    float w = 0.2810639f - (0.5208972f * cosf(twoPi * ratio)) + (0.1980399f * cosf(2.0f * twoPi * ratio));
+    fftWindow[i] = fftWindow[samples - (i + 1)] = fftCoeff(w);
+  }
+  for (unsigned k = 0; k < samples / 2; k++) {
+    fftCos[k] = fftCoeff(cosf(twoPi * float(k) / float(samples)));
+    fftSin[k] = fftCoeff(sinf(twoPi * float(k) / float(samples)));
+  }
+  return true;
+}
+
+// in-place bit reversal permutation of n interleaved complex values
+template<typename T> static void fftBitReverse(T *data, unsigned n) {
+  for (unsigned i = 1, j = 0; i < n; i++) {
+    unsigned bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) {
+      T t = data[2*i];   data[2*i]   = data[2*j];   data[2*j]   = t;
+      t   = data[2*i+1]; data[2*i+1] = data[2*j+1]; data[2*j+1] = t;
+    }
+  }
+}
+
+#if SR_FFT_BACKEND == SR_FFT_FIXED
+
+static uint32_t fftSqrt(uint64_t v) {
+  uint64_t res = 0;
+  uint64_t bit = 1ULL << 62;
+  while (bit > v) bit >>= 2;
+  while (bit) {
+    if (v >= res + bit) {
+      v -= res + bit;
+      res = (res >> 1) + bit;
+    } else res >>= 1;
+    bit >>= 2;
+  }
+  return res;
+}
+
+static inline int32_t fftMul(int32_t a, int32_t b, int32_t c, int32_t d) { // (a*b + c*d) in Q15
+  return (int32_t)(((int64_t)a * b + (int64_t)c * d + (1 << 14)) >> 15);
+}
+
+// radix-2 decimation in time, n interleaved complex values, twiddles taken from tables of size n (stride 2)
+static void fftComplex(int32_t *data, unsigned n) {
+  fftBitReverse(data, n);
+  for (unsigned len = 2; len <= n; len <<= 1) {
+    unsigned half = len >> 1;
+    unsigned step = 2 * n / len;
+    for (unsigned j = 0; j < half; j++) {
+      int32_t c = fftCos[j * step];
+      int32_t s = fftSin[j * step];
+      for (unsigned i = j; i < n; i += len) {
+        int32_t *u = data + 2*i;
+        int32_t *v = data + 2*(i + half);
+        int32_t tr = fftMul(c, v[0],  s, v[1]);
+        int32_t ti = fftMul(c, v[1], -s, v[0]);
+        v[0] = u[0] - tr; v[1] = u[1] - ti;
+        u[0] += tr;       u[1] += ti;
+      }
+    }
+  }
+}
+
+// vImag is used as int32 work buffer
+static void fftComputeMagnitudes(float *vReal, float *vImag, uint16_t samples) {
+  const unsigned n = samples / 2;
+  int32_t *z = reinterpret_cast<int32_t*>(vImag);
+  int64_t sum = 0;
+  for (unsigned i = 0; i < samples; i++) {
+    z[i] = lrintf(constrain(vReal[i], -32767.0f, 32767.0f) * float(1 << fftFrac));
+    sum += z[i];
+  }
+  const int32_t mean = sum / samples;
+  for (unsigned i = 0; i < samples; i++) {
+    int32_t x = constrain(z[i] - mean, -(32767 << fftFrac), 32767 << fftFrac);
+    z[i] = ((int64_t)x * fftWindow[i]) >> 15;
+  }
+  fftComplex(z, n);
+  // split into spectrum of real input
+  const float scale = 1.0f / float(1 << fftFrac);
+  vReal[0] = float((uint32_t)abs(z[0] + z[1])) * scale;
+  vReal[n] = float((uint32_t)abs(z[0] - z[1])) * scale;
+  for (unsigned k = 1; k < n; k++) {
+    int32_t ar = z[2*k],       ai = z[2*k+1];
+    int32_t br = z[2*(n-k)],   bi = -z[2*(n-k)+1];
+    int32_t er = (ar + br) / 2, ei = (ai + bi) / 2;
+    int32_t dr = (ar - br) / 2, di = (ai - bi) / 2;
+    int32_t xr = er + fftMul(fftCos[k], di, -fftSin[k], dr);
+    int32_t xi = ei - fftMul(fftCos[k], dr,  fftSin[k], di);
+    vReal[k] = float(fftSqrt((int64_t)xr * xr + (int64_t)xi * xi)) * scale;
+  }
+  vReal[n+1] = vReal[n-1];
+  memset(vReal + n + 2, 0, (samples - n - 2) * sizeof(float));
+}
+
+#else // float backends
+
+#if SR_FFT_BACKEND == SR_FFT_ESPDSP
+static inline void fftComplex(float *data, unsigned n) {
+  dsps_fft2r_fc32(data, n);
+  dsps_bit_rev_fc32(data, n);
+}
+#else
+// radix-2 decimation in time, n interleaved complex values, twiddles taken from tables of size n (stride 2)
+static void fftComplex(float *data, unsigned n) {
+  fftBitReverse(data, n);
+  for (unsigned len = 2; len <= n; len <<= 1) {
+    unsigned half = len >> 1;
+    unsigned step = 2 * n / len;
+    for (unsigned j = 0; j < half; j++) {
+      float c = fftCos[j * step];
+      float s = fftSin[j * step];
+      for (unsigned i = j; i < n; i += len) {
+        float *u = data + 2*i;
+        float *v = data + 2*(i + half);
+        float tr = c * v[0] + s * v[1];
+        float ti = c * v[1] - s * v[0];
+        v[0] = u[0] - tr; v[1] = u[1] - ti;
+        u[0] += tr;       u[1] += ti;
+      }
+    }
+  }
+}
+#endif
+
+// samples are transformed in place, vImag receives magnitudes before they are copied back
+static void fftComputeMagnitudes(float *vReal, float *vImag, uint16_t samples) {
+  const unsigned n = samples / 2;
+  float mean = 0.0f;
+  for (unsigned i = 0; i < samples; i++) mean += vReal[i];
+  mean /= float(samples);
+  for (unsigned i = 0; i < samples; i++) vReal[i] = (vReal[i] - mean) * fftWindow[i];
+  fftComplex(vReal, n);  // even samples are real parts, odd samples imaginary parts
+  // split into spectrum of real input
+  const float *z = vReal;
+  vImag[0] = fabsf(z[0] + z[1]);
+  vImag[n] = fabsf(z[0] - z[1]);
+  for (unsigned k = 1; k < n; k++) {
+    float ar = z[2*k],     ai = z[2*k+1];
+    float br = z[2*(n-k)], bi = -z[2*(n-k)+1];
+    float er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+    float dr = 0.5f * (ar - br), di = 0.5f * (ai - bi);
+    float xr = er + fftCos[k] * di - fftSin[k] * dr;
+    float xi = ei - fftCos[k] * dr - fftSin[k] * di;
+    vImag[k] = sqrtf(xr * xr + xi * xi);
+  }
+  vImag[n+1] = vImag[n-1];
+  memcpy(vReal, vImag, (n + 2) * sizeof(float));
+  memset(vReal + n + 2, 0, (samples - n - 2) * sizeof(float));
+}
+
+#endif
+
+// same as ArduinoFFT majorPeak(): strongest local maximum with parabolic interpolation
+static void fftMajorPeak(const float *mag, uint16_t samples, float samplingFrequency, float *f, float *v) {
+  float maxY = 0.0f;
+  unsigned idx = 0;
+  for (unsigned i = 1; i < (samples >> 1) + 1U; i++) {
+    if ((mag[i-1] < mag[i]) && (mag[i] > mag[i+1]) && (mag[i] > maxY)) {
+      maxY = mag[i];
+      idx = i;
+    }
+  }
+  if (idx == 0) {
+    *f = 0.0f;
+    *v = 0.0f;
+    return;
+  }
+  float curve = mag[idx-1] - (2.0f * mag[idx]) + mag[idx+1];
+  float delta = 0.5f * ((mag[idx-1] - mag[idx+1]) / curve);
+  float interpolatedX = ((idx + delta) * samplingFrequency) / float(samples - 1);
+  if (idx == (samples >> 1U)) interpolatedX = ((idx + delta) * samplingFrequency) / float(samples);
+  *f = interpolatedX;
+  *v = fabsf(curve);
+}
+
+#endif
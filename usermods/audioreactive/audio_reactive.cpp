@@ -30,6 +30,7 @@
 // #define MIC_LOGGER                   // MIC sampling & sound input debugging (serial plotter)
 // #define FFT_SAMPLING_LOG             // FFT result debugging
 // #define SR_DEBUG                     // generic SR DEBUG messages
+// #define SR_REPLAY_DUMP               // WAV file replay: one JSON line per processed block (results and stage timings), needs SR_WAV_REPLAY
 
 #ifdef SR_DEBUG
   #define DEBUGSR_PRINT(x) DEBUGOUT.print(x)
@@ -58,6 +59,7 @@ static uint8_t audioSyncEnabled = 0;          // bit field: bit 0 - send, bit 1
 static bool udpSyncConnected = false;         // UDP connection status -> true if connected to multicast group
 
 #define NUM_GEQ_CHANNELS 16                                           // number of frequency channels. Don't change !!
+#define MAX_GEQ_BANDS    64                                           // max number of extended frequency bands (config "frequency:bands")
 
 // audioreactive variables
 #ifdef ARDUINO_ARCH_ESP32
@@ -77,6 +79,13 @@ static bool samplePeak = false;      // Boolean flag for peak - used in effects.
 static bool udpSamplePeak = false;   // Boolean flag for peak. Set at the same time as samplePeak, but reset by transmitAudioData
 static unsigned long timeOfPeak = 0; // time of last sample peak detection.
 static uint8_t fftResult[NUM_GEQ_CHANNELS]= {0};// Our calculated freq. channel result table to be used by effects
+static uint8_t fftResultExt[MAX_GEQ_BANDS] = {0};// extended frequency bands (same scaling as fftResult) - only the first numGEQBands entries are valid
+static uint8_t numGEQBands = NUM_GEQ_CHANNELS;  // number of valid entries in fftResultExt[]
+static uint32_t audioSequence = 0;              // sequence number of the audio result currently visible to effects (incremented per FFT run or received packet)
+static uint32_t audioTimestamp = 0;             // millis() when the samples of the current audio result were captured - effects can use it to compute data age
+static float beatBPM = 0.0f;                    // estimated tempo in beats per minute, 0 = unknown
+static float beatPhase = 0.0f;                  // position within current beat 0 ... 1 (0 = on the beat), advanced in loop()
+static float beatConfidence = 0.0f;             // 0 ... 1 - how periodic the onsets are; don't rely on beatBPM below ~0.3
 
 // TODO: probably best not used by receive nodes
 //static float agcSensitivity = 128;            // AGC sensitivity estimation, based on agc gain (multAgc). calculated by getSensitivity(). range 0..255
@@ -103,7 +112,10 @@ static uint8_t binNum = 8;           // Used to select the bin for FFT based bea
 // use audio source class (ESP32 specific)
 #include "audio_source.h"
 constexpr i2s_port_t I2S_PORT = I2S_NUM_0;       // I2S port to use (do not change !)
-constexpr int BLOCK_SIZE = 128;                  // I2S buffer size (samples)
+#ifndef SR_BLOCK_SIZE
+#define SR_BLOCK_SIZE 128
+#endif
+constexpr int BLOCK_SIZE = SR_BLOCK_SIZE;        // I2S buffer size (samples) - size of one DMA buffer, SR_DMA_BUFFERS are used
 
 // globals
 static uint8_t inputLevel = 128;              // UI slider value
@@ -119,6 +131,11 @@ static uint8_t inputLevel = 128;              // UI slider value
 #endif
 // user settable options for FFTResult scaling
 static uint8_t FFTScalingMode = 3;            // 0 none; 1 optimized logarithmic; 2 optimized linear; 3 optimized square root
+// user settable FFT parameters - picked up by the FFT task at the start of its next cycle
+static uint16_t cfgFFTSize = 512;             // 512, 1024 or 2048 samples (config value)
+static bool     cfgFFTOverlap = false;        // true: 50% overlapping windows, i.e. twice the FFT rate (config value)
+static uint8_t  cfgGEQBands = NUM_GEQ_CHANNELS; // 16, 32 or 64 extended frequency bands (config value)
+static bool     continuousRead = false;       // true: FFT task waits for new samples instead of sleeping for a fixed time - lower latency (config value)
 
 // 
 // AGC presets
@@ -147,10 +164,25 @@ static bool useBandPassFilter = false;                    // if true, enables a
 ////////////////////
 
 // some prototypes, to ensure consistent interfaces
-static float fftAddAvg(int from, int to);   // average of several FFT result bins
+static bool setupFFT(void);          // (re)allocate FFT buffers and tables for the configured FFT size, overlap and bands
 void FFTcode(void * parameter);      // audio processing task: read samples, run FFT, fill GEQ channels from FFT results
+static void processSamples(void);    // processing chain for one batch of samples: FFT, GEQ channels, peak detection
+static void publishAudioResult(void); // FFT task: make latest results visible to loop()
+static void detectOnsetAndTempo(void); // FFT task: spectral flux onsets, BPM and beat phase
+static void setTempoRate(float rate);  // FFT task: set number of onset values per second (FFT runs per second)
 static void runMicFilter(uint16_t numSamples, float *sampleBuffer);          // pre-filtering of raw samples (band-pass)
-static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels); // post-processing and post-amp of GEQ channels
+static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels, float *calc, float *avg, uint8_t *result); // post-processing and post-amp of GEQ channels
+
+#if defined(SR_WAV_REPLAY) && defined(SR_REPLAY_DUMP)
+// per block dump of replayed files, for comparing filter/FFT changes offline: micros() taken after each processing stage
+enum { STAGE_START, STAGE_SAMPLES, STAGE_FFT, STAGE_GEQ, STAGE_ONSET, STAGE_POST, STAGE_COUNT };
+static uint32_t stageTime[STAGE_COUNT];
+static bool replayDump = false;      // audio source is WAV file replay
+static void dumpReplayBlock(void);   // FFT task: print results of last block
+#define STAGE_MARK(s) stageTime[s] = micros()
+#else
+#define STAGE_MARK(s)
+#endif
 
 static TaskHandle_t FFT_Task = nullptr;
 
@@ -175,14 +207,13 @@ constexpr SRate_t SAMPLE_RATE = 22050;        // Base sample rate in Hz - 22Khz
 //constexpr SRate_t SAMPLE_RATE = 16000;        // 16kHz - use if FFTtask takes more than 20ms. Physical sample time -> 32ms
 //constexpr SRate_t SAMPLE_RATE = 20480;        // Base sample rate in Hz - 20Khz is experimental.    Physical sample time -> 25ms
 //constexpr SRate_t SAMPLE_RATE = 10240;        // Base sample rate in Hz - previous default.         Physical sample time -> 50ms
-#define FFT_MIN_CYCLE 21                      // minimum time before FFT task is repeated. Use with 22Khz sampling
-//#define FFT_MIN_CYCLE 30                      // Use with 16Khz sampling
-//#define FFT_MIN_CYCLE 23                      // minimum time before FFT task is repeated. Use with 20Khz sampling
-//#define FFT_MIN_CYCLE 46                      // minimum time before FFT task is repeated. Use with 10Khz sampling
+// minimum time before FFT task is repeated is derived from sample rate, FFT size and overlap - see setupFFT()
 
 // FFT Constants
-constexpr uint16_t samplesFFT = 512;            // Samples in an FFT batch - This value MUST ALWAYS be a power of 2
-constexpr uint16_t samplesFFT_2 = 256;          // meaningfull part of FFT results - only the "lower half" contains useful information.
+#define FFT_MIN_SIZE    512                     // smallest (and default) FFT size - GEQ channel mapping is defined for this size
+static uint16_t samplesFFT = FFT_MIN_SIZE;      // Samples in an FFT batch - This value MUST ALWAYS be a power of 2 (512, 1024 or 2048)
+static uint16_t fftHop = FFT_MIN_SIZE;          // new samples per FFT run - samplesFFT, or samplesFFT/2 with 50% overlap
+static uint8_t  fftCycle = 21;                  // minimum time before FFT task is repeated (ms) - 21 for 512 new samples @ 22Khz
 // the following are observed values, supported by a bit of "educated guessing"
 //#define FFT_DOWNSCALE 0.65f                             // 20kHz - downscaling factor for FFT results - "Flat-Top" window @20Khz, old freq channels 
 #define FFT_DOWNSCALE 0.46f                             // downscaling factor for FFT results - for "Flat-Top" window @22Khz, new freq channels
@@ -191,6 +222,29 @@ constexpr uint16_t samplesFFT_2 = 256;          // meaningfull part of FFT resul
 // These are the input and output vectors.  Input vectors receive computed results from FFT.
 static float* vReal = nullptr;                  // FFT sample inputs / freq output -  these are our raw result bins
 static float* vImag = nullptr;                  // imaginary parts
+static float* sampleWindow = nullptr;           // with overlap: the last samplesFFT samples (vReal is overwritten by the FFT)
+
+// FFT task results are handed over to the loop task as a whole, so effects never see a half-updated GEQ array.
+// The FFT task fills audioWork, then copies it to audioShared under a sequence lock; loop() takes a consistent copy
+// and updates fftResult[], FFT_MajorPeak, FFT_Magnitude and samplePeak, which are only written by the loop task.
+typedef struct AudioResult {
+  uint8_t  fftResult[NUM_GEQ_CHANNELS];
+  uint8_t  fftResultExt[MAX_GEQ_BANDS];
+  uint8_t  numBands;                            // valid entries in fftResultExt[]
+  float    majorPeak;
+  float    magnitude;
+  uint32_t peaks;                               // number of detected peaks since start
+  float    bpm;                                 // estimated tempo, 0 = unknown
+  float    beatPhase;                           // 0 ... 1 at capture time, 0 = on the beat
+  float    beatConfidence;                      // 0 ... 1
+  uint32_t sequence;                            // number of published results since start
+  uint32_t timestamp;                           // millis() when samples were captured
+} audioResult_t;
+static audioResult_t audioWork;                 // FFT task only
+static audioResult_t audioShared;               // protected by audioSeqLock
+static volatile uint32_t audioSeqLock = 0;      // odd while FFT task is writing audioShared
+static bool resultHasPeak = false;              // loop task: current result contains a newly detected peak (for v3 audio sync)
+static float resultBeatPhase = 0.0f;            // loop task: beat phase of current result at capture time
 
 // Create FFT object
 // lib_deps += https://github.com/kosme/arduinoFFT#develop @ 1.9.2
@@ -200,16 +254,147 @@ static float* vImag = nullptr;                  // imaginary parts
 // Below options are forcing ArduinoFFT to use sqrtf() instead of sqrt()
 // #define sqrt_internal sqrtf          // see https://github.com/kosme/arduinoFFT/pull/83 - since v2.0.0 this must be done in build_flags
 
-#include <arduinoFFT.h>             // FFT object is created in FFTcode
+#include "audio_fft.h"              // FFT backend selection (SR_FFT_BACKEND)
+#if SR_FFT_BACKEND == SR_FFT_ARDUINOFFT
+#include <arduinoFFT.h>
+static ArduinoFFT<float> *FFT = nullptr;   // FFT object is created by setupFFT()
+#endif
+
+// mapping of FFT result bins to a frequency band: weighted average of bins first ... last, the edge bins may only count partially
+typedef struct GEQBand {
+  uint16_t first;                               // first FFT bin
+  uint16_t last;                                // last FFT bin
+  float    firstWeight;                         // share of the first bin that belongs to the band
+  float    lastWeight;                          // share of the last bin (only if last > first)
+  float    scale;                               // damping divided by total weight
+} geqBand_t;
+static geqBand_t geqMap[NUM_GEQ_CHANNELS];      // standard GEQ channels
+static geqBand_t geqMapExt[MAX_GEQ_BANDS];      // extended bands (only used with more than NUM_GEQ_CHANNELS bands)
+static int8_t    geqMapBandPass = -1;           // band pass setting the tables were built for, -1 = rebuild needed
+static uint8_t   geqBands = NUM_GEQ_CHANNELS;   // FFT task: active number of extended bands
+static float     fftCalcExt[MAX_GEQ_BANDS] = {0.0f};  // extended bands, same as fftCalc[]
+static float     fftAvgExt[MAX_GEQ_BANDS] = {0.0f};   // extended bands, same as fftAvg[]
+
+// standard GEQ channels: bin ranges of a 512 point FFT @ 22050 Hz and damping. Larger FFT sizes use the same frequency ranges.
+typedef struct GEQChannel {
+  uint8_t from;
+  uint8_t to;
+  float   damping;
+} geqChannel_t;
+/* new mapping, optimized for 22050 Hz by softhack007 */
+static const geqChannel_t geqChannels[NUM_GEQ_CHANNELS] = {
+                      // bins frequency  range
+  {  1,   2, 1.0f },  // 1    43 - 86   sub-bass
+  {  2,   3, 1.0f },  // 1    86 - 129  bass
+  {  3,   5, 1.0f },  // 2   129 - 216  bass
+  {  5,   7, 1.0f },  // 2   216 - 301  bass + midrange
+  {  7,  10, 1.0f },  // 3   301 - 430  midrange
+  { 10,  13, 1.0f },  // 3   430 - 560  midrange
+  { 13,  19, 1.0f },  // 5   560 - 818  midrange
+  { 19,  26, 1.0f },  // 7   818 - 1120 midrange -- 1Khz should always be the center !
+  { 26,  33, 1.0f },  // 7  1120 - 1421 midrange
+  { 33,  44, 1.0f },  // 9  1421 - 1895 midrange
+  { 44,  56, 1.0f },  // 12 1895 - 2412 midrange + high mid
+  { 56,  70, 1.0f },  // 14 2412 - 3015 high mid
+  { 70,  86, 1.0f },  // 16 3015 - 3704 high mid
+  { 86, 104, 1.0f },  // 18 3704 - 4479 high mid
+  {104, 165, 0.88f},  // 61 4479 - 7106 high mid + high  -- with slight damping
+  {165, 215, 0.70f}   // 50 7106 - 9259 high             -- with some damping. don't use the last bins from 216 to 255. They are usually contaminated by aliasing (aka noise)
+};
+// with band pass filter: skip frequencies below 100hz (channels 0 ... 3), don't use the last bins from 206 to 255 (channel 15)
+static const geqChannel_t geqChannelsBandPass[5] = { {3, 4, 0.8f}, {4, 5, 0.9f}, {5, 6, 1.0f}, {6, 7, 1.0f}, {165, 205, 0.75f} };
+
+static const geqChannel_t& geqChannel(int i) {
+  if (useBandPassFilter) {
+    if (i < 4) return geqChannelsBandPass[i];
+    if (i == NUM_GEQ_CHANNELS-1) return geqChannelsBandPass[4];
+  }
+  return geqChannels[i];
+}
+
+// set up band for the frequency range [lo ... hi), given in units of FFT bins (bin k covers k-0.5 ... k+0.5)
+static void setGEQBand(geqBand_t &band, float lo, float hi, float damping) {
+  lo = constrain(lo, 0.5f, samplesFFT/2 - 1.0f);
+  hi = constrain(hi, lo + 0.01f, samplesFFT/2 - 0.5f);
+  band.first = lo + 0.5f;
+  band.last  = max(int(band.first), int(ceilf(hi - 0.5f)));
+  if (band.last == band.first) {
+    band.firstWeight = hi - lo;
+    band.lastWeight  = 0.0f;
+  } else {
+    band.firstWeight = (band.first + 0.5f) - lo;
+    band.lastWeight  = hi - (band.last - 0.5f);
+  }
+  float totalWeight = band.firstWeight + band.lastWeight + max(0, band.last - band.first - 1);
+  band.scale = damping / totalWeight;
+}
+
+// (re)build band tables for current FFT size, number of bands and band pass setting
+static void buildGEQMaps(void) {
+  const float k = float(samplesFFT) / float(FFT_MIN_SIZE);  // bins per bin of a 512 point FFT
+  for (int i = 0; i < NUM_GEQ_CHANNELS; i++) {
+    const geqChannel_t &ch = geqChannel(i);
+    setGEQBand(geqMap[i], (ch.from - 0.5f) * k, (ch.to + 0.5f) * k, ch.damping);
+  }
+  // extended bands: logarithmic spacing over the frequency range of the standard channels
+  if (geqBands > NUM_GEQ_CHANNELS) {
+    const float lo = (geqChannel(0).from - 0.5f) * k;
+    const float hi = (geqChannel(NUM_GEQ_CHANNELS-1).to + 0.5f) * k;
+    for (int i = 0; i < geqBands; i++) {
+      float bandLo = lo * powf(hi / lo, float(i)   / float(geqBands));
+      float bandHi = lo * powf(hi / lo, float(i+1) / float(geqBands));
+      setGEQBand(geqMapExt[i], bandLo, bandHi, geqChannel(i * NUM_GEQ_CHANNELS / geqBands).damping);
+    }
+  }
+  geqMapBandPass = useBandPassFilter;
+}
+
 // Helper functions
 
-// compute average of several FFT result bins
-static float fftAddAvg(int from, int to) {
-  float result = 0.0f;
-  for (int i = from; i <= to; i++) {
-    result += vReal[i];
+// compute weighted average of the FFT result bins of a band
+static float geqBandValue(const geqBand_t &band) {
+  float result = band.firstWeight * vReal[band.first];
+  if (band.last > band.first) {
+    for (int i = band.first + 1; i < band.last; i++) result += vReal[i];
+    result += band.lastWeight * vReal[band.last];
+  }
+  return result * band.scale;
+}
+
+// (re)allocate FFT buffers and tables for the configured FFT size, overlap and number of bands - FFT task only
+static bool setupFFT(void) {
+  if (vReal) free(vReal);
+  if (vImag) free(vImag);
+  if (sampleWindow) free(sampleWindow);
+  vReal = (float*) calloc(cfgFFTSize, sizeof(float));
+  vImag = (float*) calloc(cfgFFTSize, sizeof(float));
+  sampleWindow = cfgFFTOverlap ? (float*) calloc(cfgFFTSize, sizeof(float)) : nullptr;
+  bool success = (vReal != nullptr) && (vImag != nullptr) && (!cfgFFTOverlap || (sampleWindow != nullptr));
+#if SR_FFT_BACKEND == SR_FFT_ARDUINOFFT
+  if (FFT) delete FFT;
+  FFT = success ? new ArduinoFFT<float>( vReal, vImag, cfgFFTSize, SAMPLE_RATE, true) : nullptr; // with weighing factor storage
+#else
+  success = success && fftInit(cfgFFTSize);   // precompute window and twiddle factors
+#endif
+  if (!success) {
+    // something went wrong
+    if (vReal) free(vReal); vReal = nullptr;
+    if (vImag) free(vImag); vImag = nullptr;
+    if (sampleWindow) free(sampleWindow); sampleWindow = nullptr;
+    DEBUGSR_PRINTF("AR: FFT setup failed (%u samples).\n", cfgFFTSize);
+    return false;
   }
-  return result / float(to - from + 1);
+  samplesFFT = cfgFFTSize;
+  fftHop = cfgFFTOverlap ? samplesFFT / 2 : samplesFFT;
+  // time for fftHop new samples, minus some slack - but not more than the I2S DMA buffers can hold
+  fftCycle = (min(int(fftHop), SR_DMA_BUFFERS * BLOCK_SIZE) * 1000) / SAMPLE_RATE - 2;
+  geqBands = cfgGEQBands;
+  geqMapBandPass = -1;  // rebuild band tables
+  memset(fftCalcExt, 0, sizeof(fftCalcExt));
+  memset(fftAvgExt, 0, sizeof(fftAvgExt));
+  setTempoRate(float(SAMPLE_RATE) / float(fftHop));
+  DEBUGSR_PRINTF("AR: FFT size %u, %u new samples per cycle, %u bands.\n", samplesFFT, fftHop, geqBands);
+  return true;
 }
 
 //
@@ -220,19 +405,10 @@ void FFTcode(void * parameter)
   DEBUGSR_PRINT("FFT started on core: "); DEBUGSR_PRINTLN(xPortGetCoreID());
 
   // allocate FFT buffers on first call
-  if (vReal == nullptr) vReal = (float*) calloc(samplesFFT, sizeof(float));
-  if (vImag == nullptr) vImag = (float*) calloc(samplesFFT, sizeof(float));
-  if ((vReal == nullptr) || (vImag == nullptr)) {
-    // something went wrong
-    if (vReal) free(vReal); vReal = nullptr;
-    if (vImag) free(vImag); vImag = nullptr;
-    return;
-  }
-  // Create FFT object with weighing factor storage
-  ArduinoFFT<float> FFT = ArduinoFFT<float>( vReal, vImag, samplesFFT, SAMPLE_RATE, true);
+  if (!setupFFT()) return;
 
   // see https://www.freertos.org/vtaskdelayuntil.html
-  const TickType_t xFrequency = FFT_MIN_CYCLE * portTICK_PERIOD_MS;  
+  TickType_t xFrequency = fftCycle * portTICK_PERIOD_MS;
 
   TickType_t xLastWakeTime = xTaskGetTickCount();
   for(;;) {
@@ -247,156 +423,181 @@ void FFTcode(void * parameter)
 
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)
     uint64_t start = esp_timer_get_time();
-    bool haveDoneFFT = false; // indicates if second measurement (FFT time) is valid
 #endif
 
+    // FFT size, overlap or number of bands changed by user -> re-allocate buffers and tables
+    if ((cfgFFTSize != samplesFFT) || (cfgFFTOverlap != (fftHop < samplesFFT)) || (cfgGEQBands != geqBands)) {
+      if (!setupFFT()) {
+        cfgFFTSize = FFT_MIN_SIZE; cfgFFTOverlap = false;   // not enough memory - fall back to defaults
+        if (!setupFFT()) return;
+      }
+      xFrequency = fftCycle * portTICK_PERIOD_MS;
+    }
+
+    STAGE_MARK(STAGE_START);
     // get a fresh batch of samples from I2S
-    if (audioSource) audioSource->getSamples(vReal, samplesFFT);
-    memset(vImag, 0, samplesFFT * sizeof(float));   // set imaginary parts to 0
+    // band pass filter - can reduce noise floor by a factor of 50
+    // downside: frequencies below 100Hz will be ignored
+    if (fftHop < samplesFFT) {
+      // 50% overlap: keep the newest half of the last window and append new samples
+      memmove(sampleWindow, sampleWindow + fftHop, (samplesFFT - fftHop) * sizeof(float));
+      if (audioSource) audioSource->getSamples(sampleWindow + samplesFFT - fftHop, fftHop);
+      if (useBandPassFilter) runMicFilter(fftHop, sampleWindow + samplesFFT - fftHop);
+      memcpy(vReal, sampleWindow, samplesFFT * sizeof(float));
+    } else {
+      if (audioSource) audioSource->getSamples(vReal, samplesFFT);
+      if (useBandPassFilter) runMicFilter(samplesFFT, vReal);
+    }
+    audioWork.timestamp = millis();
+    STAGE_MARK(STAGE_SAMPLES);
 
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)
     if (start < esp_timer_get_time()) { // filter out overflows
       uint64_t sampleTimeInMillis = (esp_timer_get_time() - start +5ULL) / 10ULL; // "+5" to ensure proper rounding
       sampleTime = (sampleTimeInMillis*3 + sampleTime*7)/10; // smooth
     }
-    start = esp_timer_get_time(); // start measuring FFT time
 #endif
 
     xLastWakeTime = xTaskGetTickCount();       // update "last unblocked time" for vTaskDelay
 
-    // band pass filter - can reduce noise floor by a factor of 50
-    // downside: frequencies below 100Hz will be ignored
-    if (useBandPassFilter) runMicFilter(samplesFFT, vReal);
+    processSamples();                          // FFT, GEQ channels, peak detection
+#if defined(SR_WAV_REPLAY) && defined(SR_REPLAY_DUMP)
+    if (replayDump) dumpReplayBlock();
+#endif
+    publishAudioResult();                      // hand over results to loop() and effects
+
+    // continuous reading: no delay - the next getSamples() blocks until enough new samples have arrived, so they are as fresh as possible
+    // (only with a working audio source, otherwise nothing blocks and the task would spin)
+    if (continuousRead && audioSource && audioSource->isInitialized()) continue;
 
-    // find highest sample in the batch
-    float maxSample = 0.0f;                         // max sample from FFT batch
-    for (int i=0; i < samplesFFT; i++) {
+    #if !defined(I2S_GRAB_ADC1_COMPLETELY)    
+    if ((audioSource == nullptr) || (audioSource->getType() != AudioSource::Type_I2SAdc))  // the "delay trick" does not help for analog ADC
+    #endif
+      vTaskDelayUntil( &xLastWakeTime, xFrequency);        // release CPU, and let I2S fill its buffers
+
+  } // for(;;)ever
+} // FFTcode() task end
+
+// processing chain for one window of (filtered) samples in vReal[]: FFT, mapping to GEQ channels, post-processing, peak detection
+// does not depend on where the samples came from, so any AudioSource (including WAV file replay) can feed it
+static void processSamples(void)
+{
+#if SR_FFT_BACKEND == SR_FFT_ARDUINOFFT
+  memset(vImag, 0, samplesFFT * sizeof(float));   // set imaginary parts to 0
+#endif
+
+#if defined(WLED_DEBUG) || defined(SR_DEBUG)
+  uint64_t start = esp_timer_get_time(); // start measuring FFT time
+  bool haveDoneFFT = false; // indicates if FFT time measurement is valid
+#endif
+
+  // find highest sample in the batch
+  float maxSample = 0.0f;                         // max sample from FFT batch
+  for (int i=0; i < samplesFFT; i++) {
 	    // pick our  our current mic sample - we take the max value from all samples that go into FFT
 	    if ((vReal[i] <= (INT16_MAX - 1024)) && (vReal[i] >= (INT16_MIN + 1024)))  //skip extreme values - normally these are artefacts
-        if (fabsf((float)vReal[i]) > maxSample) maxSample = fabsf((float)vReal[i]);
-    }
-    // release highest sample to volume reactive effects early - not strictly necessary here - could also be done at the end of the function
-    // early release allows the filters (getSample() and agcAvg()) to work with fresh values - we will have matching gain and noise gate values when we want to process the FFT results.
-    micDataReal = maxSample;
+      if (fabsf((float)vReal[i]) > maxSample) maxSample = fabsf((float)vReal[i]);
+  }
+  // release highest sample to volume reactive effects early - not strictly necessary here - could also be done at the end of the function
+  // early release allows the filters (getSample() and agcAvg()) to work with fresh values - we will have matching gain and noise gate values when we want to process the FFT results.
+  micDataReal = maxSample;
 
 #ifdef SR_DEBUG
-    if (true) {  // this allows measure FFT runtimes, as it disables the "only when needed" optimization 
+  if (true) {  // this allows measure FFT runtimes, as it disables the "only when needed" optimization 
 #else
-    if (sampleAvg > 0.25f) { // noise gate open means that FFT results will be used. Don't run FFT if results are not needed.
+  if (sampleAvg > 0.25f) { // noise gate open means that FFT results will be used. Don't run FFT if results are not needed.
 #endif
 
-      // run FFT (takes 3-5ms on ESP32, ~12ms on ESP32-S2)
-      FFT.dcRemoval();                                            // remove DC offset
-      FFT.windowing( FFTWindow::Flat_top, FFTDirection::Forward); // Weigh data using "Flat Top" function - better amplitude accuracy
-      //FFT.windowing(FFTWindow::Blackman_Harris, FFTDirection::Forward);  // Weigh data using "Blackman- Harris" window - sharp peaks due to excellent sideband rejection
-      FFT.compute( FFTDirection::Forward );                       // Compute FFT
-      FFT.complexToMagnitude();                                   // Compute magnitudes
-      vReal[0] = 0;   // The remaining DC offset on the signal produces a strong spike on position 0 that should be eliminated to avoid issues.
+#if SR_FFT_BACKEND == SR_FFT_ARDUINOFFT
+    // run FFT (takes 3-5ms on ESP32, ~12ms on ESP32-S2)
+    FFT->dcRemoval();                                            // remove DC offset
+    FFT->windowing( FFTWindow::Flat_top, FFTDirection::Forward); // Weigh data using "Flat Top" function - better amplitude accuracy
+    //FFT->windowing(FFTWindow::Blackman_Harris, FFTDirection::Forward);  // Weigh data using "Blackman- Harris" window - sharp peaks due to excellent sideband rejection
+    FFT->compute( FFTDirection::Forward );                       // Compute FFT
+    FFT->complexToMagnitude();                                   // Compute magnitudes
+    vReal[0] = 0;   // The remaining DC offset on the signal produces a strong spike on position 0 that should be eliminated to avoid issues.
 
-      FFT.majorPeak(&FFT_MajorPeak, &FFT_Magnitude);                // let the effects know which freq was most dominant
-      FFT_MajorPeak = constrain(FFT_MajorPeak, 1.0f, 11025.0f);   // restrict value to range expected by effects
+    FFT->majorPeak(&audioWork.majorPeak, &audioWork.magnitude);    // let the effects know which freq was most dominant
+#else
+    // run real-input FFT: DC removal, "Flat Top" window, half size complex FFT, magnitudes
+    fftComputeMagnitudes(vReal, vImag, samplesFFT);
+    vReal[0] = 0;   // The remaining DC offset on the signal produces a strong spike on position 0 that should be eliminated to avoid issues.
+
+    fftMajorPeak(vReal, samplesFFT, SAMPLE_RATE, &audioWork.majorPeak, &audioWork.magnitude); // let the effects know which freq was most dominant
+#endif
+    audioWork.majorPeak = constrain(audioWork.majorPeak, 1.0f, 11025.0f);   // restrict value to range expected by effects
+    audioWork.magnitude *= float(FFT_MIN_SIZE) / float(samplesFFT);         // magnitudes grow with FFT size - keep the scale of 512 samples
 
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)
-      haveDoneFFT = true;
+    haveDoneFFT = true;
 #endif
 
-    } else { // noise gate closed - only clear results as FFT was skipped. MIC samples are still valid when we do this.
-      memset(vReal, 0, samplesFFT * sizeof(float));
-      FFT_MajorPeak = 1;
-      FFT_Magnitude = 0.001;
-    }
+  } else { // noise gate closed - only clear results as FFT was skipped. MIC samples are still valid when we do this.
+    memset(vReal, 0, samplesFFT * sizeof(float));
+    audioWork.majorPeak = 1;
+    audioWork.magnitude = 0.001;
+  }
 
-    for (int i = 0; i < samplesFFT; i++) {
-      float t = fabsf(vReal[i]);                      // just to be sure - values in fft bins should be positive any way
-      vReal[i] = t / 16.0f;                           // Reduce magnitude. Want end result to be scaled linear and ~4096 max.
-    } // for()
-
-    // mapping of FFT result bins to frequency channels
-    if (fabsf(sampleAvg) > 0.5f) { // noise gate open
-#if 0
-    /* This FFT post processing is a DIY endeavour. What we really need is someone with sound engineering expertise to do a great job here AND most importantly, that the animations look GREAT as a result.
-    *
-    * Andrew's updated mapping of 256 bins down to the 16 result bins with Sample Freq = 10240, samplesFFT = 512 and some overlap.
-    * Based on testing, the lowest/Start frequency is 60 Hz (with bin 3) and a highest/End frequency of 5120 Hz in bin 255.
-    * Now, Take the 60Hz and multiply by 1.320367784 to get the next frequency and so on until the end. Then determine the bins.
-    * End frequency = Start frequency * multiplier ^ 16
-    * Multiplier = (End frequency/ Start frequency) ^ 1/16
-    * Multiplier = 1.320367784
-    */                                    //  Range
-      fftCalc[ 0] = fftAddAvg(2,4);       // 60 - 100
-      fftCalc[ 1] = fftAddAvg(4,5);       // 80 - 120
-      fftCalc[ 2] = fftAddAvg(5,7);       // 100 - 160
-      fftCalc[ 3] = fftAddAvg(7,9);       // 140 - 200
-      fftCalc[ 4] = fftAddAvg(9,12);      // 180 - 260
-      fftCalc[ 5] = fftAddAvg(12,16);     // 240 - 340
-      fftCalc[ 6] = fftAddAvg(16,21);     // 320 - 440
-      fftCalc[ 7] = fftAddAvg(21,29);     // 420 - 600
-      fftCalc[ 8] = fftAddAvg(29,37);     // 580 - 760
-      fftCalc[ 9] = fftAddAvg(37,48);     // 740 - 980
-      fftCalc[10] = fftAddAvg(48,64);     // 960 - 1300
-      fftCalc[11] = fftAddAvg(64,84);     // 1280 - 1700
-      fftCalc[12] = fftAddAvg(84,111);    // 1680 - 2240
-      fftCalc[13] = fftAddAvg(111,147);   // 2220 - 2960
-      fftCalc[14] = fftAddAvg(147,194);   // 2940 - 3900
-      fftCalc[15] = fftAddAvg(194,250);   // 3880 - 5000 // avoid the last 5 bins, which are usually inaccurate
-#else
-      /* new mapping, optimized for 22050 Hz by softhack007 */
-                                                    // bins frequency  range
-      if (useBandPassFilter) {
-        // skip frequencies below 100hz
-        fftCalc[ 0] = 0.8f * fftAddAvg(3,4);
-        fftCalc[ 1] = 0.9f * fftAddAvg(4,5);
-        fftCalc[ 2] = fftAddAvg(5,6);
-        fftCalc[ 3] = fftAddAvg(6,7);
-        // don't use the last bins from 206 to 255. 
-        fftCalc[15] = fftAddAvg(165,205) * 0.75f;   // 40 7106 - 8828 high             -- with some damping
-      } else {
-        fftCalc[ 0] = fftAddAvg(1,2);               // 1    43 - 86   sub-bass
-        fftCalc[ 1] = fftAddAvg(2,3);               // 1    86 - 129  bass
-        fftCalc[ 2] = fftAddAvg(3,5);               // 2   129 - 216  bass
-        fftCalc[ 3] = fftAddAvg(5,7);               // 2   216 - 301  bass + midrange
-        // don't use the last bins from 216 to 255. They are usually contaminated by aliasing (aka noise) 
-        fftCalc[15] = fftAddAvg(165,215) * 0.70f;   // 50 7106 - 9259 high             -- with some damping
-      }
-      fftCalc[ 4] = fftAddAvg(7,10);                // 3   301 - 430  midrange
-      fftCalc[ 5] = fftAddAvg(10,13);               // 3   430 - 560  midrange
-      fftCalc[ 6] = fftAddAvg(13,19);               // 5   560 - 818  midrange
-      fftCalc[ 7] = fftAddAvg(19,26);               // 7   818 - 1120 midrange -- 1Khz should always be the center !
-      fftCalc[ 8] = fftAddAvg(26,33);               // 7  1120 - 1421 midrange
-      fftCalc[ 9] = fftAddAvg(33,44);               // 9  1421 - 1895 midrange
-      fftCalc[10] = fftAddAvg(44,56);               // 12 1895 - 2412 midrange + high mid
-      fftCalc[11] = fftAddAvg(56,70);               // 14 2412 - 3015 high mid
-      fftCalc[12] = fftAddAvg(70,86);               // 16 3015 - 3704 high mid
-      fftCalc[13] = fftAddAvg(86,104);              // 18 3704 - 4479 high mid
-      fftCalc[14] = fftAddAvg(104,165) * 0.88f;     // 61 4479 - 7106 high mid + high  -- with slight damping
-#endif
-    } else {  // noise gate closed - just decay old values
-      for (int i=0; i < NUM_GEQ_CHANNELS; i++) {
-        fftCalc[i] *= 0.85f;  // decay to zero
-        if (fftCalc[i] < 4.0f) fftCalc[i] = 0.0f;
-      }
+  const float fftScale = float(FFT_MIN_SIZE) / float(samplesFFT) / 16.0f;  // same magnitudes for all FFT sizes
+  for (int i = 0; i < samplesFFT; i++) {
+    float t = fabsf(vReal[i]);                      // just to be sure - values in fft bins should be positive any way
+    vReal[i] = t * fftScale;                        // Reduce magnitude. Want end result to be scaled linear and ~4096 max.
+  } // for()
+  STAGE_MARK(STAGE_FFT);
+
+  // mapping of FFT result bins to frequency channels
+  if (geqMapBandPass != int8_t(useBandPassFilter)) buildGEQMaps();
+  if (fabsf(sampleAvg) > 0.5f) { // noise gate open
+    for (int i=0; i < NUM_GEQ_CHANNELS; i++) fftCalc[i] = geqBandValue(geqMap[i]);
+    if (geqBands > NUM_GEQ_CHANNELS)
+      for (int i=0; i < geqBands; i++) fftCalcExt[i] = geqBandValue(geqMapExt[i]);
+  } else {  // noise gate closed - just decay old values
+    for (int i=0; i < NUM_GEQ_CHANNELS; i++) {
+      fftCalc[i] *= 0.85f;  // decay to zero
+      if (fftCalc[i] < 4.0f) fftCalc[i] = 0.0f;
+    }
+    for (int i=0; i < geqBands; i++) {
+      fftCalcExt[i] *= 0.85f;
+      if (fftCalcExt[i] < 4.0f) fftCalcExt[i] = 0.0f;
     }
+  }
+
+  STAGE_MARK(STAGE_GEQ);
+
+  // onset detection and tempo tracking, works on fftCalc[] before post-processing
+  detectOnsetAndTempo();
+  STAGE_MARK(STAGE_ONSET);
 
-    // post-processing of frequency channels (pink noise adjustment, AGC, smoothing, scaling)
-    postProcessFFTResults((fabsf(sampleAvg) > 0.25f)? true : false , NUM_GEQ_CHANNELS);
+  // post-processing of frequency channels (pink noise adjustment, AGC, smoothing, scaling)
+  bool noiseGateOpen = (fabsf(sampleAvg) > 0.25f)? true : false;
+  postProcessFFTResults(noiseGateOpen, NUM_GEQ_CHANNELS, fftCalc, fftAvg, audioWork.fftResult);
+  if (geqBands > NUM_GEQ_CHANNELS) postProcessFFTResults(noiseGateOpen, geqBands, fftCalcExt, fftAvgExt, audioWork.fftResultExt);
+  else memcpy(audioWork.fftResultExt, audioWork.fftResult, NUM_GEQ_CHANNELS);
+  audioWork.numBands = geqBands;
 
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)
-    if (haveDoneFFT && (start < esp_timer_get_time())) { // filter out overflows
-      uint64_t fftTimeInMillis = ((esp_timer_get_time() - start) +5ULL) / 10ULL; // "+5" to ensure proper rounding
-      fftTime  = (fftTimeInMillis*3 + fftTime*7)/10; // smooth
-    }
+  if (haveDoneFFT && (start < esp_timer_get_time())) { // filter out overflows
+    uint64_t fftTimeInMillis = ((esp_timer_get_time() - start) +5ULL) / 10ULL; // "+5" to ensure proper rounding
+    fftTime  = (fftTimeInMillis*3 + fftTime*7)/10; // smooth
+  }
 #endif
-    // run peak detection
-    autoResetPeak();
-    detectSamplePeak();
-    
-    #if !defined(I2S_GRAB_ADC1_COMPLETELY)    
-    if ((audioSource == nullptr) || (audioSource->getType() != AudioSource::Type_I2SAdc))  // the "delay trick" does not help for analog ADC
-    #endif
-      vTaskDelayUntil( &xLastWakeTime, xFrequency);        // release CPU, and let I2S fill its buffers
+  // run peak detection
+  detectSamplePeak();
+  STAGE_MARK(STAGE_POST);
+}
 
-  } // for(;;)ever
-} // FFTcode() task end
+#if defined(SR_WAV_REPLAY) && defined(SR_REPLAY_DUMP)
+// {"blk":<n>,"vol":<max sample>,"agc":<sampleAgc>,"pk":<new peaks>,"fft":[16 channels],"us":[samples,fft,geq,onset,post]}
+static void dumpReplayBlock(void) {
+  static uint32_t lastPeaks = 0;
+  DEBUGOUT.printf("{\"blk\":%u,\"vol\":%.1f,\"agc\":%.1f,\"pk\":%u,\"fft\":[", (unsigned)audioWork.sequence, micDataReal, sampleAgc, (unsigned)(audioWork.peaks - lastPeaks));
+  for (int i = 0; i < NUM_GEQ_CHANNELS; i++) DEBUGOUT.printf(i ? ",%u" : "%u", audioWork.fftResult[i]);
+  DEBUGOUT.print("],\"us\":[");
+  for (int i = STAGE_SAMPLES; i < STAGE_COUNT; i++) DEBUGOUT.printf(i > STAGE_SAMPLES ? ",%u" : "%u", (unsigned)(stageTime[i] - stageTime[i-1]));
+  DEBUGOUT.println("]}");
+  lastPeaks = audioWork.peaks;
+}
+#endif
 
 
 ///////////////////////////
@@ -434,37 +635,39 @@ static void runMicFilter(uint16_t numSamples, float *sampleBuffer)          // p
   }
 }
 
-static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels) // post-processing and post-amp of GEQ channels
+// post-processing and post-amp of GEQ channels - works for the standard channels and for the extended bands
+static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels, float *calc, float *avg, uint8_t *result)
 {
     for (int i=0; i < numberOfChannels; i++) {
+      float position = float(i * NUM_GEQ_CHANNELS) / float(numberOfChannels);  // equivalent standard channel, for frequency dependent adjustments
 
       if (noiseGateOpen) { // noise gate open
         // Adjustment for frequency curves.
-        fftCalc[i] *= fftResultPink[i];
-        if (FFTScalingMode > 0) fftCalc[i] *= FFT_DOWNSCALE;  // adjustment related to FFT windowing function
+        calc[i] *= fftResultPink[int(position)];
+        if (FFTScalingMode > 0) calc[i] *= FFT_DOWNSCALE;  // adjustment related to FFT windowing function
         // Manual linear adjustment of gain using sampleGain adjustment for different input types.
-        fftCalc[i] *= soundAgc ? multAgc : ((float)sampleGain/40.0f * (float)inputLevel/128.0f + 1.0f/16.0f); //apply gain, with inputLevel adjustment
-        if(fftCalc[i] < 0) fftCalc[i] = 0;
+        calc[i] *= soundAgc ? multAgc : ((float)sampleGain/40.0f * (float)inputLevel/128.0f + 1.0f/16.0f); //apply gain, with inputLevel adjustment
+        if(calc[i] < 0) calc[i] = 0;
       }
 
       // smooth results - rise fast, fall slower
-      if(fftCalc[i] > fftAvg[i])   // rise fast 
-        fftAvg[i] = fftCalc[i] *0.75f + 0.25f*fftAvg[i];  // will need approx 2 cycles (50ms) for converging against fftCalc[i]
+      if(calc[i] > avg[i])   // rise fast 
+        avg[i] = calc[i] *0.75f + 0.25f*avg[i];  // will need approx 2 cycles (50ms) for converging against calc[i]
       else {                       // fall slow
-        if (decayTime < 1000) fftAvg[i] = fftCalc[i]*0.22f + 0.78f*fftAvg[i];       // approx  5 cycles (225ms) for falling to zero
-        else if (decayTime < 2000) fftAvg[i] = fftCalc[i]*0.17f + 0.83f*fftAvg[i];  // default - approx  9 cycles (225ms) for falling to zero
-        else if (decayTime < 3000) fftAvg[i] = fftCalc[i]*0.14f + 0.86f*fftAvg[i];  // approx 14 cycles (350ms) for falling to zero
-        else fftAvg[i] = fftCalc[i]*0.1f  + 0.9f*fftAvg[i];                         // approx 20 cycles (500ms) for falling to zero
+        if (decayTime < 1000) avg[i] = calc[i]*0.22f + 0.78f*avg[i];       // approx  5 cycles (225ms) for falling to zero
+        else if (decayTime < 2000) avg[i] = calc[i]*0.17f + 0.83f*avg[i];  // default - approx  9 cycles (225ms) for falling to zero
+        else if (decayTime < 3000) avg[i] = calc[i]*0.14f + 0.86f*avg[i];  // approx 14 cycles (350ms) for falling to zero
+        else avg[i] = calc[i]*0.1f  + 0.9f*avg[i];                         // approx 20 cycles (500ms) for falling to zero
       }
       // constrain internal vars - just to be sure
-      fftCalc[i] = constrain(fftCalc[i], 0.0f, 1023.0f);
-      fftAvg[i] = constrain(fftAvg[i], 0.0f, 1023.0f);
+      calc[i] = constrain(calc[i], 0.0f, 1023.0f);
+      avg[i] = constrain(avg[i], 0.0f, 1023.0f);
 
       float currentResult;
       if(limiterOn == true)
-        currentResult = fftAvg[i];
+        currentResult = avg[i];
       else
-        currentResult = fftCalc[i];
+        currentResult = calc[i];
 
       switch (FFTScalingMode) {
         case 1:
@@ -473,7 +676,7 @@ static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels) // p
             currentResult -= 8.0f;                       // this skips the lowest row, giving some room for peaks
             if (currentResult > 1.0f) currentResult = logf(currentResult); // log to base "e", which is the fastest log() function
             else currentResult = 0.0f;                   // special handling, because log(1) = 0; log(0) = undefined
-            currentResult *= 0.85f + (float(i)/18.0f);  // extra up-scaling for high frequencies
+            currentResult *= 0.85f + (position/18.0f);  // extra up-scaling for high frequencies
             currentResult = mapf(currentResult, 0, LOG_256, 0, 255); // map [log(1) ... log(255)] to [0 ... 255]
         break;
         case 2:
@@ -481,7 +684,7 @@ static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels) // p
             currentResult *= 0.30f;                     // needs a bit more damping, get stay below 255
             currentResult -= 4.0f;                       // giving a bit more room for peaks
             if (currentResult < 1.0f) currentResult = 0.0f;
-            currentResult *= 0.85f + (float(i)/1.8f);   // extra up-scaling for high frequencies
+            currentResult *= 0.85f + (position/1.8f);   // extra up-scaling for high frequencies
         break;
         case 3:
             // square root scaling
@@ -489,7 +692,7 @@ static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels) // p
             currentResult -= 6.0f;
             if (currentResult > 1.0f) currentResult = sqrtf(currentResult);
             else currentResult = 0.0f;                   // special handling, because sqrt(0) = undefined
-            currentResult *= 0.85f + (float(i)/4.5f);   // extra up-scaling for high frequencies
+            currentResult *= 0.85f + (position/4.5f);   // extra up-scaling for high frequencies
             currentResult = mapf(currentResult, 0.0, 16.0, 0.0, 255.0); // map [sqrt(1) ... sqrt(256)] to [0 ... 255]
         break;
 
@@ -506,7 +709,7 @@ static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels) // p
         if (post_gain < 1.0f) post_gain = ((post_gain -1.0f) * 0.8f) +1.0f;
         currentResult *= post_gain;
       }
-      fftResult[i] = constrain((int)currentResult, 0, 255);
+      result[i] = constrain((int)currentResult, 0, 255);
     }
 }
 ////////////////////
@@ -515,20 +718,176 @@ static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels) // p
 
 // peak detection is called from FFT task when vReal[] contains valid FFT results
 static void detectSamplePeak(void) {
+  static unsigned long lastPeak = 0;
   bool havePeak = false;
   // softhack007: this code continuously triggers while amplitude in the selected bin is above a certain threshold. So it does not detect peaks - it detects high activity in a frequency bin.
   // Poor man's beat detection by seeing if sample > Average + some value.
   // This goes through ALL of the 255 bins - but ignores stupid settings
   // Then we got a peak, else we don't. The peak has to time out on its own in order to support UDP sound sync.
-  if ((sampleAvg > 1) && (maxVol > 0) && (binNum > 4) && (vReal[binNum] > maxVol) && ((millis() - timeOfPeak) > 100)) {
+  // binNum refers to a 512 point FFT - use the bin with the same frequency
+  if ((sampleAvg > 1) && (maxVol > 0) && (binNum > 4) && (vReal[binNum * samplesFFT / FFT_MIN_SIZE] > maxVol) && ((millis() - lastPeak) > 100)) {
     havePeak = true;
   }
 
   if (havePeak) {
-    samplePeak    = true;
-    timeOfPeak    = millis();
-    udpSamplePeak = true;
+    lastPeak = millis();
+    audioWork.peaks++;   // samplePeak is set by loop() when the result is taken over
+  }
+}
+
+// seqlock writer - called by FFT task after each processed batch
+static void publishAudioResult(void) {
+  audioWork.sequence++;
+  audioSeqLock = audioSeqLock + 1;   // odd: update in progress
+  __sync_synchronize();
+  memcpy(&audioShared, &audioWork, sizeof(audioShared));
+  __sync_synchronize();
+  audioSeqLock = audioSeqLock + 1;   // even: consistent
+}
+
+// seqlock reader - returns false if no consistent copy could be taken (FFT task kept writing)
+static bool readAudioResult(audioResult_t &r) {
+  for (int retry = 0; retry < 4; retry++) {
+    uint32_t seq = audioSeqLock;
+    if (seq & 1) { yield(); continue; }
+    __sync_synchronize();
+    memcpy(&r, &audioShared, sizeof(r));
+    __sync_synchronize();
+    if (seq == audioSeqLock) return true;
+  }
+  return false;
+}
+
+////////////////////////////
+// Onset / tempo tracking //
+////////////////////////////
+
+// onset strength (spectral flux) history, one value per FFT cycle
+#define ODF_HISTORY 512                                                 // must be a power of 2; enough for ~6 seconds at the highest FFT rate
+#define ODF_MIN_SECONDS 4.5f                                            // min. length of analysed onset history (256 values = ~6 seconds at 43 cycles per second)
+#define BPM_MIN  60
+#define BPM_MAX 200
+constexpr float odfRateMax = float(SAMPLE_RATE) / float(FFT_MIN_SIZE / 2);  // FFT cycles per second with 512 samples and 50% overlap (~86)
+constexpr int   maxLagMax  = int(odfRateMax * 60.0f / BPM_MIN) + 1;         // longest beat period in cycles, at highest FFT rate
+static float    odfRate = float(SAMPLE_RATE) / float(FFT_MIN_SIZE);    // FFT cycles per second (~43 without overlap)
+static int      minLag  = int(odfRate * 60.0f / BPM_MAX);               // shortest beat period in cycles
+static int      maxLag  = int(odfRate * 60.0f / BPM_MIN) + 1;           // longest beat period in cycles
+static unsigned odfLength = 256;                                        // number of analysed values (power of 2, at least ODF_MIN_SECONDS)
+static bool     odfRestart = false;                                     // FFT rate changed - restart tracking
+static float odfHistory[ODF_HISTORY] = {0.0f};
+static unsigned odfPos = 0;                                             // next write position in odfHistory[]
+
+static inline float odfAt(unsigned n) { return odfHistory[(odfPos - odfLength + n) & (ODF_HISTORY - 1)]; } // n = 0: oldest value
+
+// set number of onset values per second (= FFT runs per second) - called by setupFFT()
+static void setTempoRate(float rate) {
+  odfRate = rate;
+  minLag  = int(odfRate * 60.0f / BPM_MAX);
+  maxLag  = int(odfRate * 60.0f / BPM_MIN) + 1;
+  odfLength = 64;
+  while ((odfLength < ODF_HISTORY) && (odfLength < odfRate * ODF_MIN_SECONDS)) odfLength <<= 1;
+  memset(odfHistory, 0, sizeof(odfHistory));
+  odfRestart = true;
+}
+
+// tempo estimation: autocorrelation of onset strength with comb (2x period) and a perceptual prior around 120 BPM
+// returns beat period in cycles (0 if unknown) and updates confidence (0 ... 1)
+static float estimateBeatPeriod(float &confidence) {
+  static float acf[2 * maxLagMax + 3];   // static - FFT task stack is small
+  float energy = 0.0f;
+  for (unsigned n = 0; n < odfLength; n++) energy += odfAt(n) * odfAt(n);
+  confidence = 0.0f;
+  if (energy < 1e-6f) return 0.0f;
+  for (int lag = minLag - 1; lag <= 2 * maxLag + 2; lag++) {
+    float sum = 0.0f;
+    for (unsigned n = lag; n < odfLength; n++) sum += odfAt(n) * odfAt(n - lag);
+    acf[lag] = sum;
+  }
+  const float lag120 = odfRate * 0.5f;  // period at 120 BPM
+  static float score[maxLagMax + 2];
+  int best = 0;
+  for (int lag = minLag - 1; lag <= maxLag + 1; lag++) {
+    float octaves = log2f(float(lag) / lag120);
+    score[lag] = (acf[lag] + 0.5f * acf[2 * lag]) * expf(-0.5f * octaves * octaves);
+    if ((lag >= minLag) && (lag <= maxLag) && ((best == 0) || (score[lag] > score[best]))) best = lag;
+  }
+  // parabolic interpolation for sub-cycle resolution
+  float period = best;
+  float curve = score[best-1] - 2.0f * score[best] + score[best+1];
+  if (curve < 0.0f) period += constrain(0.5f * (score[best-1] - score[best+1]) / curve, -0.5f, 0.5f);
+  confidence = constrain(acf[best] / energy, 0.0f, 1.0f);
+  return period;
+}
+
+// find how many cycles ago the last beat happened, by summing onset strength along a comb with given period
+static float estimateBeatOffset(float period) {
+  int p = lroundf(period);
+  float bestSum = -1.0f;
+  int bestOffset = 0;
+  for (int offset = 0; offset < p; offset++) {
+    float sum = 0.0f;
+    for (int k = 0; k < 8; k++) {
+      int n = odfLength - 1 - offset - lroundf(k * period);
+      if (n < 0) break;
+      sum += odfAt(n);
+    }
+    if (sum > bestSum) { bestSum = sum; bestOffset = offset; }
+  }
+  return bestOffset;
+}
+
+// onset detection and tempo tracking - called by FFT task once per cycle, after fftCalc[] was filled
+static void detectOnsetAndTempo(void) {
+  static float lastBands[NUM_GEQ_CHANNELS] = {0.0f};
+  static float fluxAvg = 0.0f;
+  static float period = 0.0f;           // beat period in cycles, 0 = unknown
+  static float phase = 0.0f;            // 0 ... 1, 0 = on the beat
+  static float confidence = 0.0f;
+  static unsigned cycles = 0;
+
+  if (odfRestart) {   // FFT rate changed - beat period in cycles is no longer valid
+    memset(lastBands, 0, sizeof(lastBands));
+    fluxAvg = period = phase = confidence = 0.0f;
+    odfRestart = false;
+  }
+
+  // spectral flux: sum of increases of log band energy
+  float flux = 0.0f;
+  for (int i = 0; i < NUM_GEQ_CHANNELS; i++) {
+    float band = logf(1.0f + fftCalc[i]);
+    if (band > lastBands[i]) flux += band - lastBands[i];
+    lastBands[i] = band;
+  }
+  // adaptive threshold: only the part above the recent average counts as onset strength
+  fluxAvg += 0.1f * (flux - fluxAvg);
+  odfHistory[odfPos] = fmaxf(flux - fluxAvg, 0.0f);
+  odfPos = (odfPos + 1) & (ODF_HISTORY - 1);
+
+  if (period > 0.0f) {
+    phase += 1.0f / period;
+    if (phase >= 1.0f) phase -= floorf(phase);
+  }
+
+  if ((++cycles & 7) == 0) {  // re-estimate every 8 cycles (~190ms without overlap), keeps the average cost per cycle low
+    float newConfidence;
+    float newPeriod = estimateBeatPeriod(newConfidence);
+    confidence = 0.7f * confidence + 0.3f * newConfidence;
+    if (newPeriod <= 0.0f) period = 0.0f;
+    else if ((period <= 0.0f) || (fabsf(newPeriod - period) > 0.1f * period)) period = newPeriod; // tempo change
+    else period += 0.25f * (newPeriod - period);
+    if (period > 0.0f) {
+      // pull phase towards the measured beat position
+      float error = estimateBeatOffset(period) / period - phase;
+      error -= roundf(error);   // shortest way round
+      phase += 0.5f * error;
+      if (phase < 0.0f) phase += 1.0f;
+      if (phase >= 1.0f) phase -= 1.0f;
+    }
   }
+
+  audioWork.bpm            = (period > 0.0f) ? 60.0f * odfRate / period : 0.0f;
+  audioWork.beatPhase      = phase;
+  audioWork.beatConfidence = confidence;
 }
 
 #endif
@@ -612,7 +971,25 @@ class AudioReactive : public Usermod {
       double FFT_MajorPeak;   //  08 Bytes
     };
 
+    // "V3" audiosync struct - 36 Bytes + one byte per GEQ channel; sent once per FFT result
+    #define UDPSOUND_V3_MAX_BANDS 32
+    struct __attribute__ ((packed)) audioSyncPacket_v3 {
+      char     header[6];     //  06 Bytes  offset 0
+      uint8_t  numBands;      //  01 Bytes  offset 6  - number of entries in fftResult[]
+      uint8_t  flags;         //  01 Bytes  offset 7  - bit 0: samplePeak, bit 1: capture time is NTP synced
+      uint32_t sequence;      //  04 Bytes  offset 8  - incremented per FFT result, receivers use it to detect loss
+      uint32_t captureSec;    //  04 Bytes  offset 12 - toki time when samples were captured
+      uint16_t captureMs;     //  02 Bytes  offset 16
+      uint16_t reserved;      //  02 Bytes  offset 18
+      float    sampleRaw;     //  04 Bytes  offset 20
+      float    sampleSmth;    //  04 Bytes  offset 24
+      float    FFT_Magnitude; //  04 Bytes  offset 28
+      float    FFT_MajorPeak; //  04 Bytes  offset 32
+      uint8_t  fftResult[UDPSOUND_V3_MAX_BANDS]; // offset 36 - only numBands entries are transmitted
+    };
+
     #define UDPSOUND_MAX_PACKET 88 // max packet size for audiosync
+    #define UDPSOUND_JITTER_FRAMES 8  // v3 receive buffer size (frames)
 
     // set your config variables to their boot default value (this can also be done in readFromConfig() or a constructor if you prefer)
     #ifdef UM_AUDIOREACTIVE_ENABLE
@@ -630,6 +1007,31 @@ class AudioReactive : public Usermod {
     unsigned long lastTime = 0;   // last time of running UDP Microphone Sync
     const uint16_t delayMs = 10;  // I don't want to sample too often and overload WLED
     uint16_t audioSyncPort= 11988;// default port for UDP sound sync
+    bool     audioSyncV2 = true;  // send mode: also send v2 packets for older receivers (config value)
+    uint16_t audioSyncDelay = 40; // receive mode: v3 frames are applied at capture time + audioSyncDelay ms (config value)
+
+    // v3 receive jitter buffer - frames are kept until they are due
+    struct audioSyncFrame {
+      unsigned long due;          // millis() when frame gets applied
+      float    sampleRaw;
+      float    sampleSmth;
+      float    FFT_Magnitude;
+      float    FFT_MajorPeak;
+      uint8_t  fftResult[NUM_GEQ_CHANNELS];
+      bool     samplePeak;
+    };
+    audioSyncFrame syncFrames[UDPSOUND_JITTER_FRAMES];
+    uint8_t  syncFrameHead = 0;   // oldest queued frame
+    uint8_t  syncFrameCount = 0;
+    bool     haveClockOffset = false;
+    uint32_t clockOffset = 0;     // smallest (arrival - capture time) seen, maps sender capture time to local millis()
+    uint32_t windowOffset = 0;    // smallest offset in current window, replaces clockOffset after 128 frames to follow clock drift
+    uint8_t  windowFrames = 0;
+    uint32_t lastSyncSequence = 0;
+    uint32_t syncReceived = 0;    // v3 statistics for info page
+    uint32_t syncLost = 0;
+    uint32_t syncLate = 0;        // frames that arrived after they were due
+    int16_t  syncLatency = -1;    // smoothed capture to arrival time (ms), -1 if clocks are not NTP synced
 
     bool updateIsRunning = false; // true during OTA.
 
@@ -656,7 +1058,7 @@ class AudioReactive : public Usermod {
 
     // used to feed "Info" Page
     unsigned long last_UDPTime = 0;    // time of last valid UDP sound sync datapacket
-    int receivedFormat = 0;            // last received UDP sound sync format - 0=none, 1=v1 (0.13.x), 2=v2 (0.14.x)
+    int receivedFormat = 0;            // last received UDP sound sync format - 0=none, 1=v1 (0.13.x), 2=v2 (0.14.x), 3=v3
     float maxSample5sec = 0.0f;        // max sample (after AGC) in last 5 seconds 
     unsigned long sampleMaxTimer = 0;  // last time maxSample5sec was reset
     #define CYCLE_SAMPLEMAX 3500       // time window for merasuring
@@ -675,6 +1077,7 @@ class AudioReactive : public Usermod {
     static const char _addPalettes[];
     static const char UDP_SYNC_HEADER[];
     static const char UDP_SYNC_HEADER_v1[];
+    static const char UDP_SYNC_HEADER_v3[];
 
     // private methods
     void removeAudioPalettes(void);
@@ -1014,6 +1417,33 @@ class AudioReactive : public Usermod {
       return;
     } // transmitAudioData()
 
+    void transmitAudioData_v3()
+    {
+      if (!udpSyncConnected) return;
+
+      audioSyncPacket_v3 transmitData;
+      memset(reinterpret_cast<void *>(&transmitData), 0, sizeof(transmitData));
+
+      strncpy_P(transmitData.header, PSTR(UDP_SYNC_HEADER_v3), 6);
+      transmitData.numBands = NUM_GEQ_CHANNELS;
+      transmitData.flags    = (resultHasPeak ? 0x01 : 0) | ((toki.getTimeSource() >= TOKI_TS_UDP_NTP) ? 0x02 : 0);
+      transmitData.sequence = audioSequence;
+      Toki::Time capture = toki.getTime();
+      toki.adjust(capture, -int32_t(millis() - audioTimestamp));  // go back to the time when samples were captured
+      transmitData.captureSec = capture.sec;
+      transmitData.captureMs  = capture.ms;
+      transmitData.sampleRaw  = (soundAgc) ? rawSampleAgc: sampleRaw;
+      transmitData.sampleSmth = (soundAgc) ? sampleAgc   : sampleAvg;
+      transmitData.FFT_Magnitude = my_magnitude;
+      transmitData.FFT_MajorPeak = FFT_MajorPeak;
+      for (int i = 0; i < NUM_GEQ_CHANNELS; i++) transmitData.fftResult[i] = fftResult[i];
+
+      if (fftUdp.beginMulticastPacket() != 0) { // beginMulticastPacket returns 0 in case of error
+        fftUdp.write(reinterpret_cast<uint8_t *>(&transmitData), offsetof(audioSyncPacket_v3, fftResult) + NUM_GEQ_CHANNELS);
+        fftUdp.endPacket();
+      }
+    } // transmitAudioData_v3()
+
 #endif
 
     static bool isValidUdpSyncVersion(const char *header) {
@@ -1022,6 +1452,9 @@ class AudioReactive : public Usermod {
     static bool isValidUdpSyncVersion_v1(const char *header) {
       return strncmp_P(header, UDP_SYNC_HEADER_v1, 6) == 0;
     }
+    static bool isValidUdpSyncVersion_v3(const char *header) {
+      return strncmp_P(header, UDP_SYNC_HEADER_v3, 6) == 0;
+    }
 
     void decodeAudioData(int packetSize, uint8_t *fftBuff) {
       audioSyncPacket receivedPacket;
@@ -1049,9 +1482,12 @@ class AudioReactive : public Usermod {
       }
       //These values are only computed by ESP32
       for (int i = 0; i < NUM_GEQ_CHANNELS; i++) fftResult[i] = receivedPacket.fftResult[i];
+      memcpy(fftResultExt, fftResult, sizeof(fftResult)); numGEQBands = NUM_GEQ_CHANNELS;  // no extended bands in sync packets
       my_magnitude  = fmaxf(receivedPacket.FFT_Magnitude, 0.0f);
       FFT_Magnitude = my_magnitude;
       FFT_MajorPeak = constrain(receivedPacket.FFT_MajorPeak, 1.0f, 11025.0f);  // restrict value to range expected by effects
+      audioSequence++;
+      audioTimestamp = millis();
     }
 
     void decodeAudioData_v1(int packetSize, uint8_t *fftBuff) {
@@ -1077,9 +1513,108 @@ class AudioReactive : public Usermod {
       }
       //These values are only available on the ESP32
       for (int i = 0; i < NUM_GEQ_CHANNELS; i++) fftResult[i] = receivedPacket->fftResult[i];
+      memcpy(fftResultExt, fftResult, sizeof(fftResult)); numGEQBands = NUM_GEQ_CHANNELS;  // no extended bands in sync packets
       my_magnitude  = fmaxf(receivedPacket->FFT_Magnitude, 0.0);
       FFT_Magnitude = my_magnitude;
       FFT_MajorPeak = constrain(receivedPacket->FFT_MajorPeak, 1.0, 11025.0);  // restrict value to range expected by effects
+      audioSequence++;
+      audioTimestamp = millis();
+    }
+
+    // v3: put received frame into jitter buffer, due at its capture time + audioSyncDelay
+    void queueAudioData_v3(int packetSize, uint8_t *fftBuff) {
+      audioSyncPacket_v3 receivedPacket;
+      memset(&receivedPacket, 0, sizeof(receivedPacket));
+      memcpy(&receivedPacket, fftBuff, min((unsigned)packetSize, (unsigned)sizeof(receivedPacket)));
+      unsigned long now = millis();
+
+      // loss detection; large jumps mean the sender was restarted
+      int32_t seqDiff = int32_t(receivedPacket.sequence - lastSyncSequence);
+      if (syncReceived > 0 && seqDiff <= 0 && seqDiff > -100) return;   // duplicate or reordered - already too late
+      if (syncReceived > 0 && seqDiff > 1 && seqDiff < 100) syncLost += seqDiff - 1;
+      lastSyncSequence = receivedPacket.sequence;
+      syncReceived++;
+
+      // sender clock -> local clock: the fastest frame defines the offset, everything slower is absorbed by the delay
+      uint32_t captureTime = receivedPacket.captureSec * 1000UL + receivedPacket.captureMs;
+      uint32_t offset = now - captureTime;
+      if (!haveClockOffset || abs(int32_t(offset - clockOffset)) > 1000) { // first frame or sender time was adjusted
+        clockOffset = windowOffset = offset;
+        windowFrames = 0;
+        haveClockOffset = true;
+      }
+      if (int32_t(offset - clockOffset) < 0) clockOffset = offset;
+      if (int32_t(offset - windowOffset) < 0) windowOffset = offset;
+      if (++windowFrames >= 128) {
+        clockOffset = windowOffset;
+        windowOffset = offset;
+        windowFrames = 0;
+      }
+
+      // real latency is only known if both clocks are NTP synced
+      if ((receivedPacket.flags & 0x02) && (toki.getTimeSource() >= TOKI_TS_UDP_NTP)) {
+        Toki::Time capture = { receivedPacket.captureSec, receivedPacket.captureMs };
+        Toki::Time local = toki.getTime();
+        int latency = toki.isLater(capture, local) ? min(toki.msDifference(capture, local), uint32_t(9999)) : 0;
+        syncLatency = (syncLatency < 0) ? latency : (syncLatency * 7 + latency) / 8;
+      } else syncLatency = -1;
+
+      if (syncFrameCount == UDPSOUND_JITTER_FRAMES) { // buffer full - apply oldest frame now
+        applyAudioFrame(syncFrames[syncFrameHead]);
+        syncFrameHead = (syncFrameHead + 1) % UDPSOUND_JITTER_FRAMES;
+        syncFrameCount--;
+      }
+      audioSyncFrame &frame = syncFrames[(syncFrameHead + syncFrameCount) % UDPSOUND_JITTER_FRAMES];
+      syncFrameCount++;
+      frame.due = captureTime + clockOffset + audioSyncDelay;
+      if (int32_t(frame.due - now) < 0) syncLate++;
+      frame.sampleRaw     = fmaxf(receivedPacket.sampleRaw, 0.0f);
+      frame.sampleSmth    = fmaxf(receivedPacket.sampleSmth, 0.0f);
+      frame.FFT_Magnitude = fmaxf(receivedPacket.FFT_Magnitude, 0.0f);
+      frame.FFT_MajorPeak = constrain(receivedPacket.FFT_MajorPeak, 1.0f, 11025.0f);  // restrict value to range expected by effects
+      frame.samplePeak    = receivedPacket.flags & 0x01;
+      unsigned bands = min(unsigned(receivedPacket.numBands), unsigned(UDPSOUND_V3_MAX_BANDS));
+      for (int i = 0; i < NUM_GEQ_CHANNELS; i++) {
+        // map received channels onto our NUM_GEQ_CHANNELS
+        frame.fftResult[i] = bands ? receivedPacket.fftResult[(i * bands) / NUM_GEQ_CHANNELS] : 0;
+      }
+    }
+
+    void applyAudioFrame(const audioSyncFrame &frame) {
+      volumeSmth   = frame.sampleSmth;
+      volumeRaw    = frame.sampleRaw;
+#ifdef ARDUINO_ARCH_ESP32
+      // update internal samples
+      sampleRaw    = volumeRaw;
+      sampleAvg    = volumeSmth;
+      rawSampleAgc = volumeRaw;
+      sampleAgc    = volumeSmth;
+      multAgc      = 1.0f;
+#endif
+      autoResetPeak();
+      if (!samplePeak && frame.samplePeak) {
+        samplePeak = true;
+        timeOfPeak = millis();
+      }
+      memcpy(fftResult, frame.fftResult, sizeof(fftResult));
+      memcpy(fftResultExt, fftResult, sizeof(fftResult)); numGEQBands = NUM_GEQ_CHANNELS;  // v3 packets carry the standard channels only
+      my_magnitude  = frame.FFT_Magnitude;
+      FFT_Magnitude = my_magnitude;
+      FFT_MajorPeak = frame.FFT_MajorPeak;
+      audioSequence++;
+      audioTimestamp = frame.due - audioSyncDelay;
+    }
+
+    // apply queued v3 frames that are due; returns true if new data was applied
+    bool playoutAudioData() {
+      bool applied = false;
+      while (syncFrameCount > 0 && int32_t(millis() - syncFrames[syncFrameHead].due) >= 0) {
+        applyAudioFrame(syncFrames[syncFrameHead]);
+        syncFrameHead = (syncFrameHead + 1) % UDPSOUND_JITTER_FRAMES;
+        syncFrameCount--;
+        applied = true;
+      }
+      return applied;
     }
 
     bool receiveAudioData()   // check & process new data. return TRUE in case that new audio data was received. 
@@ -1098,10 +1633,15 @@ class AudioReactive : public Usermod {
 
         // VERIFY THAT THIS IS A COMPATIBLE PACKET
         if (packetSize == sizeof(audioSyncPacket) && (isValidUdpSyncVersion((const char *)fftBuff))) {
+          if ((receivedFormat == 3) && (millis() - last_UDPTime < 1000)) return false; // sender also transmits v3 - ignore its v2 packets
           decodeAudioData(packetSize, fftBuff);
           //DEBUGSR_PRINTLN("Finished parsing UDP Sync Packet v2");
           haveFreshData = true;
           receivedFormat = 2;
+        } else if (packetSize > offsetof(audioSyncPacket_v3, fftResult) && isValidUdpSyncVersion_v3((const char *)fftBuff)) {
+          queueAudioData_v3(packetSize, fftBuff);  // applied later by playoutAudioData()
+          last_UDPTime = millis();
+          receivedFormat = 3;
         } else {
           if (packetSize == sizeof(audioSyncPacket_v1) && (isValidUdpSyncVersion_v1((const char *)fftBuff))) {
             decodeAudioData_v1(packetSize, fftBuff);
@@ -1134,7 +1674,7 @@ class AudioReactive : public Usermod {
         // usermod exchangeable data
         // we will assign all usermod exportable data here as pointers to original variables or arrays and allocate memory for pointers
         um_data = new um_data_t;
-        um_data->u_size = 8;
+        um_data->u_size = 15;
         um_data->u_type = new um_types_t[um_data->u_size];
         um_data->u_data = new void*[um_data->u_size];
         um_data->u_data[0] = &volumeSmth;      //*used (New)
@@ -1153,6 +1693,20 @@ class AudioReactive : public Usermod {
         um_data->u_type[6] = UMT_BYTE;
         um_data->u_data[7] = &binNum;          // assigned in effect function from UI element!!! (Puddlepeak, Ripplepeak, Waterfall)
         um_data->u_type[7] = UMT_BYTE;
+        um_data->u_data[8] = &audioSequence;   // changes when new audio data is available
+        um_data->u_type[8] = UMT_UINT32;
+        um_data->u_data[9] = &audioTimestamp;  // capture time of audio data (millis)
+        um_data->u_type[9] = UMT_UINT32;
+        um_data->u_data[10] = &beatBPM;        // tempo estimate (0 = unknown)
+        um_data->u_type[10] = UMT_FLOAT;
+        um_data->u_data[11] = &beatPhase;      // 0 ... 1 position within the beat
+        um_data->u_type[11] = UMT_FLOAT;
+        um_data->u_data[12] = &beatConfidence; // 0 ... 1
+        um_data->u_type[12] = UMT_FLOAT;
+        um_data->u_data[13] = fftResultExt;    // extended frequency bands (config "frequency:bands"), same scaling as fftResult
+        um_data->u_type[13] = UMT_BYTE_ARR;
+        um_data->u_data[14] = &numGEQBands;    // number of valid entries in fftResultExt (16, 32 or 64)
+        um_data->u_type[14] = UMT_BYTE;
       }
 
 
@@ -1219,6 +1773,16 @@ class AudioReactive : public Usermod {
           delay(100);
           if (audioSource) audioSource->initialize(i2swsPin, i2ssdPin, i2sckPin, mclkPin);
           break;
+        #ifdef SR_WAV_REPLAY
+        case 7:
+          DEBUGSR_PRINTLN(F("AR: WAV file replay from " SR_WAV_FILE));
+          audioSource = new WavFileSource(SAMPLE_RATE, BLOCK_SIZE);
+          if (audioSource) audioSource->initialize();
+          #ifdef SR_REPLAY_DUMP
+          replayDump = (audioSource != nullptr);
+          #endif
+          break;
+        #endif
 
         #if  !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3) && !defined(CONFIG_IDF_TARGET_ESP32S3)
         // ADC over I2S is only possible on "classic" ESP32
@@ -1372,6 +1936,34 @@ class AudioReactive : public Usermod {
         } while (userloopDelay > 0);
         lastUMRun = t_now;                    // update time keeping
 
+        // take over latest FFT results - effects see the same consistent set until the next one is taken over
+        audioResult_t result;
+        if (readAudioResult(result) && (result.sequence != audioSequence)) {
+          static uint32_t lastPeaks = 0;
+          resultHasPeak = (result.peaks != lastPeaks);
+          memcpy(fftResult, result.fftResult, sizeof(fftResult));
+          memcpy(fftResultExt, result.fftResultExt, result.numBands);
+          numGEQBands    = result.numBands;
+          FFT_MajorPeak  = result.majorPeak;
+          FFT_Magnitude  = result.magnitude;
+          audioSequence  = result.sequence;
+          audioTimestamp = result.timestamp;
+          beatBPM        = result.bpm;
+          beatConfidence = result.beatConfidence;
+          resultBeatPhase = result.beatPhase;
+          if (resultHasPeak) {
+            samplePeak    = true;
+            timeOfPeak    = millis();
+            udpSamplePeak = true;
+            lastPeaks = result.peaks;
+          }
+        }
+        // beat phase estimated at capture time -> extrapolate to now
+        if (beatBPM > 0.0f) {
+          beatPhase = resultBeatPhase + float(millis() - audioTimestamp) * beatBPM / 60000.0f;
+          beatPhase -= floorf(beatPhase);
+        } else beatPhase = 0.0f;
+
         // update samples for effects (raw, smooth) 
         volumeSmth = (soundAgc) ? sampleAgc   : sampleAvg;
         volumeRaw  = (soundAgc) ? rawSampleAgc: sampleRaw;
@@ -1402,6 +1994,7 @@ class AudioReactive : public Usermod {
 #endif
             lastTime = millis();
           }
+          if (playoutAudioData()) have_new_sample = true;     // v3 frames that became due
           if (have_new_sample) syncVolumeSmth = volumeSmth;   // remember received sample
           else volumeSmth = syncVolumeSmth;                   // restore originally received sample for next run of dynamics limiter
           limitSampleDynamics();                              // run dynamics limiter on received volumeSmth, to hide jumps and hickups
@@ -1437,11 +2030,17 @@ class AudioReactive : public Usermod {
 
 #ifdef ARDUINO_ARCH_ESP32
       //UDP Microphone Sync  - transmit mode
-      if ((audioSyncEnabled & 0x01) && (millis() - lastTime > 20)) {
+      if ((audioSyncEnabled & 0x01) && audioSyncV2 && (millis() - lastTime > 20)) {
         // Only run the transmit code IF we're in Transmit mode
         transmitAudioData();
         lastTime = millis();
       }
+      static uint32_t lastSentSequence = 0;
+      if ((audioSyncEnabled & 0x01) && (audioSequence != lastSentSequence)) {
+        transmitAudioData_v3();  // v3: one packet per FFT result
+        lastSentSequence = audioSequence;
+        if (!audioSyncV2) lastTime = millis();
+      }
 #endif
 
       fillAudioPalettes();
@@ -1470,12 +2069,16 @@ class AudioReactive : public Usermod {
       sampleAgc = 0; sampleAvg = 0;
       sampleRaw = 0; rawSampleAgc = 0;
       my_magnitude = 0; FFT_Magnitude = 0; FFT_MajorPeak = 1;
+      beatBPM = 0; beatPhase = 0; beatConfidence = 0;
       multAgc = 1;
       // reset FFT data
       memset(fftCalc, 0, sizeof(fftCalc)); 
       memset(fftAvg, 0, sizeof(fftAvg)); 
       memset(fftResult, 0, sizeof(fftResult)); 
       for(int i=(init?0:1); i<NUM_GEQ_CHANNELS; i+=2) fftResult[i] = 16; // make a tiny pattern
+      memset(fftCalcExt, 0, sizeof(fftCalcExt));
+      memset(fftAvgExt, 0, sizeof(fftAvgExt));
+      memset(fftResultExt, 0, sizeof(fftResultExt));
       inputLevel = 128;                                    // reset level slider to default
       autoResetPeak();
 
@@ -1667,7 +2270,7 @@ class AudioReactive : public Usermod {
         if (audioSyncEnabled) {
           if (audioSyncEnabled & 0x01) {
             infoArr.add(F("send mode"));
-            if ((udpSyncConnected) && (millis() - lastTime < 2500)) infoArr.add(F(" v2"));
+            if ((udpSyncConnected) && (millis() - lastTime < 2500)) infoArr.add(audioSyncV2 ? F(" v2+v3") : F(" v3"));
           } else if (audioSyncEnabled & 0x02) {
               infoArr.add(F("receive mode"));
           }
@@ -1677,6 +2280,17 @@ class AudioReactive : public Usermod {
         if (audioSyncEnabled && udpSyncConnected && (millis() - last_UDPTime < 2500)) {
             if (receivedFormat == 1) infoArr.add(F(" v1"));
             if (receivedFormat == 2) infoArr.add(F(" v2"));
+            if (receivedFormat == 3) {
+              infoArr.add(F(" v3"));
+              infoArr = user.createNestedArray(F("UDP Sound Sync loss"));
+              infoArr.add(syncReceived ? roundf(1000.0f * (syncLost + syncLate) / (syncReceived + syncLost)) / 10.0f : 0.0f);
+              infoArr.add(F(" % (lost or late)"));
+              if (syncLatency >= 0) {
+                infoArr = user.createNestedArray(F("UDP Sound Sync latency"));
+                infoArr.add(syncLatency);
+                infoArr.add(F(" ms"));
+              }
+            }
         }
 
         #if defined(WLED_DEBUG) || defined(SR_DEBUG)
@@ -1685,17 +2299,26 @@ class AudioReactive : public Usermod {
         infoArr.add(float(sampleTime)/100.0f);
         infoArr.add(" ms");
 
+        if (audioSource) {
+          infoArr = user.createNestedArray(F("Input buffered"));
+          infoArr.add(roundf(audioSource->getBufferedTime() * 10.0f) / 10.0f);
+          infoArr.add(" ms");
+          infoArr = user.createNestedArray(F("Input blocks lost"));
+          infoArr.add(audioSource->getDroppedBlocks());
+        }
+
         infoArr = user.createNestedArray(F("FFT time"));
         infoArr.add(float(fftTime)/100.0f);
-        if ((fftTime/100) >= FFT_MIN_CYCLE) // FFT time over budget -> I2S buffer will overflow 
+        if ((fftTime/100) >= fftCycle) // FFT time over budget -> I2S buffer will overflow 
           infoArr.add("<b style=\"color:red;\">! ms</b>");
-        else if ((fftTime/80 + sampleTime/80) >= FFT_MIN_CYCLE) // FFT time >75% of budget -> risk of instability
+        else if ((fftTime/80 + sampleTime/80) >= fftCycle) // FFT time >75% of budget -> risk of instability
           infoArr.add("<b style=\"color:orange;\"> ms!</b>");
         else
           infoArr.add(" ms");
 
         DEBUGSR_PRINTF("AR Sampling time: %5.2f ms\n", float(sampleTime)/100.0f);
         DEBUGSR_PRINTF("AR FFT time     : %5.2f ms\n", float(fftTime)/100.0f);
+        if (audioSource) DEBUGSR_PRINTF("AR Input buffer : %5.2f ms, %u blocks lost\n", audioSource->getBufferedTime(), audioSource->getDroppedBlocks());
         #endif
         #endif
       }
@@ -1814,9 +2437,13 @@ class AudioReactive : public Usermod {
       cfg[F("squelch")] = soundSquelch;
       cfg[F("gain")] = sampleGain;
       cfg[F("AGC")] = soundAgc;
+      cfg[F("continuous")] = continuousRead;
 
       JsonObject freqScale = top.createNestedObject(FPSTR(_frequency));
       freqScale[F("scale")] = FFTScalingMode;
+      freqScale[F("fftsize")] = cfgFFTSize;
+      freqScale[F("overlap")] = cfgFFTOverlap;
+      freqScale[F("bands")] = cfgGEQBands;
 #endif
 
       JsonObject dynLim = top.createNestedObject(FPSTR(_dynamics));
@@ -1827,6 +2454,8 @@ class AudioReactive : public Usermod {
       JsonObject sync = top.createNestedObject("sync");
       sync["port"] = audioSyncPort;
       sync["mode"] = audioSyncEnabled;
+      sync["v2"] = audioSyncV2;
+      sync["delay"] = audioSyncDelay;
     }
 
 
@@ -1878,8 +2507,14 @@ class AudioReactive : public Usermod {
       configComplete &= getJsonValue(top[FPSTR(_config)][F("squelch")], soundSquelch);
       configComplete &= getJsonValue(top[FPSTR(_config)][F("gain")],    sampleGain);
       configComplete &= getJsonValue(top[FPSTR(_config)][F("AGC")],     soundAgc);
+      configComplete &= getJsonValue(top[FPSTR(_config)][F("continuous")], continuousRead);
 
       configComplete &= getJsonValue(top[FPSTR(_frequency)][F("scale")], FFTScalingMode);
+      configComplete &= getJsonValue(top[FPSTR(_frequency)][F("fftsize")], cfgFFTSize);
+      configComplete &= getJsonValue(top[FPSTR(_frequency)][F("overlap")], cfgFFTOverlap);
+      configComplete &= getJsonValue(top[FPSTR(_frequency)][F("bands")], cfgGEQBands);
+      if ((cfgFFTSize != 1024) && (cfgFFTSize != 2048)) cfgFFTSize = FFT_MIN_SIZE;            // power of 2, 512 ... 2048
+      if ((cfgGEQBands != 32) && (cfgGEQBands != MAX_GEQ_BANDS)) cfgGEQBands = NUM_GEQ_CHANNELS; // 16, 32 or 64
 
       configComplete &= getJsonValue(top[FPSTR(_dynamics)][F("limiter")], limiterOn);
       configComplete &= getJsonValue(top[FPSTR(_dynamics)][F("rise")],  attackTime);
@@ -1887,6 +2522,9 @@ class AudioReactive : public Usermod {
 #endif
       configComplete &= getJsonValue(top["sync"]["port"], audioSyncPort);
       configComplete &= getJsonValue(top["sync"]["mode"], audioSyncEnabled);
+      configComplete &= getJsonValue(top["sync"]["v2"], audioSyncV2);
+      configComplete &= getJsonValue(top["sync"]["delay"], audioSyncDelay);
+      audioSyncDelay = min(audioSyncDelay, uint16_t(500));
 
       if (initDone) {
         // add/remove custom/audioreactive palettes
@@ -1914,7 +2552,11 @@ class AudioReactive : public Usermod {
       uiScript.print(F("addOption(dd,'Generic I2S PDM',5);"));
     #endif
     uiScript.print(F("addOption(dd,'ES8388',6);"));
+    #ifdef SR_WAV_REPLAY
+      uiScript.print(F("addOption(dd,'WAV file replay',7);"));
+    #endif
     
+      uiScript.print(F("addInfo(ux+':config:continuous',1,' <i>(lowest latency, FFT task never sleeps)</i>');"));
       uiScript.print(F("dd=addDropdown(ux,'config:AGC');"));
       uiScript.print(F("addOption(dd,'Off',0);"));
       uiScript.print(F("addOption(dd,'Normal',1);"));
@@ -1933,6 +2575,16 @@ class AudioReactive : public Usermod {
       uiScript.print(F("addOption(dd,'Linear (Amplitude)',2);"));
       uiScript.print(F("addOption(dd,'Square Root (Energy)',3);"));
       uiScript.print(F("addOption(dd,'Logarithmic (Loudness)',1);"));
+      uiScript.print(F("dd=addDropdown(ux,'frequency:fftsize');"));
+      uiScript.print(F("addOption(dd,'512 (default)',512);"));
+      uiScript.print(F("addOption(dd,'1024',1024);"));
+      uiScript.print(F("addOption(dd,'2048',2048);"));
+      uiScript.print(F("addInfo(ux+':frequency:fftsize',1,'samples <i>(more = better bass resolution, slower)</i>');"));
+      uiScript.print(F("addInfo(ux+':frequency:overlap',1,' 50% <i>(twice the update rate)</i>');"));
+      uiScript.print(F("dd=addDropdown(ux,'frequency:bands');"));
+      uiScript.print(F("addOption(dd,'16 (default)',16);"));
+      uiScript.print(F("addOption(dd,'32',32);"));
+      uiScript.print(F("addOption(dd,'64',64);"));
 #endif
 
       uiScript.print(F("dd=addDropdown(ux,'sync:mode');"));
@@ -1941,6 +2593,10 @@ class AudioReactive : public Usermod {
       uiScript.print(F("addOption(dd,'Send',1);"));
 #endif
       uiScript.print(F("addOption(dd,'Receive',2);"));
+#ifdef ARDUINO_ARCH_ESP32
+      uiScript.print(F("addInfo(ux+':sync:v2',1,' <i>send v2 packets for older receivers</i>');"));
+#endif
+      uiScript.print(F("addInfo(ux+':sync:delay',1,'ms <i>(v3 receive buffer)</i>');"));
 #ifdef ARDUINO_ARCH_ESP32
       uiScript.print(F("addInfo(ux+':digitalmic:type',1,'<i>requires reboot!</i>');"));  // 0 is field type, 1 is actual field
       uiScript.print(F("addInfo(uxp,0,'<i>sd/data/dout</i>','I2S SD');"));
@@ -1983,6 +2639,7 @@ void AudioReactive::removeAudioPalettes(void) {
     DEBUG_PRINTLN(palettes);
     palettes--;
   }
+  paletteVersion++; // invalidate cached /json/palx pages
   DEBUG_PRINT(F("Total # of palettes: ")); DEBUG_PRINTLN(customPalettes.size());
 }
 
@@ -1996,6 +2653,7 @@ void AudioReactive::createAudioPalettes(void) {
       palettes++;
       DEBUG_PRINTLN(palettes);
     } else break;
+  paletteVersion++; // invalidate cached /json/palx pages
 }
 
 // credit @netmindz ar palette, adapted for usermod @blazoncek
@@ -2076,6 +2734,7 @@ const char AudioReactive::_digitalmic[] PROGMEM = "digitalmic";
 const char AudioReactive::_addPalettes[]       PROGMEM = "add-palettes";
 const char AudioReactive::UDP_SYNC_HEADER[]    PROGMEM = "00002"; // new sync header version, as format no longer compatible with previous structure
 const char AudioReactive::UDP_SYNC_HEADER_v1[] PROGMEM = "00001"; // old sync header version - need to add backwards-compatibility feature
+const char AudioReactive::UDP_SYNC_HEADER_v3[] PROGMEM = "00003"; // v3 adds sequence number and capture timestamp
 
 static AudioReactive ar_module;
 REGISTER_USERMOD(ar_module);
@@ -46,6 +46,11 @@
 //          for example if you want to read "analog buttons"
 //#define I2S_GRAB_ADC1_COMPLETELY // (experimental) continuously sample analog ADC microphone. WARNING will cause analogRead() lock-up
 
+// number of I2S DMA buffers - each buffer holds one block (SR_BLOCK_SIZE samples). More buffers allow longer FFT cycles without losing samples.
+#ifndef SR_DMA_BUFFERS
+#define SR_DMA_BUFFERS 8
+#endif
+
 // data type requested from the I2S driver - currently we always use 32bit
 //#define I2S_USE_16BIT_SAMPLES   // (experimental) define this to request 16bit - more efficient but possibly less compatible
 
@@ -142,6 +147,10 @@ class AudioSource {
     /* identify Audiosource type - I2S-ADC or I2S-digital */
     typedef enum{Type_unknown=0, Type_I2SAdc=1, Type_I2SDigital=2} AudioSourceType;
     virtual AudioSourceType getType(void) {return(Type_I2SDigital);}               // default is "I2S digital source" - ADC type overrides this method
+
+    /* input statistics: blocks lost because DMA buffers were full, and how long samples waited in DMA buffers before they were read */
+    uint32_t getDroppedBlocks(void) {return(_droppedBlocks);}
+    float getBufferedTime(void) {return(_bufferedTime);}                           // milliseconds, smoothed
  
   protected:
     /* Post-process audio sample - currently on needed for I2SAdcSource*/
@@ -159,6 +168,8 @@ class AudioSource {
     int _blockSize;                 // I2S block size
     bool _initialized;              // Gets set to true if initialization is successful
     float _sampleScale;             // pre-scaling factor for I2S samples
+    uint32_t _droppedBlocks = 0;    // number of blocks lost since start
+    float _bufferedTime = 0.0f;     // average time samples waited in DMA buffers (ms)
 };
 
 /* Basic I2S microphone source
@@ -177,14 +188,14 @@ class I2SSource : public AudioSource {
         .communication_format = i2s_comm_format_t(I2S_COMM_FORMAT_STAND_I2S),
         //.intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
         .intr_alloc_flags = ESP_INTR_FLAG_LEVEL2,
-        .dma_buf_count = 8,
+        .dma_buf_count = SR_DMA_BUFFERS,
         .dma_buf_len = _blockSize,
         .use_apll = 0,
         .bits_per_chan = I2S_data_size,
 #else
         .communication_format = i2s_comm_format_t(I2S_COMM_FORMAT_I2S | I2S_COMM_FORMAT_I2S_MSB),
         .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
-        .dma_buf_count = 8,
+        .dma_buf_count = SR_DMA_BUFFERS,
         .dma_buf_len = _blockSize,
         .use_apll = false
 #endif
@@ -302,6 +313,10 @@ class I2SSource : public AudioSource {
 
     virtual void deinitialize() {
       _initialized = false;
+      if (_readBuffer) free(_readBuffer);
+      _readBuffer = nullptr;
+      _readBufferSize = 0;
+      _lastReadEnd = 0;
       esp_err_t err = i2s_driver_uninstall(I2S_NUM_0);
       if (err != ESP_OK) {
         DEBUGSR_PRINTF("Failed to uninstall i2s driver: %d\n", err);
@@ -318,34 +333,56 @@ class I2SSource : public AudioSource {
       if (_initialized) {
         esp_err_t err;
         size_t bytes_read = 0;        /* Counter variable to check if we actually got enough data */
-        I2S_datatype newSamples[num_samples]; /* Intermediary sample storage */
 
-        err = i2s_read(I2S_NUM_0, (void *)newSamples, sizeof(newSamples), &bytes_read, portMAX_DELAY);
+        // intermediary sample storage - allocated once, as large batches don't fit on the FFT task stack
+        if (num_samples > _readBufferSize) {
+          if (_readBuffer) free(_readBuffer);
+          _readBuffer = (I2S_datatype*) malloc(num_samples * sizeof(I2S_datatype));
+          _readBufferSize = _readBuffer ? num_samples : 0;
+          if (_readBuffer == nullptr) {
+            DEBUGSR_PRINTF("Failed to allocate sample buffer: %d samples\n", num_samples);
+            return;
+          }
+        }
+
+        // samples that arrived since the last read are waiting in DMA buffers - if there are more than the buffers can hold, the oldest blocks were lost
+        // (not for analog ADC, which is only enabled while reading)
+        uint64_t readStart = esp_timer_get_time();
+        if ((_lastReadEnd > 0) && (getType() != Type_I2SAdc)) {
+          uint32_t arrived = ((readStart - _lastReadEnd) * _sampleRate) / 1000000ULL;
+          uint32_t capacity = _config.dma_buf_count * _config.dma_buf_len;
+          if (arrived > capacity) {
+            _droppedBlocks += (arrived - capacity) / _blockSize;
+            arrived = capacity;
+          }
+          _bufferedTime = (7.0f * _bufferedTime + 1000.0f * float(arrived) / float(_sampleRate)) / 8.0f;  // smooth
+        }
+
+        err = i2s_read(I2S_NUM_0, (void *)_readBuffer, num_samples * sizeof(I2S_datatype), &bytes_read, portMAX_DELAY);
+        _lastReadEnd = esp_timer_get_time();
         if (err != ESP_OK) {
           DEBUGSR_PRINTF("Failed to get samples: %d\n", err);
           return;
         }
 
-        // For correct operation, we need to read exactly sizeof(samples) bytes from i2s
-        if (bytes_read != sizeof(newSamples)) {
-          DEBUGSR_PRINTF("Failed to get enough samples: wanted: %d read: %d\n", sizeof(newSamples), bytes_read);
+        // For correct operation, we need to read exactly num_samples samples from i2s
+        if (bytes_read != num_samples * sizeof(I2S_datatype)) {
+          DEBUGSR_PRINTF("Failed to get enough samples: wanted: %d read: %d\n", num_samples * sizeof(I2S_datatype), bytes_read);
           return;
         }
 
-        // Store samples in sample buffer and update DC offset
-        for (int i = 0; i < num_samples; i++) {
+        // perform postprocessing (needed for ADC samples)
+        if (getType() == Type_I2SAdc) {
+          for (int i = 0; i < num_samples; i++) _readBuffer[i] = postProcessSample(_readBuffer[i]);
+        }
 
-          newSamples[i] = postProcessSample(newSamples[i]);  // perform postprocessing (needed for ADC samples)
-          
-          float currSample = 0.0f;
+        // Store samples in sample buffer - conversion and scaling in one multiplication per sample
 #ifdef I2S_SAMPLE_DOWNSCALE_TO_16BIT
-              currSample = (float) newSamples[i] / 65536.0f;      // 32bit input -> 16bit; keeping lower 16bits as decimal places
+        const float scale = _sampleScale / 65536.0f;    // 32bit input -> 16bit; keeping lower 16bits as decimal places
 #else
-              currSample = (float) newSamples[i];                 // 16bit input -> use as-is
+        const float scale = _sampleScale;               // 16bit input -> use as-is
 #endif
-          buffer[i] = currSample;
-          buffer[i] *= _sampleScale;                              // scale samples
-        }
+        for (int i = 0; i < num_samples; i++) buffer[i] = float(_readBuffer[i]) * scale;
       }
     }
 
@@ -375,6 +412,9 @@ class I2SSource : public AudioSource {
     i2s_config_t _config;
     i2s_pin_config_t _pinConfig;
     int8_t _mclkPin;
+    I2S_datatype *_readBuffer = nullptr;  // raw samples from I2S driver
+    uint16_t _readBufferSize = 0;         // allocated size of _readBuffer (samples)
+    uint64_t _lastReadEnd = 0;            // esp_timer_get_time() at end of last read, 0 = no read yet
 };
 
 /* ES7243 Microphone
@@ -575,7 +615,7 @@ class I2SAdcSource : public I2SSource {
         .communication_format = i2s_comm_format_t(I2S_COMM_FORMAT_I2S | I2S_COMM_FORMAT_I2S_MSB),
 #endif
         .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
-        .dma_buf_count = 8,
+        .dma_buf_count = SR_DMA_BUFFERS,
         .dma_buf_len = _blockSize,
         .use_apll = false,
         .tx_desc_auto_clear = false,
@@ -770,4 +810,113 @@ class SPH0654 : public I2SSource {
 #endif
     }
 };
+#ifdef SR_WAV_REPLAY
+#ifndef SR_WAV_FILE
+#define SR_WAV_FILE "/replay.wav"
+#endif
+/* WAV file replay
+   Feeds a 16bit PCM WAV file from the file system into the processing chain instead of a microphone,
+   so filter, FFT, AGC and peak detection can be tuned with reproducible input.
+   The sample rate of the file must match; from multi-channel files only the first channel is used.
+   Playback loops and is paced to real time, so FFT task timing is the same as with a live microphone.
+   The file is read from the FFT task, so file system access is locked against (background) writes of the loop task.
+*/
+class WavFileSource : public AudioSource {
+  public:
+    WavFileSource(SRate_t sampleRate, int blockSize, float sampleScale = 1.0f) :
+      AudioSource(sampleRate, blockSize, sampleScale)
+    {}
+
+    void initialize(int8_t = I2S_PIN_NO_CHANGE, int8_t = I2S_PIN_NO_CHANGE, int8_t = I2S_PIN_NO_CHANGE, int8_t = I2S_PIN_NO_CHANGE) {
+      DEBUGSR_PRINTLN(F("WavFileSource:: initialize()."));
+      if (!lockFileSystem(1000)) return;
+      _file = WLED_FS.open(SR_WAV_FILE, "r");
+      bool valid = _file && readHeader();
+      if (!valid && _file) _file.close();
+      unlockFileSystem();
+      if (!valid) {
+        DEBUGSR_PRINTLN(F("AR: WAV file not found or unsupported (need 16bit PCM at matching sample rate)."));
+        return;
+      }
+      _nextBlock = micros();
+      _initialized = true;
+    }
+
+    void deinitialize() {
+      if (_file && lockFileSystem(1000)) {
+        _file.close();
+        unlockFileSystem();
+      }
+      _initialized = false;
+    }
+
+    void getSamples(float *buffer, uint16_t num_samples) {
+      if (!_initialized) return;
+      // wait until a microphone would have delivered this block
+      const uint32_t blockTime = (1000000ULL * num_samples) / _sampleRate;
+      int32_t wait = int32_t(_nextBlock - micros());
+      if (wait > 1000) vTaskDelay(pdMS_TO_TICKS(wait / 1000));
+      if (wait < -int32_t(blockTime)) _nextBlock = micros(); // fell behind - don't try to catch up
+      _nextBlock += blockTime;
+
+      uint16_t done = 0;
+      if (lockFileSystem(blockTime / 1000 + 1)) { // don't stall sampling during long writes, silence is delivered instead
+        readSamples(buffer, num_samples, done);
+        unlockFileSystem();
+      }
+      if (done < num_samples) memset(buffer + done, 0, (num_samples - done) * sizeof(float)); // read error or FS busy - deliver silence
+    }
+
+  private:
+    File _file;
+    uint32_t _dataStart = 0;        // file position of first sample
+    uint32_t _dataSize = 0;         // size of sample data in bytes
+    uint16_t _channels = 1;
+    unsigned long _nextBlock = 0;   // micros() when next block is due
+
+    void readSamples(float *buffer, uint16_t num_samples, uint16_t &done) {
+      int16_t chunk[64 * 2];
+      while (done < num_samples) {
+        size_t left = (_dataStart + _dataSize - _file.position()) / (2 * _channels);
+        if (left == 0) { // loop
+          _file.seek(_dataStart);
+          left = _dataSize / (2 * _channels);
+        }
+        size_t frames = min(min(size_t(64), size_t(num_samples - done)), left);
+        size_t got = _file.read((uint8_t*)chunk, frames * 2 * _channels) / (2 * _channels);
+        if (got == 0) return; // read error
+        for (size_t i = 0; i < got; i++) buffer[done++] = float(chunk[i * _channels]) * _sampleScale;
+      }
+    }
+
+    bool readHeader() {
+      char id[4];
+      uint32_t size = 0;
+      if (_file.read((uint8_t*)id, 4) != 4 || memcmp(id, "RIFF", 4)) return false;
+      _file.read((uint8_t*)&size, 4);
+      if (_file.read((uint8_t*)id, 4) != 4 || memcmp(id, "WAVE", 4)) return false;
+      bool haveFormat = false;
+      while (_file.read((uint8_t*)id, 4) == 4 && _file.read((uint8_t*)&size, 4) == 4) {
+        uint32_t next = _file.position() + size + (size & 1); // chunks are word aligned
+        if (!memcmp(id, "fmt ", 4) && size >= 16) {
+          uint16_t format = 0, bits = 0;
+          uint32_t rate = 0;
+          _file.read((uint8_t*)&format, 2);
+          _file.read((uint8_t*)&_channels, 2);
+          _file.read((uint8_t*)&rate, 4);
+          _file.seek(_file.position() + 6);  // byte rate, block align
+          _file.read((uint8_t*)&bits, 2);
+          haveFormat = (format == 1) && (bits == 16) && (rate == uint32_t(_sampleRate)) && (_channels > 0) && (_channels <= 2);
+          if (!haveFormat) return false;
+        } else if (!memcmp(id, "data", 4)) {
+          _dataStart = _file.position();
+          _dataSize = min(size, uint32_t(_file.size() - _dataStart)) / (2 * _channels) * (2 * _channels);
+          return haveFormat && (_dataSize > 0);
+        }
+        _file.seek(next);
+      }
+      return false;
+    }
+};
+#endif
 #endif
@@ -47,8 +47,9 @@
   uint8_t  *binNum = (uint8_t*)&SEGENV.aux1, *maxVol = (uint8_t*)(&SEGENV.aux1+1); // just in case assignment
   bool      samplePeak = false;
   float     FFT_MajorPeak = 1.0;
-  uint8_t  *fftResult = nullptr;
-  float    *fftBin = nullptr;
+  uint8_t  *fftResult = nullptr, *fftResultExt = nullptr, numBands = 16;
+  uint32_t  audioSequence = 0, audioTimestamp = 0;
+  float     beatBPM = 0, beatPhase = 0, beatConfidence = 0;
   um_data_t *um_data = getAudioData();
   volumeSmth    = *(float*)   um_data->u_data[0];
   volumeRaw     = *(float*)   um_data->u_data[1];
@@ -58,7 +59,13 @@
   my_magnitude  = *(float*)   um_data->u_data[5];
   maxVol        =  (uint8_t*) um_data->u_data[6];  // requires UI element (SEGMENT.customX?), changes source element
   binNum        =  (uint8_t*) um_data->u_data[7];  // requires UI element (SEGMENT.customX?), changes source element
-  fftBin        =  (float*)   um_data->u_data[8];
+  audioSequence = *(uint32_t*)um_data->u_data[8];  // changes whenever new audio data is available
+  audioTimestamp= *(uint32_t*)um_data->u_data[9];  // capture time, data age = millis() - audioTimestamp
+  beatBPM       = *(float*)   um_data->u_data[10]; // tempo estimate, 0 = unknown
+  beatPhase     = *(float*)   um_data->u_data[11]; // 0 ... 1 within the current beat, 0 = on the beat
+  beatConfidence= *(float*)   um_data->u_data[12]; // 0 ... 1, tempo is unreliable below ~0.3
+  fftResultExt  =  (uint8_t*) um_data->u_data[13]; // numBands frequency bands (log spaced), same scaling as fftResult
+  numBands      = *(uint8_t*) um_data->u_data[14]; // 16, 32 or 64
 */
 
 #define IBN 5100
@@ -5877,9 +5884,11 @@ uint16_t mode_2Dnoise(void) {                  // By Andrew Tuline
 
   const unsigned scale  = SEGMENT.intensity+2;
 
+  const uint8_t *noise = getNoiseField(cols, rows, 0, 0, strip.now / (16 - SEGMENT.speed/16), scale, scale, NOISE_FIELD_8BIT | NOISE_FIELD_FAST);
+
   for (int y = 0; y < rows; y++) {
     for (int x = 0; x < cols; x++) {
-      uint8_t pixelHue8 = perlin8(x * scale, y * scale, strip.now / (16 - SEGMENT.speed/16));
+      uint8_t pixelHue8 = noise ? *noise++ : perlin8(x * scale, y * scale, strip.now / (16 - SEGMENT.speed/16)); // per pixel if field is not available
       SEGMENT.setPixelColorXY(x, y, ColorFromPalette(SEGPALETTE, pixelHue8));
     }
   }
@@ -6062,12 +6071,13 @@ uint16_t mode_2DSunradiation(void) {                   // By: ldirko https://edi
   }
 
   unsigned long t = strip.now / 4;
-  unsigned index = 0;
   uint8_t someVal = SEGMENT.speed/4;             // Was 25.
+  const uint8_t *noise = getNoiseField(cols + 2, rows + 2, 0, 0, t, someVal, someVal, NOISE_FIELD_8BIT | NOISE_FIELD_FAST);
+  unsigned index = 0;
   for (int j = 0; j < (rows + 2); j++) {
     for (int i = 0; i < (cols + 2); i++) {
       //byte col = (inoise8_raw(i * someVal, j * someVal, t)) / 2;
-      byte col = ((int16_t)perlin8(i * someVal, j * someVal, t) - 0x7F) / 3;
+      byte col = ((int16_t)(noise ? noise[index] : perlin8(i * someVal, j * someVal, t)) - 0x7F) / 3;
       bump[index++] = col;
     }
   }
@@ -6632,13 +6642,14 @@ uint16_t mode_2Dplasmarotozoom() {
   byte *plasma = reinterpret_cast<byte*>(SEGENV.data+sizeof(float));
 
   unsigned ms = strip.now/15;  
+  const uint8_t *noise = SEGMENT.check1 ? nullptr : getNoiseField(cols, rows, 0, 0, ms, 40, 40, NOISE_FIELD_8BIT | NOISE_FIELD_FAST);
 
   // plasma
   for (int j = 0; j < rows; j++) {
     int index = j*cols;
     for (int i = 0; i < cols; i++) {
       if (SEGMENT.check1) plasma[index+i] = (i * 4 ^ j * 4) + ms / 6;
-      else                plasma[index+i] = inoise8(i * 40, j * 40, ms);
+      else                plasma[index+i] = noise ? noise[index+i] : inoise8(i * 40, j * 40, ms);
     }
   }
 
@@ -7982,11 +7993,12 @@ uint16_t mode_2Dsoap() {
   if (SEGENV.call == 0) for (int i = 0; i < 3; i++) noisecoord[i] = hw_random(); // init
   else                  for (int i = 0; i < 3; i++) noisecoord[i] += mov;
 
+  const uint8_t *noise = getNoiseField(cols, rows, noisecoord[0] - scale32_x * (cols / 2), noisecoord[1] - scale32_y * (rows / 2), noisecoord[2], scale32_x, scale32_y, NOISE_FIELD_FAST);
   for (int i = 0; i < cols; i++) {
     int32_t ioffset = scale32_x * (i - cols / 2);
     for (int j = 0; j < rows; j++) {
       int32_t joffset = scale32_y * (j - rows / 2);
-      uint8_t data = perlin16(noisecoord[0] + ioffset, noisecoord[1] + joffset, noisecoord[2]) >> 8;
+      uint8_t data = noise ? noise[XY(i,j)] : perlin16(noisecoord[0] + ioffset, noisecoord[1] + joffset, noisecoord[2]) >> 8;
       noise3d[XY(i,j)] = scale8(noise3d[XY(i,j)], smoothness) + scale8(data, 255 - smoothness);
     }
   }
@@ -10979,11 +10991,13 @@ uint8_t WS2812FX::addEffect(uint8_t id, mode_ptr mode_fn, const char *mode_name)
     if (_modeData[id] != _data_RESERVED) return 255; // do not overwrite an already added effect
     _mode[id]     = mode_fn;
     _modeData[id] = mode_name;
+    effectListVersion++; // invalidate cached /json/eff and /json/fxdata
     return id;
   } else if (_mode.size() < 255) { // 255 is reserved for indicating the effect wasn't added
     _mode.push_back(mode_fn);
     _modeData.push_back(mode_name);
     if (_modeCount < _mode.size()) _modeCount++;
+    effectListVersion++; // invalidate cached /json/eff and /json/fxdata
     return _mode.size() - 1;
   } else {
     return 255; // The vector is full so return 255
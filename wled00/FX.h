@@ -488,6 +488,8 @@ class Segment {
         bool    _manualW  : 1;
       };
     };
+    struct ExpansionMap;              // 1D to 2D expansion of Arc, Corner & Pinwheel mapping (see FX_fcn.cpp)
+    mutable ExpansionMap *_expansion; // built on demand, depends on mapping and virtual dimensions only
 
     // static variables are use to speed up effect calculations by stashing common pre-calculated values
     static unsigned      _usedSegmentData;    // amount of data used by all segments
@@ -495,6 +497,7 @@ class Segment {
     static unsigned      _vWidth, _vHeight;   // 2D dimensions used for current effect
     static uint32_t      _currentColors[NUM_COLORS]; // colors used for current effect (faster access from effect functions)
     static CRGBPalette16 _currentPalette;     // palette used for current effect (includes transition, used in color_from_palette())
+    static const uint32_t *_currentPaletteExpanded; // 256 entry expansion of _currentPalette from palette table (nullptr if not available)
     static CRGBPalette16 _randomPalette;      // actual random palette
     static CRGBPalette16 _newRandomPalette;   // target random palette
     static uint16_t      _lastPaletteChange;  // last random palette change time (in seconds)
@@ -546,9 +549,10 @@ class Segment {
   #ifndef WLED_DISABLE_2D
     inline void     setPixelColorXYRaw(unsigned x, unsigned y, uint32_t c) const  { auto XY = [](unsigned X, unsigned Y){ return X + Y*Segment::vWidth(); }; pixels[XY(x,y)] = c; }
     inline uint32_t getPixelColorXYRaw(unsigned x, unsigned y) const              { auto XY = [](unsigned X, unsigned Y){ return X + Y*Segment::vWidth(); }; return pixels[XY(x,y)]; };
+    const ExpansionMap *getExpansionMap() const; // returns (and rebuilds if needed) 1D to 2D expansion map, nullptr if not available
   #endif
     void resetIfRequired();         // sets all SEGENV variables to 0 and clears data buffer
-    CRGBPalette16 &loadPalette(CRGBPalette16 &tgt, uint8_t pal);
+    CRGBPalette16 &loadPalette(CRGBPalette16 &tgt, uint8_t pal, const uint32_t **expanded = nullptr);
 
     // transition functions
     void stopTransition();                  // ends transition mode by destroying transition structure (does nothing if not in transition)
@@ -601,6 +605,7 @@ class Segment {
     , _dataLen(0)
     , _default_palette(6)
     , _capabilities(0)
+    , _expansion(nullptr)
     , _t(nullptr)
     {
       DEBUGFX_PRINTF_P(PSTR("-- Creating segment: %p [%d,%d:%d,%d]\n"), this, (int)start, (int)stop, (int)startY, (int)stopY);
@@ -631,6 +636,7 @@ class Segment {
       #endif
       deallocateData();
       p_free(pixels);
+      p_free(_expansion);
     }
 
     Segment& operator= (const Segment &orig); // copy assignment
@@ -929,6 +935,7 @@ class WS2812FX {
     bool hasRGBWBus() const;
     bool hasCCTBus() const;
     bool deserializeMap(unsigned n = 0);
+    static void invalidateMap(unsigned n);
 
     inline bool isUpdating() const           { return !BusManager::canAllShow(); } // return true if the strip is being sent pixel updates
     inline bool isServicing() const          { return _isServicing; }           // returns true if strip.service() is executing
@@ -957,6 +964,7 @@ class WS2812FX {
 
     inline uint16_t getFps() const          { return (millis() - _lastShow > 2000) ? 0 : (FPS_MULTIPLIER * _cumulativeFps) >> FPS_CALC_SHIFT; } // Returns the refresh rate of the LED strip (_cumulativeFps is stored in fixed point)
     inline uint16_t getFrameTime() const    { return _frametime; }        // returns amount of time a frame should take (in ms)
+    inline unsigned long getNextFrameTime() const { return _lastServiceShow + _frametime; } // returns millis() when next frame is due
     inline uint16_t getMinShowDelay() const { return MIN_FRAME_DELAY; }   // returns minimum amount of time strip.service() can be delayed (constant)
     inline uint16_t getLength() const       { return _length; }           // returns actual amount of LEDs on a strip (2D matrix may have less LEDs than W*H)
     inline uint16_t getTransition() const   { return _transitionDur; }    // returns currently set transition time (in ms)
@@ -240,46 +240,47 @@ uint32_t IRAM_ATTR_YN Segment::getPixelColorXY(int x, int y) const {
 }
 
 // 2D blurring, can be asymmetrical
+// both passes work on whole rows of the pixel buffer (column blur keeps a row of carry-overs) which is faster than single pixel access
 void Segment::blur2D(uint8_t blur_x, uint8_t blur_y, bool smear) const {
   if (!isActive()) return; // not active
   const unsigned cols = vWidth();
   const unsigned rows = vHeight();
-  const auto XY = [&](unsigned x, unsigned y){ return x + y*cols; };
   if (blur_x) {
     const uint8_t keepx = smear ? 255 : 255 - blur_x;
     const uint8_t seepx = blur_x >> 1;
     for (unsigned row = 0; row < rows; row++) { // blur rows (x direction)
+      uint32_t *line = &pixels[row * cols];
       // handle first pixel in row to avoid conditional in loop (faster)
-      uint32_t cur = getPixelColorRaw(XY(0, row));
-      uint32_t carryover = fast_color_scale(cur, seepx);
-      setPixelColorRaw(XY(0, row), fast_color_scale(cur, keepx));
+      uint32_t carryover = fast_color_scale(line[0], seepx);
+      uint32_t last = fast_color_scale(line[0], keepx); // current pixel is written when its right neighbour has been added
       for (unsigned x = 1; x < cols; x++) {
-         cur = getPixelColorRaw(XY(x, row));
+        uint32_t cur = line[x];
         uint32_t part = fast_color_scale(cur, seepx);
-        cur = fast_color_scale(cur, keepx);
-        cur = color_add(cur, carryover);
-        setPixelColorRaw(XY(x - 1, row), color_add(getPixelColorRaw(XY(x-1, row)), part)); // previous pixel
-        setPixelColorRaw(XY(x, row), cur); // current pixel
+        line[x - 1] = fast_color_add(last, part); // previous pixel
+        last = fast_color_add(fast_color_scale(cur, keepx), carryover);
         carryover = part;
       }
+      line[cols - 1] = last;
     }
   }
   if (blur_y) {
     const uint8_t keepy = smear ? 255 : 255 - blur_y;
     const uint8_t seepy = blur_y >> 1;
-    for (unsigned col = 0; col < cols; col++) {
-      // handle first pixel in column
-      uint32_t cur = getPixelColorRaw(XY(col, 0));
-      uint32_t carryover = fast_color_scale(cur, seepy);
-      setPixelColorRaw(XY(col, 0), fast_color_scale(cur, keepy));
-      for (unsigned y = 1; y < rows; y++) {
-        cur = getPixelColorRaw(XY(col, y));
+    uint32_t carryover[cols]; // carry-over of each column
+    // handle first row
+    for (unsigned x = 0; x < cols; x++) {
+      carryover[x] = fast_color_scale(pixels[x], seepy);
+      pixels[x] = fast_color_scale(pixels[x], keepy);
+    }
+    for (unsigned y = 1; y < rows; y++) { // blur columns (y direction) one row at a time
+      uint32_t *prev = &pixels[(y - 1) * cols];
+      uint32_t *line = &pixels[y * cols];
+      for (unsigned x = 0; x < cols; x++) {
+        uint32_t cur = line[x];
         uint32_t part = fast_color_scale(cur, seepy);
-        cur = fast_color_scale(cur, keepy);
-        cur = color_add(cur, carryover);
-        setPixelColorRaw(XY(col, y - 1), color_add(getPixelColorRaw(XY(col, y-1)), part)); // previous pixel
-        setPixelColorRaw(XY(col, y), cur); // current pixel
-        carryover = part;
+        prev[x] = fast_color_add(prev[x], part); // previous pixel
+        line[x] = fast_color_add(fast_color_scale(cur, keepy), carryover[x]); // current pixel
+        carryover[x] = part;
       }
     }
   }
@@ -363,26 +364,13 @@ void Segment::moveX(int delta, bool wrap) const {
   if (!isActive() || !delta) return; // not active
   const int vW = vWidth();   // segment width in logical pixels (can be 0 if segment is inactive)
   const int vH = vHeight();  // segment height in logical pixels (is always >= 1)
-  const auto XY = [&](unsigned x, unsigned y){ return x + y*vW; };
   int absDelta = abs(delta);
   if (absDelta >= vW) return;
-  uint32_t newPxCol[vW];
-  int newDelta;
-  int stop = vW;
-  int start = 0;
-  if (wrap) newDelta = (delta + vW) % vW; // +cols in case delta < 0
-  else {
-    if (delta < 0) start = absDelta;
-    stop = vW - absDelta;
-    newDelta = delta > 0 ? delta : 0;
-  }
   for (int y = 0; y < vH; y++) {
-    for (int x = 0; x < stop; x++) {
-      int srcX = x + newDelta;
-      if (wrap) srcX %= vW; // Wrap using modulo when `wrap` is true
-      newPxCol[x] = getPixelColorRaw(XY(srcX, y));
-    }
-    for (int x = 0; x < stop; x++) setPixelColorRaw(XY(x + start, y), newPxCol[x]);
+    uint32_t *line = &pixels[y * vW];
+    if (wrap) std::rotate(line, line + (delta + vW) % vW, line + vW); // +cols in case delta < 0
+    else if (delta > 0) memmove(line, line + absDelta, (vW - absDelta) * sizeof(uint32_t));
+    else                memmove(line + absDelta, line, (vW - absDelta) * sizeof(uint32_t));
   }
 }
 
@@ -390,27 +378,12 @@ void Segment::moveY(int delta, bool wrap) const {
   if (!isActive() || !delta) return; // not active
   const int vW = vWidth();   // segment width in logical pixels (can be 0 if segment is inactive)
   const int vH = vHeight();  // segment height in logical pixels (is always >= 1)
-  const auto XY = [&](unsigned x, unsigned y){ return x + y*vW; };
   int absDelta = abs(delta);
   if (absDelta >= vH) return;
-  uint32_t newPxCol[vH];
-  int newDelta;
-  int stop = vH;
-  int start = 0;
-  if (wrap) newDelta = (delta + vH) % vH; // +rows in case delta < 0
-  else {
-    if (delta < 0) start = absDelta;
-    stop = vH - absDelta;
-    newDelta = delta > 0 ? delta : 0;
-  }
-  for (int x = 0; x < vW; x++) {
-    for (int y = 0; y < stop; y++) {
-      int srcY = y + newDelta;
-      if (wrap) srcY %= vH; // Wrap using modulo when `wrap` is true
-      newPxCol[y] = getPixelColorRaw(XY(x, srcY));
-    }
-    for (int y = 0; y < stop; y++) setPixelColorRaw(XY(x, y + start), newPxCol[y]);
-  }
+  // rows are contiguous in the pixel buffer so they can be moved as a single block
+  if (wrap) std::rotate(pixels, pixels + ((delta + vH) % vH) * vW, pixels + vH * vW); // +rows in case delta < 0
+  else if (delta > 0) memmove(pixels, pixels + absDelta * vW, (vH - absDelta) * vW * sizeof(uint32_t));
+  else                memmove(pixels + absDelta * vW, pixels, (vH - absDelta) * vW * sizeof(uint32_t));
 }
 
 // move() - move all pixels in desired direction delta number of pixels
@@ -44,6 +44,7 @@ unsigned      Segment::_vWidth            = 0;
 unsigned      Segment::_vHeight           = 0;
 uint32_t      Segment::_currentColors[NUM_COLORS] = {0,0,0};
 CRGBPalette16 Segment::_currentPalette    = CRGBPalette16(CRGB::Black);
+const uint32_t *Segment::_currentPaletteExpanded = nullptr;
 CRGBPalette16 Segment::_randomPalette     = generateRandomPalette();  // was CRGBPalette16(DEFAULT_COLOR);
 CRGBPalette16 Segment::_newRandomPalette  = generateRandomPalette();  // was CRGBPalette16(DEFAULT_COLOR);
 uint16_t      Segment::_lastPaletteChange = 0; // in seconds; perhaps it should be per segment
@@ -64,6 +65,7 @@ Segment::Segment(const Segment &orig) {
   data = nullptr;
   _dataLen = 0;
   pixels = nullptr;
+  _expansion = nullptr;
   if (!stop) return;  // nothing to do if segment is inactive/invalid
   if (orig.pixels) {
     // allocate pixel buffer: prefer IRAM/PSRAM
@@ -89,6 +91,7 @@ Segment::Segment(Segment &&orig) noexcept {
   orig.data = nullptr;
   orig._dataLen = 0;
   orig.pixels = nullptr;
+  orig._expansion = nullptr;
 }
 
 // copy assignment
@@ -100,12 +103,14 @@ Segment& Segment::operator= (const Segment &orig) {
     if (_t) stopTransition(); // also erases _t
     deallocateData();
     p_free(pixels);
+    p_free(_expansion);
     // copy source
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     // erase pointers to allocated data
     data = nullptr;
     _dataLen = 0;
     pixels = nullptr;
+    _expansion = nullptr;
     if (!stop) return *this;  // nothing to do if segment is inactive/invalid
     // copy source data
     if (orig.pixels) {
@@ -133,12 +138,14 @@ Segment& Segment::operator= (Segment &&orig) noexcept {
     if (_t) stopTransition(); // also erases _t
     deallocateData(); // free old runtime data
     p_free(pixels);   // free old pixel buffer
+    p_free(_expansion);
     // move source data
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     orig.name = nullptr;
     orig.data = nullptr;
     orig._dataLen = 0;
     orig.pixels = nullptr;
+    orig._expansion = nullptr;
     orig._t = nullptr; // old segment cannot be in transition
   }
   return *this;
@@ -224,7 +231,8 @@ void Segment::resetIfRequired() {
   #endif
 }
 
-CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
+// if expanded is given fixed palettes are loaded from palette table and expanded is set to their 256 entry expansion (nullptr otherwise)
+CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal, const uint32_t **expanded) {
   // there is one randomy generated palette (1) followed by 4 palettes created from segment colors (2-5)
   // those are followed by 7 fastled palettes (6-12) and 59 gradient palettes (13-71)
   // then come the custom palettes (255,254,...) growing downwards from 255 (255 being 1st custom palette)
@@ -233,9 +241,10 @@ CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
   if (pal >= FIXED_PALETTE_COUNT && pal <= 255-customPalettes.size()) pal = 0; // out of bounds palette
   //default palette. Differs depending on effect
   if (pal == 0) pal = _default_palette; // _default_palette is set in setMode()
+  if (expanded) *expanded = nullptr;
   switch (pal) {
     case 0: //default palette. Exceptions for specific effects above
-      targetPalette = PartyColors_p;
+      loadFixedPalette(targetPalette, pal, expanded);
       break;
     case 1: //randomly generated palette
       targetPalette = _randomPalette; //random palette is generated at intervals in handleRandomPalette()
@@ -268,12 +277,8 @@ CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
     default: //progmem palettes
       if (pal > 255 - customPalettes.size()) {
         targetPalette = customPalettes[255-pal]; // we checked bounds above
-      } else if (pal < DYNAMIC_PALETTE_COUNT + FASTLED_PALETTE_COUNT) { // palette 6 - 12, fastled palettes
-        targetPalette = *fastledPalettes[pal - DYNAMIC_PALETTE_COUNT];
-      } else {
-        byte tcp[72];
-        memcpy_P(tcp, (byte*)pgm_read_dword(&(gGradientPalettes[pal - (DYNAMIC_PALETTE_COUNT + FASTLED_PALETTE_COUNT)])), sizeof(tcp));
-        targetPalette.loadDynamicGradientPalette(tcp);
+      } else { // palette 6 - 12 fastled palettes, 13 - 71 gradient palettes
+        loadFixedPalette(targetPalette, pal, expanded);
       }
       break;
   }
@@ -370,8 +375,9 @@ void Segment::beginDraw(uint16_t prog) {
   // load colors into _currentColors
   for (unsigned i = 0; i < NUM_COLORS; i++) _currentColors[i] = colors[i];
   // load palette into _currentPalette
-  loadPalette(Segment::_currentPalette, palette);
+  loadPalette(Segment::_currentPalette, palette, &Segment::_currentPaletteExpanded);
   if (isInTransition() && prog < 0xFFFFU && blendingStyle == BLEND_STYLE_FADE) {
+    Segment::_currentPaletteExpanded = nullptr; // palette is blended
     // blend colors
     for (unsigned i = 0; i < NUM_COLORS; i++) _currentColors[i] = color_blend16(_t->_colors[i], colors[i], prog);
     // blend palettes
@@ -454,6 +460,8 @@ void Segment::setGeometry(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, ui
     deallocateData();
     p_free(pixels);
     pixels = nullptr;
+    p_free(_expansion);
+    _expansion = nullptr;
     stop = 0;
     return;
   }
@@ -475,6 +483,8 @@ void Segment::setGeometry(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, ui
     deallocateData();
     p_free(pixels);
     pixels = nullptr;
+    p_free(_expansion);
+    _expansion = nullptr;
     stop = 0;
     return;
   }
@@ -646,6 +656,243 @@ static void setPinwheelParameters(int i, int vW, int vH, int& startx, int& start
   startx = (vW * Fixed_Scale) / 2; // + cosVal[0] / 4; // starting position = center + 1/4 pixel (in fixed point)
   starty = (vH * Fixed_Scale) / 2; // + sinVal[0] / 4;
 }
+// Pinwheel helper function: pixel used for reading the color of a ray (not 100% accurate, returns pixel at outer edge)
+static void getPinwheelPixel(int i, int vW, int vH, int &x, int &y) {
+  int cosVal[2], sinVal[2];
+  setPinwheelParameters(i, vW, vH, x, y, cosVal, sinVal, true);
+  int maxX = (vW-1) * Fixed_Scale;
+  int maxY = (vH-1) * Fixed_Scale;
+  // trace ray from center until we hit any edge - to avoid rounding problems, we use fixed point coordinates
+  while ((x < maxX)  && (y < maxY) && (x > Fixed_Scale) && (y > Fixed_Scale)) {
+    x += cosVal[0]; // advance to next position
+    y += sinVal[0];
+  }
+  x /= Fixed_Scale;
+  y /= Fixed_Scale;
+}
+
+// Pixel groups of a Pinwheel ray: pixels on the lines shared with adjacent rays are only drawn if the adjacent ray was not drawn just before
+enum PinwheelGroup : uint8_t {
+  PW_CORE,    // always drawn
+  PW_FIRST,   // drawn if first line is drawn
+  PW_EITHER,  // drawn if first or last line is drawn
+  PW_LAST,    // drawn if last line is drawn
+  PW_BOTH,    // drawn only if both lines are drawn
+  PW_GROUPS
+};
+// group of a Pinwheel pixel from the groups (as bit mask) it was visited with
+static unsigned getPinwheelGroup(unsigned visits) {
+  if (visits & (1<<PW_CORE)) return PW_CORE;
+  const bool first = visits & (1<<PW_FIRST);
+  const bool last  = visits & (1<<PW_LAST);
+  if (first && last) return PW_EITHER;
+  if (first)         return PW_FIRST;
+  if (last)          return PW_LAST;
+  return PW_BOTH;
+}
+
+// expands logical pixel i of a 2D segment with Arc, Corner or Pinwheel mapping by calling emit(x, y, group) for each covered pixel
+// pixels may be outside of the segment or visited more than once; group is always PW_CORE unless mapping is Pinwheel
+template<typename F>
+static void expand1D2D(uint8_t mapping, int i, int vW, int vH, F &&emit) {
+  switch (mapping) {
+    case M12_pArc:
+      // expand in circular fashion from center
+      if (i == 0)
+        emit(0, 0, PW_CORE);
+      else {
+        float r = i;
+        float step = HALF_PI / (2.8284f * r + 4); // we only need (PI/4)/(r/sqrt(2)+1) steps
+        for (float rad = 0.0f; rad <= (HALF_PI/2)+step/2; rad += step) {
+          int x = roundf(sin_t(rad) * r);
+          int y = roundf(cos_t(rad) * r);
+          // exploit symmetry
+          emit(x, y, PW_CORE);
+          emit(y, x, PW_CORE);
+        }
+        // Bresenham’s Algorithm (may not fill every pixel)
+        //int d = 3 - (2*i);
+        //int y = i, x = 0;
+        //while (y >= x) {
+        //  emit(x, y, PW_CORE);
+        //  emit(y, x, PW_CORE);
+        //  x++;
+        //  if (d > 0) {
+        //    y--;
+        //    d += 4 * (x - y) + 10;
+        //  } else {
+        //    d += 4 * x + 6;
+        //  }
+        //}
+      }
+      break;
+    case M12_pCorner:
+      for (int x = 0; x <= i; x++) emit(x, i, PW_CORE); // note: <= to include i=0. Relies on overflow check by caller
+      for (int y = 0; y <  i; y++) emit(i, y, PW_CORE);
+      break;
+    case M12_sPinwheel: {
+      // Uses Bresenham's algorithm to place coordinates of two lines in arrays then draws between them
+      int startX, startY, cosVal[2], sinVal[2]; // in fixed point scale
+      setPinwheelParameters(i, vW, vH, startX, startY, cosVal, sinVal);
+
+      unsigned maxLineLength = max(vW, vH) + 2; // pixels drawn is always smaller than dx or dy, +1 pair for rounding errors
+      uint16_t lineCoords[2][maxLineLength];    // uint16_t to save ram
+      int lineLength[2] = {0};
+
+      int closestEdgeIdx = INT_MAX; // index of the closest edge pixel
+
+      for (int lineNr = 0; lineNr < 2; lineNr++) {
+        int x0 = startX; // x, y coordinates in fixed scale
+        int y0 = startY;
+        int x1 = (startX + (cosVal[lineNr] << 9)); // outside of grid
+        int y1 = (startY + (sinVal[lineNr] << 9)); // outside of grid
+        const int dx =  abs(x1-x0), sx = x0<x1 ? 1 : -1; // x distance & step
+        const int dy = -abs(y1-y0), sy = y0<y1 ? 1 : -1; // y distance & step
+        uint16_t* coordinates = lineCoords[lineNr]; // 1D access is faster
+        int* length = &lineLength[lineNr];          // faster access
+        x0 /= Fixed_Scale; // convert to pixel coordinates
+        y0 /= Fixed_Scale;
+
+        // Bresenham's algorithm
+        int idx = 0;
+        int err = dx + dy;
+        while (true) {
+          if ((unsigned)x0 >= (unsigned)vW || (unsigned)y0 >= (unsigned)vH) {
+            closestEdgeIdx = min(closestEdgeIdx, idx-2);
+            break; // stop if outside of grid (exploit unsigned int overflow)
+          }
+          coordinates[idx++] = x0;
+          coordinates[idx++] = y0;
+          (*length)++;
+          // note: since endpoint is out of grid, no need to check if endpoint is reached
+          int e2 = 2 * err;
+          if (e2 >= dy) { err += dy; x0 += sx; }
+          if (e2 <= dx) { err += dx; y0 += sy; }
+        }
+      }
+
+      // fill up the shorter line with missing coordinates, so block filling works correctly and efficiently
+      int diff = lineLength[0] - lineLength[1];
+      int longLineIdx = (diff > 0) ? 0 : 1;
+      int shortLineIdx = longLineIdx ? 0 : 1;
+      if (diff != 0) {
+        int idx = (lineLength[shortLineIdx] - 1) * 2; // last valid coordinate index
+        int lastX = lineCoords[shortLineIdx][idx++];
+        int lastY = lineCoords[shortLineIdx][idx++];
+        bool keepX = lastX == 0 || lastX == vW - 1;
+        for (int d = 0; d < abs(diff); d++) {
+          lineCoords[shortLineIdx][idx] = keepX ? lastX :lineCoords[longLineIdx][idx];
+          idx++;
+          lineCoords[shortLineIdx][idx] =  keepX ? lineCoords[longLineIdx][idx] : lastY;
+          idx++;
+        }
+      }
+
+      // block-fill the line coordinates. Note: block filling only efficient if angle between lines is small
+      closestEdgeIdx += 2;
+      for (int idx = 0; idx < lineLength[longLineIdx] * 2;) { //!! should be long line idx!
+        int x1 = lineCoords[0][idx];
+        int x2 = lineCoords[1][idx++];
+        int y1 = lineCoords[0][idx];
+        int y2 = lineCoords[1][idx++];
+        int minX, maxX, minY, maxY;
+        (x1 < x2) ? (minX = x1, maxX = x2) : (minX = x2, maxX = x1);
+        (y1 < y2) ? (minY = y1, maxY = y2) : (minY = y2, maxY = y1);
+
+        // fill the block between the two x,y points
+        bool alwaysDraw = (idx > closestEdgeIdx)  || // Edge pixels on uneven lines are always drawn
+                          (i == 0 && idx == 2);      // Center pixel special case
+        for (int x = minX; x <= maxX; x++) {
+          for (int y = minY; y <= maxY; y++) {
+            bool onLine1 = x == x1 && y == y1;
+            bool onLine2 = x == x2 && y == y2;
+            if (alwaysDraw || (!onLine1 && !onLine2)) emit(x, y, PW_CORE);  // Middle pixels
+            else if (!onLine2)                        emit(x, y, PW_FIRST); // line1 if drawFirst
+            else if (!onLine1)                        emit(x, y, PW_LAST);  // line2 if drawLast
+            else                                      emit(x, y, PW_BOTH);  // both lines if drawFirst and drawLast
+          }
+        }
+      }
+      break;
+    }
+  }
+}
+
+// Precomputed expansion of a 2D segment's logical pixels for Arc, Corner and Pinwheel mapping, saves recalculating arcs and rays
+// for every set pixel. Pixels of logical pixel i (and Pinwheel group g) are cells[start[i*groups+g] ... start[i*groups+g+1]-1].
+struct Segment::ExpansionMap {
+  uint16_t vW, vH;    // virtual dimensions the map was built for
+  uint8_t  mapping;   // map1D2D the map was built for
+  uint32_t *start;    // offsets into cells[], vLength()*groups+1 entries (groups = PW_GROUPS for Pinwheel, 1 otherwise)
+  uint16_t *cells;    // virtual pixel indices (x + y*vW)
+  uint16_t *readCell; // virtual pixel returned by getPixelColor() or UINT16_MAX if outside (Pinwheel only)
+};
+
+static unsigned long expansionRetry = 0; // do not retry building an expansion map before this time (if RAM is low)
+
+// returns expansion map for current mapping and virtual dimensions (rebuilding it if needed) or nullptr if it is not available
+const Segment::ExpansionMap *Segment::getExpansionMap() const {
+  const unsigned vW = vWidth();
+  const unsigned vH = vHeight();
+  if (_expansion && _expansion->vW == vW && _expansion->vH == vH && _expansion->mapping == map1D2D) return _expansion;
+  p_free(_expansion);
+  _expansion = nullptr;
+  if (vW * vH >= UINT16_MAX || (long)(strip.now - expansionRetry) < 0) return nullptr; // cell indices are 16 bit
+
+  const unsigned vLen = vLength();
+  const unsigned groups = map1D2D == M12_sPinwheel ? PW_GROUPS : 1;
+  ExpansionMap *map = nullptr;
+  uint8_t *visits = static_cast<uint8_t*>(d_calloc(vW * vH, sizeof(uint8_t))); // groups each pixel was visited with (as bit mask)
+  if (visits) {
+    // calls fn(cell, group) once for each (valid) virtual pixel of logical pixel i
+    const auto forEachCell = [&](int i, auto &&fn) {
+      const auto XY = [&](int x, int y) { return ((unsigned)x < vW && (unsigned)y < vH) ? int(x + y*vW) : -1; };
+      expand1D2D(map1D2D, i, vW, vH, [&](int x, int y, unsigned g) { int c = XY(x, y); if (c >= 0) visits[c] |= 1<<g; });
+      expand1D2D(map1D2D, i, vW, vH, [&](int x, int y, unsigned) {
+        int c = XY(x, y);
+        if (c < 0 || !visits[c]) return; // outside or already listed
+        fn(c, groups > 1 ? getPinwheelGroup(visits[c]) : PW_CORE);
+        visits[c] = 0;
+      });
+    };
+    unsigned total = 0;
+    for (unsigned i = 0; i < vLen; i++) forEachCell(i, [&](unsigned, unsigned) { total++; });
+
+    size_t size = sizeof(ExpansionMap) + (vLen * groups + 1) * sizeof(uint32_t) + (total + (groups > 1 ? vLen : 0)) * sizeof(uint16_t);
+    map = static_cast<ExpansionMap*>(allocate_buffer(size, BFRALLOC_PREFER_DRAM));
+    if (map) {
+      map->vW = vW;
+      map->vH = vH;
+      map->mapping  = map1D2D;
+      map->start    = reinterpret_cast<uint32_t*>(map + 1);
+      map->cells    = reinterpret_cast<uint16_t*>(map->start + vLen * groups + 1);
+      map->readCell = groups > 1 ? map->cells + total : nullptr;
+      map->start[0] = 0;
+      for (unsigned i = 0; i < vLen; i++) {
+        uint32_t *start = &map->start[i * groups];
+        uint32_t pos[PW_GROUPS] = {0};
+        forEachCell(i, [&](unsigned, unsigned g) { pos[g]++; }); // count pixels per group
+        for (unsigned g = 0; g < groups; g++) {
+          start[g+1] = start[g] + pos[g];
+          pos[g] = start[g];
+        }
+        forEachCell(i, [&](unsigned c, unsigned g) { map->cells[pos[g]++] = c; });
+        if (map->readCell) {
+          int x, y;
+          getPinwheelPixel(i, vW, vH, x, y);
+          map->readCell[i] = ((unsigned)x < vW && (unsigned)y < vH) ? x + y*vW : UINT16_MAX;
+        }
+      }
+    }
+    d_free(visits);
+  }
+  if (!map) {
+    DEBUGFX_PRINTLN(F("!!! Not enough RAM for 1D expansion map !!!"));
+    expansionRetry = strip.now + 1000; // use slow path for a while
+  }
+  _expansion = map;
+  return map;
+}
 #endif
 
 // 1D strip
@@ -743,129 +990,36 @@ void WLED_O2_ATTR Segment::setPixelColor(int i, uint32_t col) const
         else for (int x = 0; x < vW; x++) setPixelColorRaw(XY(x, vH - i - 1), col);
         break;
       case M12_pArc:
-        // expand in circular fashion from center
-        if (i == 0)
-          setPixelColorRaw(XY(0, 0), col);
-        else {
-          float r = i;
-          float step = HALF_PI / (2.8284f * r + 4); // we only need (PI/4)/(r/sqrt(2)+1) steps
-          for (float rad = 0.0f; rad <= (HALF_PI/2)+step/2; rad += step) {
-            int x = roundf(sin_t(rad) * r);
-            int y = roundf(cos_t(rad) * r);
-            // exploit symmetry
-            setPixelColorXY(x, y, col);
-            setPixelColorXY(y, x, col);
-          }
-          // Bresenham’s Algorithm (may not fill every pixel)
-          //int d = 3 - (2*i);
-          //int y = i, x = 0;
-          //while (y >= x) {
-          //  setPixelColorXY(x, y, col);
-          //  setPixelColorXY(y, x, col);
-          //  x++;
-          //  if (d > 0) {
-          //    y--;
-          //    d += 4 * (x - y) + 10;
-          //  } else {
-          //    d += 4 * x + 6;
-          //  }
-          //}
-        }
-        break;
-      case M12_pCorner:
-        for (int x = 0; x <= i; x++) setPixelColorXY(x, i, col); // note: <= to include i=0. Relies on overflow check in sPC()
-        for (int y = 0; y <  i; y++) setPixelColorXY(i, y, col);
+      case M12_pCorner: {
+        // expand in circular fashion from center or along the corner
+        const ExpansionMap *map = getExpansionMap();
+        if (map) for (unsigned c = map->start[i]; c < map->start[i+1]; c++) setPixelColorRaw(map->cells[c], col);
+        else     expand1D2D(map1D2D, i, vW, vH, [&](int x, int y, unsigned) { setPixelColorXY(x, y, col); });
         break;
+      }
       case M12_sPinwheel: {
-        // Uses Bresenham's algorithm to place coordinates of two lines in arrays then draws between them
-        int startX, startY, cosVal[2], sinVal[2]; // in fixed point scale
-        setPinwheelParameters(i, vW, vH, startX, startY, cosVal, sinVal);
-
-        unsigned maxLineLength = max(vW, vH) + 2; // pixels drawn is always smaller than dx or dy, +1 pair for rounding errors
-        uint16_t lineCoords[2][maxLineLength];    // uint16_t to save ram
-        int lineLength[2] = {0};
-
+        // draws the pixels between two lines (rays), lines shared with the previously drawn (adjacent) ray are not drawn again
         static int prevRays[2] = {INT_MAX, INT_MAX}; // previous two ray numbers
-        int closestEdgeIdx = INT_MAX; // index of the closest edge pixel
-
-        for (int lineNr = 0; lineNr < 2; lineNr++) {
-          int x0 = startX; // x, y coordinates in fixed scale
-          int y0 = startY;
-          int x1 = (startX + (cosVal[lineNr] << 9)); // outside of grid
-          int y1 = (startY + (sinVal[lineNr] << 9)); // outside of grid
-          const int dx =  abs(x1-x0), sx = x0<x1 ? 1 : -1; // x distance & step
-          const int dy = -abs(y1-y0), sy = y0<y1 ? 1 : -1; // y distance & step
-          uint16_t* coordinates = lineCoords[lineNr]; // 1D access is faster
-          int* length = &lineLength[lineNr];          // faster access
-          x0 /= Fixed_Scale; // convert to pixel coordinates
-          y0 /= Fixed_Scale;
-
-          // Bresenham's algorithm
-          int idx = 0;
-          int err = dx + dy;
-          while (true) {
-            if ((unsigned)x0 >= (unsigned)vW || (unsigned)y0 >= (unsigned)vH) {
-              closestEdgeIdx = min(closestEdgeIdx, idx-2);
-              break; // stop if outside of grid (exploit unsigned int overflow)
-            }
-            coordinates[idx++] = x0;
-            coordinates[idx++] = y0;
-            (*length)++;
-            // note: since endpoint is out of grid, no need to check if endpoint is reached
-            int e2 = 2 * err;
-            if (e2 >= dy) { err += dy; x0 += sx; }
-            if (e2 <= dx) { err += dx; y0 += sy; }
-          }
-        }
-
-        // fill up the shorter line with missing coordinates, so block filling works correctly and efficiently
-        int diff = lineLength[0] - lineLength[1];
-        int longLineIdx = (diff > 0) ? 0 : 1;
-        int shortLineIdx = longLineIdx ? 0 : 1;
-        if (diff != 0) {
-          int idx = (lineLength[shortLineIdx] - 1) * 2; // last valid coordinate index
-          int lastX = lineCoords[shortLineIdx][idx++];
-          int lastY = lineCoords[shortLineIdx][idx++];
-          bool keepX = lastX == 0 || lastX == vW - 1;
-          for (int d = 0; d < abs(diff); d++) {
-            lineCoords[shortLineIdx][idx] = keepX ? lastX :lineCoords[longLineIdx][idx];
-            idx++;
-            lineCoords[shortLineIdx][idx] =  keepX ? lineCoords[longLineIdx][idx] : lastY;
-            idx++;
-          }
-        }
-
-        // draw and block-fill the line coordinates. Note: block filling only efficient if angle between lines is small
-        closestEdgeIdx += 2;
         int max_i = getPinwheelLength(vW, vH) - 1;
         bool drawFirst = !(prevRays[0] == i - 1 || (i == 0 && prevRays[0] == max_i)); // draw first line if previous ray was not adjacent including wrap
         bool drawLast  = !(prevRays[0] == i + 1 || (i == max_i && prevRays[0] == 0)); // same as above for last line
-        for (int idx = 0; idx < lineLength[longLineIdx] * 2;) { //!! should be long line idx!
-          int x1 = lineCoords[0][idx];
-          int x2 = lineCoords[1][idx++];
-          int y1 = lineCoords[0][idx];
-          int y2 = lineCoords[1][idx++];
-          int minX, maxX, minY, maxY;
-          (x1 < x2) ? (minX = x1, maxX = x2) : (minX = x2, maxX = x1);
-          (y1 < y2) ? (minY = y1, maxY = y2) : (minY = y2, maxY = y1);
-
-          // fill the block between the two x,y points
-          bool alwaysDraw = (drawFirst && drawLast) || // No adjacent rays, draw all pixels
-                            (idx > closestEdgeIdx)  || // Edge pixels on uneven lines are always drawn
-                            (i == 0 && idx == 2)    || // Center pixel special case
-                            (i == prevRays[1]);        // Effect drawing twice in 1 frame
-          for (int x = minX; x <= maxX; x++) {
-            for (int y = minY; y <= maxY; y++) {
-              bool onLine1 = x == x1 && y == y1;
-              bool onLine2 = x == x2 && y == y2;
-              if ((alwaysDraw) ||
-                  (!onLine1 && (!onLine2 || drawLast))  || // Middle pixels and line2 if drawLast
-                  (!onLine2 && (!onLine1 || drawFirst))    // Middle pixels and line1 if drawFirst
-                ) {
-                setPixelColorXY(x, y, col);
-              }
-            }
+        bool drawAll   = (drawFirst && drawLast) || // No adjacent rays, draw all pixels
+                         (i == prevRays[1]);        // Effect drawing twice in 1 frame
+        const ExpansionMap *map = getExpansionMap();
+        if (map) {
+          const uint32_t *start = &map->start[i * PW_GROUPS];
+          const auto drawCells = [&](unsigned from, unsigned to) { for (unsigned c = from; c < to; c++) setPixelColorRaw(map->cells[c], col); };
+          if (drawAll) drawCells(start[PW_CORE], start[PW_GROUPS]);
+          else {
+            drawCells(start[PW_CORE], start[PW_FIRST]);
+            if (drawFirst) drawCells(start[PW_FIRST], start[PW_LAST]);                         // first line and pixels shared by both lines
+            if (drawLast)  drawCells(start[drawFirst ? PW_LAST : PW_EITHER], start[PW_BOTH]); // last line (and shared pixels if not yet drawn)
           }
+        } else {
+          expand1D2D(map1D2D, i, vW, vH, [&](int x, int y, unsigned group) {
+            if (drawAll || group == PW_CORE || (group == PW_FIRST && drawFirst) || (group == PW_LAST && drawLast))
+              setPixelColorXY(x, y, col);
+          });
         }
         prevRays[1] = prevRays[0];
         prevRays[0] = i;
@@ -958,18 +1112,9 @@ uint32_t WLED_O2_ATTR Segment::getPixelColor(int i) const
         else         y = i;
         break;
       case M12_sPinwheel: {
-        // not 100% accurate, returns pixel at outer edge
-        int cosVal[2], sinVal[2];
-        setPinwheelParameters(i, vW, vH, x, y, cosVal, sinVal, true);
-        int maxX = (vW-1) * Fixed_Scale;
-        int maxY = (vH-1) * Fixed_Scale;
-        // trace ray from center until we hit any edge - to avoid rounding problems, we use fixed point coordinates
-        while ((x < maxX)  && (y < maxY) && (x > Fixed_Scale) && (y > Fixed_Scale)) {
-          x += cosVal[0]; // advance to next position
-          y += sinVal[0];
-        }
-        x /= Fixed_Scale;
-        y /= Fixed_Scale;
+        const ExpansionMap *map = getExpansionMap();
+        if (map) return map->readCell[i] < UINT16_MAX ? getPixelColorRaw(map->readCell[i]) : 0;
+        getPinwheelPixel(i, vW, vH, x, y); // not 100% accurate, returns pixel at outer edge
         break;
       }
     }
@@ -1031,12 +1176,13 @@ void Segment::fade_out(uint8_t rate) const {
   if (!isActive()) return; // not active
   rate = (256-rate) >> 1;
   const int mappedRate = 256 / (rate + 1);
+  const uint32_t background = colors[1]; // local copy, compiler can't know pixel writes do not change colors[]
   const size_t rlength = rawLength();  // calculate only once
   for (unsigned j = 0; j < rlength; j++) {
     uint32_t color = getPixelColorRaw(j);
-    if (color == colors[1]) continue; // already at target color
+    if (color == background) continue; // already at target color
     for (int i = 0; i < 32; i += 8) {
-      uint8_t c2 = (colors[1]>>i);  // get background channel
+      uint8_t c2 = (background>>i); // get background channel
       uint8_t c1 = (color>>i);      // get foreground channel
       // we can't use bitshift since we are using int
       int delta = (c2 - c1) * mappedRate / 256;
@@ -1082,18 +1228,16 @@ void Segment::blur(uint8_t blur_amount, bool smear) const {
   uint8_t seep = blur_amount >> 1;
   unsigned vlength = vLength();
   // handle first pixel to avoid conditional in loop (faster)
-  uint32_t cur = getPixelColorRaw(0);
-  uint32_t carryover = fast_color_scale(cur, seep);
-  setPixelColorRaw(0, fast_color_scale(cur, keep));
+  uint32_t carryover = fast_color_scale(pixels[0], seep);
+  uint32_t last = fast_color_scale(pixels[0], keep); // current pixel is written when its right neighbour has been added
   for (unsigned i = 1; i < vlength; i++) {
-    cur = getPixelColorRaw(i);
+    uint32_t cur = pixels[i];
     uint32_t part = fast_color_scale(cur, seep);
-    cur = fast_color_scale(cur, keep);
-    cur = color_add(cur, carryover);
-    setPixelColorRaw(i - 1, color_add(getPixelColorRaw(i - 1), part)); // previous pixel
-    setPixelColorRaw(i, cur); // current pixel
+    pixels[i - 1] = fast_color_add(last, part); // previous pixel
+    last = fast_color_add(fast_color_scale(cur, keep), carryover);
     carryover = part;
   }
+  pixels[vlength - 1] = last;
 }
 
 /*
@@ -1135,7 +1279,8 @@ uint32_t Segment::color_from_palette(uint16_t i, bool mapping, bool moving, uint
     case 1: blend = LINEARBLEND; break;
     case 2: blend = LINEARBLEND_NOWRAP; break;
   }
-  CRGBW palcol = ColorFromPalette(_currentPalette, paletteIndex, pbri, blend);
+  CRGBW palcol = _currentPaletteExpanded && blend != NOBLEND ? ColorFromExpandedPalette(_currentPaletteExpanded, paletteIndex, pbri, blend)
+                                                            : ColorFromPalette(_currentPalette, paletteIndex, pbri, blend);
   palcol.w = W(color);
 
   return palcol.color32;
@@ -1322,6 +1467,7 @@ void WS2812FX::service() {
   if (doShow && !_suspend) {
     yield();
     Segment::handleRandomPalette(); // slowly transition random palette; move it into for loop when each segment has individual random palette
+    releaseNoiseFields(3000);       // free cached noise fields of effects that are no longer running
     _lastServiceShow = nowUp; // update timestamp, for precise FPS control
     show();
   }
@@ -1968,14 +2114,63 @@ void WS2812FX::printSize() {
 }
 #endif
 
-// load custom mapping table from JSON file (called from finalizeInit() or deserializeState())
+/*
+ * Binary ledmap (ledmapN.lmb) generated from ledmapN.json on first use
+ * header (20 bytes): magic "LMB1", uint16 width, uint16 height (0 if not specified), uint32 entry count, uint32 size of JSON source,
+ * uint32 LED count at the time of conversion, followed by uint16 entries (0xFFFF = no LED)
+ * file is regenerated if JSON source size changes or if it was truncated to fewer LEDs than currently configured
+ */
+#define LEDMAP_BIN_MAGIC 0x31424D4C // "LMB1"
+
+typedef struct LedmapHeader {
+  uint32_t magic;
+  uint16_t width;
+  uint16_t height;
+  uint32_t count;
+  uint32_t jsonSize;
+  uint32_t limit;     // number of LEDs when converted (entries beyond it are not stored)
+} lmbh;
+
+// true if ledmap contains all entries needed for current LED count
+static inline bool isLedmapComplete(const LedmapHeader &h, unsigned length) {
+  return h.count < h.limit || length <= h.limit;
+}
+
+#if WLED_LEDMAP_CACHE_SIZE > 0
+// most recently used ledmaps in PSRAM, switching ledmaps (i.e. in a playlist) does not access file system
+typedef struct LedmapCacheEntry {
+  uint16_t     *table;  // nullptr if unused
+  LedmapHeader  header;
+  unsigned long used;   // millis() of last use (LRU)
+  uint8_t       n;
+  uint8_t       generation;
+} lmce;
+static LedmapCacheEntry ledmapCache[WLED_LEDMAP_CACHE_SIZE];
+static volatile uint8_t ledmapCacheGeneration = 0; // incremented when any ledmap is modified (entries are released in loop context)
+#endif
+
+static void getLedmapFileName(char *fileName, unsigned n, bool binary) {
+  strcpy_P(fileName, PSTR("/ledmap"));
+  if (n) sprintf(fileName +7, "%d", n);
+  strcat_P(fileName, binary ? PSTR(".lmb") : PSTR(".json"));
+}
+
+// removes binary and cached copy of a ledmap (call when ledmapN.json is modified, may be called from web server task)
+void WS2812FX::invalidateMap(unsigned n) {
+  char fileName[32];
+  getLedmapFileName(fileName, n, true);
+  if (WLED_FS.exists(fileName)) WLED_FS.remove(fileName);
+  #if WLED_LEDMAP_CACHE_SIZE > 0
+  ledmapCacheGeneration++;
+  #endif
+}
+
+// load custom mapping table from binary or JSON file (called from finalizeInit() or deserializeState())
 // if this is a matrix set-up and default ledmap.json file does not exist, create mapping table using setUpMatrix() from panel information
 // WARNING: effect drawing has to be suspended (strip.suspend()) or must be called from loop() context
 bool WS2812FX::deserializeMap(unsigned n) {
   char fileName[32];
-  strcpy_P(fileName, PSTR("/ledmap"));
-  if (n) sprintf(fileName +7, "%d", n);
-  strcat_P(fileName, PSTR(".json"));
+  getLedmapFileName(fileName, n, false);
   bool isFile = WLED_FS.exists(fileName);
 
   customMappingSize = 0; // prevent use of mapping if anything goes wrong
@@ -1988,77 +2183,154 @@ bool WS2812FX::deserializeMap(unsigned n) {
     return false;
   }
 
-  if (!isFile || !requestJSONBufferLock(JSON_LOCK_LEDMAP)) return false;
+  if (!isFile) return false;
 
-  StaticJsonDocument<64> filter;
-  filter[F("width")]  = true;
-  filter[F("height")] = true;
-  if (!readObjectFromFile(fileName, nullptr, pDoc, &filter)) {
-    DEBUG_PRINTF_P(PSTR("ERROR Invalid ledmap in %s\n"), fileName);
-    releaseJSONBufferLock();
-    return false; // if file does not load properly then exit
-  } else
-    DEBUG_PRINTF_P(PSTR("Reading LED map from %s\n"), fileName);
+  d_free(customMappingTable);
+  customMappingTable = static_cast<uint16_t*>(d_malloc(sizeof(uint16_t)*getLengthTotal())); // prefer DRAM for speed
+  if (!customMappingTable) {
+    DEBUG_PRINTLN(F("ERROR LED map allocation error."));
+    return false;
+  }
+  DEBUG_PRINTF_P(PSTR("ledmap allocated: %uB\n"), sizeof(uint16_t)*getLengthTotal());
 
-  JsonObject root = pDoc->as<JsonObject>();
-  // if we are loading default ledmap (at boot) set matrix width and height from the ledmap (compatible with WLED MM ledmaps)
-  if (n == 0 && (!root[F("width")].isNull() || !root[F("height")].isNull())) {
-    Segment::maxWidth  = min(max(root[F("width")].as<int>(), 1), 255);
-    Segment::maxHeight = min(max(root[F("height")].as<int>(), 1), 255);
-    isMatrix = true;
-    DEBUG_PRINTF_P(PSTR("LED map width=%d, height=%d\n"), Segment::maxWidth, Segment::maxHeight);
+  LedmapHeader header = {0, 0, 0, 0, 0, 0};
+  bool loaded = false;
+
+  // size of JSON source is used to detect stale binary/cached copies (i.e. file replaced using /edit)
+  File f = WLED_FS.open(fileName, "r");
+  uint32_t jsonSize = f ? f.size() : 0;
+  f.close();
+
+  #if WLED_LEDMAP_CACHE_SIZE > 0
+  for (auto &e : ledmapCache) if (e.table && e.generation != ledmapCacheGeneration) {
+    p_free(e.table);
+    e.table = nullptr;
+  }
+  for (auto &e : ledmapCache) if (e.table && e.n == n && e.header.jsonSize == jsonSize && isLedmapComplete(e.header, getLengthTotal())) {
+    header = e.header;
+    customMappingSize = min(header.count, (uint32_t)getLengthTotal());
+    memcpy(customMappingTable, e.table, customMappingSize * sizeof(uint16_t));
+    e.used = millis();
+    loaded = true;
+    DEBUG_PRINTF_P(PSTR("Using cached LED map %u\n"), n);
+    break;
   }
+  #endif
 
-  d_free(customMappingTable);
-  customMappingTable = static_cast<uint16_t*>(d_malloc(sizeof(uint16_t)*getLengthTotal())); // prefer DRAM for speed
+  if (!loaded) {
+    // binary ledmap: single read of the whole table
+    char binName[32];
+    getLedmapFileName(binName, n, true);
+    uint32_t readStart = micros();
+    f = WLED_FS.open(binName, "r");
+    if (f) {
+      if (f.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header) && header.magic == LEDMAP_BIN_MAGIC && header.jsonSize == jsonSize && isLedmapComplete(header, getLengthTotal())) {
+        size_t count = min(header.count, (uint32_t)getLengthTotal());
+        if (f.read(reinterpret_cast<uint8_t*>(customMappingTable), count * sizeof(uint16_t)) == count * sizeof(uint16_t)) {
+          customMappingSize = count;
+          loaded = true;
+          DEBUG_PRINTF_P(PSTR("Reading LED map from %s\n"), binName);
+        }
+      }
+      accountFileRead(f.position(), micros() - readStart);
+      f.close();
+    }
 
-  if (customMappingTable) {
-    DEBUG_PRINTF_P(PSTR("ledmap allocated: %uB\n"), sizeof(uint16_t)*getLengthTotal());
-    File f = WLED_FS.open(fileName, "r");
-    f.find("\"map\":[");
-    while (f.available()) { // f.position() < f.size() - 1
-      char number[32];
-      size_t numRead = f.readBytesUntil(',', number, sizeof(number)-1); // read a single number (may include array terminating "]" but not number separator ',')
-      number[numRead] = 0;
-      if (numRead > 0) {
-        char *end = strchr(number,']'); // we encountered end of array so stop processing if no digit found
-        bool foundDigit = (end == nullptr);
-        int i = 0;
-        if (end != nullptr) do {
-          if (number[i] >= '0' && number[i] <= '9') foundDigit = true;
-          if (foundDigit || &number[i++] == end) break;
-        } while (i < 32);
-        if (!foundDigit) break;
-        int index = atoi(number);
-        if (index < 0 || index > 65535) index = 0xFFFF; // prevent integer wrap around
-        customMappingTable[customMappingSize++] = index;
-        if (customMappingSize >= getLengthTotal()) break;
-      } else break; // there was nothing to read, stop
+    if (!loaded) {
+      if (!requestJSONBufferLock(JSON_LOCK_LEDMAP)) return false;
+
+      StaticJsonDocument<64> filter;
+      filter[F("width")]  = true;
+      filter[F("height")] = true;
+      if (!readObjectFromFile(fileName, nullptr, pDoc, &filter)) {
+        DEBUG_PRINTF_P(PSTR("ERROR Invalid ledmap in %s\n"), fileName);
+        releaseJSONBufferLock();
+        return false; // if file does not load properly then exit
+      } else
+        DEBUG_PRINTF_P(PSTR("Reading LED map from %s\n"), fileName);
+
+      JsonObject root = pDoc->as<JsonObject>();
+      header.magic    = LEDMAP_BIN_MAGIC;
+      header.width    = root[F("width")]  | 0;
+      header.height   = root[F("height")] | 0;
+      header.jsonSize = jsonSize;
+      header.limit    = getLengthTotal();
+      releaseJSONBufferLock();
+
+      readStart = micros();
+      f = WLED_FS.open(fileName, "r");
+      f.find("\"map\":[");
+      while (f.available()) { // f.position() < f.size() - 1
+        char number[32];
+        size_t numRead = f.readBytesUntil(',', number, sizeof(number)-1); // read a single number (may include array terminating "]" but not number separator ',')
+        number[numRead] = 0;
+        if (numRead > 0) {
+          char *end = strchr(number,']'); // we encountered end of array so stop processing if no digit found
+          bool foundDigit = (end == nullptr);
+          int i = 0;
+          if (end != nullptr) do {
+            if (number[i] >= '0' && number[i] <= '9') foundDigit = true;
+            if (foundDigit || &number[i++] == end) break;
+          } while (i < 32);
+          if (!foundDigit) break;
+          int index = atoi(number);
+          if (index < 0 || index > 65535) index = 0xFFFF; // prevent integer wrap around
+          customMappingTable[customMappingSize++] = index;
+          if (customMappingSize >= getLengthTotal()) break;
+        } else break; // there was nothing to read, stop
+      }
+      accountFileRead(f.position(), micros() - readStart);
+      f.close();
+      header.count = customMappingSize;
+
+      // store binary ledmap for next time
+      f = WLED_FS.open(binName, "w");
+      if (f) {
+        f.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+        f.write(reinterpret_cast<const uint8_t*>(customMappingTable), customMappingSize * sizeof(uint16_t));
+        f.close();
+      }
     }
-    currentLedmap = n;
-    f.close();
-
-    #ifdef WLED_DEBUG
-    DEBUG_PRINT(F("Loaded ledmap:"));
-    for (unsigned i=0; i<customMappingSize; i++) {
-      if (!(i%Segment::maxWidth)) DEBUG_PRINTLN();
-      DEBUG_PRINTF_P(PSTR("%4d,"), customMappingTable[i] < 0xFFFFU ? customMappingTable[i] : -1);
+
+    #if WLED_LEDMAP_CACHE_SIZE > 0
+    // keep a copy in PSRAM, replacing least recently used
+    LedmapCacheEntry *lru = &ledmapCache[0];
+    for (auto &e : ledmapCache) {
+      if (!e.table || e.n == n) { lru = &e; break; } // unused or outdated copy of this ledmap
+      if (e.used < lru->used) lru = &e;
     }
-    DEBUG_PRINTLN();
-    #endif
-/*
-    JsonArray map = root[F("map")];
-    if (!map.isNull() && map.size()) {  // not an empty map
-      customMappingSize = min((unsigned)map.size(), (unsigned)getLengthTotal());
-      for (unsigned i=0; i<customMappingSize; i++) customMappingTable[i] = (uint16_t) (map[i]<0 ? 0xFFFFU : map[i]);
-      currentLedmap = n;
+    p_free(lru->table);
+    lru->table = static_cast<uint16_t*>(p_malloc(customMappingSize * sizeof(uint16_t)));
+    if (lru->table) {
+      memcpy(lru->table, customMappingTable, customMappingSize * sizeof(uint16_t));
+      lru->header = header;
+      lru->header.count = customMappingSize;
+      lru->header.limit = min(header.limit, (uint32_t)getLengthTotal()); // table may have been truncated, it is not complete for longer strips
+      lru->n = n;
+      lru->generation = ledmapCacheGeneration;
+      lru->used = millis();
     }
-*/
-  } else {
-    DEBUG_PRINTLN(F("ERROR LED map allocation error."));
+    #endif
   }
 
-  releaseJSONBufferLock();
+  // if we are loading default ledmap (at boot) set matrix width and height from the ledmap (compatible with WLED MM ledmaps)
+  if (n == 0 && (header.width || header.height)) {
+    Segment::maxWidth  = min(max((int)header.width, 1), 255);
+    Segment::maxHeight = min(max((int)header.height, 1), 255);
+    isMatrix = true;
+    DEBUG_PRINTF_P(PSTR("LED map width=%d, height=%d\n"), Segment::maxWidth, Segment::maxHeight);
+  }
+  currentLedmap = n;
+
+  #ifdef WLED_DEBUG
+  DEBUG_PRINT(F("Loaded ledmap:"));
+  for (unsigned i=0; i<customMappingSize; i++) {
+    if (!(i%Segment::maxWidth)) DEBUG_PRINTLN();
+    DEBUG_PRINTF_P(PSTR("%4d,"), customMappingTable[i] < 0xFFFFU ? customMappingTable[i] : -1);
+  }
+  DEBUG_PRINTLN();
+  #endif
+
   return (customMappingSize > 0);
 }
 
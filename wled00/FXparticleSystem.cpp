@@ -575,13 +575,9 @@ void ParticleSystem2D::render() {
   }
 
   if (motionBlur) { // motion-blurring active
-    for (int32_t y = 0; y <= maxYpixel; y++) {
-      int index = y * (maxXpixel + 1);
-      for (int32_t x = 0; x <= maxXpixel; x++) {
-        framebuffer[index] = fast_color_scale(framebuffer[index], motionBlur); // note: could skip if only globalsmear is active but usually they are both active and scaling is fast enough
-        index++;
-      }
-    }
+    const int pixels = (maxXpixel + 1) * (maxYpixel + 1); // rows are contiguous, scale the whole buffer in one pass
+    for (int index = 0; index < pixels; index++)
+      framebuffer[index] = fast_color_scale(framebuffer[index], motionBlur); // note: could skip if only globalsmear is active but usually they are both active and scaling is fast enough
   }
   else { // no blurring: clear buffer
     memset(framebuffer, 0, (maxXpixel+1) * (maxYpixel+1) * sizeof(CRGBW));
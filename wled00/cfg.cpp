@@ -42,8 +42,77 @@ void getStringFromJson(char* dest, const char* src, size_t len) {
   if (src != nullptr) strlcpy(dest, src, len);
 }
 
+// creates bus configuration from a single hw.led.ins element, s counts physical buses
+static void deserializeBusConfig(JsonObject elm, unsigned total, int &s) {
+  uint8_t pins[OUTPUT_MAX_PINS] = {255, 255, 255, 255, 255};
+  JsonArray pinArr = elm["pin"];
+  if (pinArr.size() == 0) return;
+  //pins[0] = pinArr[0];
+  unsigned i = 0;
+  for (int p : pinArr) {
+    pins[i++] = p;
+    if (i>4) break;
+  }
+  uint16_t length = elm["len"] | 1;
+  uint8_t colorOrder = (int)elm[F("order")]; // contains white channel swap option in upper nibble
+  uint8_t skipFirst = elm[F("skip")];
+  uint16_t start = elm["start"] | 0;
+  if (length==0 || start + length > MAX_LEDS) return; // zero length or we reached max. number of LEDs, just stop
+  uint8_t ledType = elm["type"] | TYPE_WS2812_RGB;
+  bool reversed = elm["rev"];
+  bool refresh = elm["ref"] | false;
+  uint16_t freqkHz = elm[F("freq")] | 0;  // will be in kHz for DotStar and Hz for PWM
+  uint8_t AWmode = elm[F("rgbwm")] | RGBW_MODE_MANUAL_ONLY;
+  uint8_t maPerLed = elm[F("ledma")] | LED_MILLIAMPS_DEFAULT;
+  uint16_t maMax = elm[F("maxpwr")] | (BusManager::ablMilliampsMax() * length) / total; // rough (incorrect?) per strip ABL calculation when no config exists
+  // To disable brightness limiter we either set output max current to 0 or single LED current to 0 (we choose output max current)
+  if (Bus::isPWM(ledType) || Bus::isOnOff(ledType) || Bus::isVirtual(ledType)) { // analog and virtual
+    maPerLed = 0;
+    maMax = 0;
+  }
+  ledType |= refresh << 7; // hack bit 7 to indicate strip requires off refresh
+
+  String host = elm[F("text")] | String();
+  busConfigs.emplace_back(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, maPerLed, maMax, host);
+  doInitBusses = true;  // finalization done in beginStrip()
+  if (!Bus::isVirtual(ledType)) s++; // have as many virtual buses as you want
+}
+
+// cfg.json offset of hw.led.ins array contents, set by deserializeConfigFromFS() if the array was excluded from JSON buffer
+static size_t cfgBusesOffset = 0;
+
+// reads hw.led.ins array from cfg.json one bus at a time so that only a single bus definition is held in memory
+static bool deserializeBusesFromFS(unsigned total) {
+  File f = WLED_FS.open(FPSTR(s_cfg_json), "r");
+  if (!f || !f.seek(cfgBusesOffset)) return false;
+  f.setTimeout(0); // do not wait at EOF
+  StaticJsonDocument<768> bus;
+  int s = 0;  // bus iterator
+  for (int c = f.peek(); c >= 0 && c != ']'; c = f.peek()) {
+    if (c != '{') { f.read(); continue; } // skip separators
+    if (deserializeJson(bus, f) || s >= WLED_MAX_BUSSES) break; // only counts physical buses
+    deserializeBusConfig(bus.as<JsonObject>(), total, s);
+  }
+  f.close();
+  DEBUG_PRINTF_P(PSTR("Streamed %d buses from cfg.json\n"), s);
+  return true;
+}
+
+// locates hw.led.ins array in cfg.json as written by serializeConfig()
+// returns offset of first array element or 0 if not found (e.g. file was edited by hand) in which case entire file is parsed
+static size_t locateBusesInFS() {
+  File f = WLED_FS.open(FPSTR(s_cfg_json), "r");
+  if (!f) return 0;
+  f.setTimeout(0); // do not wait at EOF
+  size_t pos = 0;
+  if (f.find("\"hw\":{\"led\":{") && f.find("\"ins\":[")) pos = f.position();
+  f.close();
+  return pos;
+}
+
 bool deserializeConfig(JsonObject doc, bool fromFS) {
   bool needsSave = false;
+  configVersion++; // invalidate cached /json/info
   //int rev_major = doc["rev"][0]; // 1
   //int rev_minor = doc["rev"][1]; // 0
 
@@ -219,39 +288,10 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
     int s = 0;  // bus iterator
     for (JsonObject elm : ins) {
       if (s >= WLED_MAX_BUSSES) break; // only counts physical buses
-      uint8_t pins[OUTPUT_MAX_PINS] = {255, 255, 255, 255, 255};
-      JsonArray pinArr = elm["pin"];
-      if (pinArr.size() == 0) continue;
-      //pins[0] = pinArr[0];
-      unsigned i = 0;
-      for (int p : pinArr) {
-        pins[i++] = p;
-        if (i>4) break;
-      }
-      uint16_t length = elm["len"] | 1;
-      uint8_t colorOrder = (int)elm[F("order")]; // contains white channel swap option in upper nibble
-      uint8_t skipFirst = elm[F("skip")];
-      uint16_t start = elm["start"] | 0;
-      if (length==0 || start + length > MAX_LEDS) continue; // zero length or we reached max. number of LEDs, just stop
-      uint8_t ledType = elm["type"] | TYPE_WS2812_RGB;
-      bool reversed = elm["rev"];
-      bool refresh = elm["ref"] | false;
-      uint16_t freqkHz = elm[F("freq")] | 0;  // will be in kHz for DotStar and Hz for PWM
-      uint8_t AWmode = elm[F("rgbwm")] | RGBW_MODE_MANUAL_ONLY;
-      uint8_t maPerLed = elm[F("ledma")] | LED_MILLIAMPS_DEFAULT;
-      uint16_t maMax = elm[F("maxpwr")] | (ablMilliampsMax * length) / total; // rough (incorrect?) per strip ABL calculation when no config exists
-      // To disable brightness limiter we either set output max current to 0 or single LED current to 0 (we choose output max current)
-      if (Bus::isPWM(ledType) || Bus::isOnOff(ledType) || Bus::isVirtual(ledType)) { // analog and virtual
-        maPerLed = 0;
-        maMax = 0;
-      }
-      ledType |= refresh << 7; // hack bit 7 to indicate strip requires off refresh
-
-      String host = elm[F("text")] | String();
-      busConfigs.emplace_back(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, maPerLed, maMax, host);
-      doInitBusses = true;  // finalization done in beginStrip()
-      if (!Bus::isVirtual(ledType)) s++; // have as many virtual buses as you want
+      deserializeBusConfig(elm, total, s);
     }
+  } else if (fromFS && cfgBusesOffset && deserializeBusesFromFS(total)) {
+    // buses were read directly from cfg.json
   } else if (fromFS) {
     //if busses failed to load, add default (fresh install, FS issue, ...)
     BusManager::removeAll();
@@ -806,20 +846,45 @@ bool deserializeConfigFromFS() {
 
   DEBUG_PRINTLN(F("Reading settings from /cfg.json..."));
 
-  success = readObjectFromFile(s_cfg_json, nullptr, pDoc);
+  // LED bus definitions are excluded from JSON buffer and streamed by deserializeConfig() one bus at a time
+  cfgBusesOffset = locateBusesInFS();
+  if (cfgBusesOffset) {
+    StaticJsonDocument<192> filter;
+    filter["*"] = true;
+    JsonObject hw = filter.createNestedObject("hw");
+    hw["*"] = true;
+    JsonObject led = hw.createNestedObject("led");
+    led["*"] = true;
+    led.createNestedObject("ins"); // object filter skips array
+    success = readObjectFromFile(s_cfg_json, nullptr, pDoc, &filter);
+  } else
+    success = readObjectFromFile(s_cfg_json, nullptr, pDoc);
 
   // NOTE: This routine deserializes *and* applies the configuration
   //       Therefore, must also initialize ethernet from this function
   JsonObject root = pDoc->as<JsonObject>();
   bool needsSave = deserializeConfig(root, true);
+  cfgBusesOffset = 0;
   releaseJSONBufferLock();
 
   return needsSave;
 }
 
+// writes serialized JSON document using background writer (temporary file + rename), returns false if not possible
+static bool writeConfigInBackground(const char *file, bool backup) {
+  #ifdef ARDUINO_ARCH_ESP32
+  size_t len = measureJson(*pDoc);
+  char *data = static_cast<char*>(p_malloc(len + 1));
+  if (!data) return false;
+  serializeJson(*pDoc, data, len + 1);
+  if (writeFileInBackground(file, data, len, backup)) return true;
+  p_free(data);
+  #endif
+  return false;
+}
+
 void serializeConfigToFS() {
   serializeConfigSec();
-  backupConfig(); // backup before writing new config
 
   DEBUG_PRINTLN(F("Writing settings to /cfg.json..."));
 
@@ -829,9 +894,12 @@ void serializeConfigToFS() {
 
   serializeConfig(root);
 
-  File f = WLED_FS.open(FPSTR(s_cfg_json), "w");
-  if (f) serializeJson(root, f);
-  f.close();
+  if (!writeConfigInBackground(s_cfg_json, true)) {
+    backupConfig(); // backup before writing new config
+    File f = WLED_FS.open(FPSTR(s_cfg_json), "w");
+    if (f) serializeJson(root, f);
+    f.close();
+  }
   releaseJSONBufferLock();
 
   configNeedsWrite = false;
@@ -1363,8 +1431,10 @@ void serializeConfigSec() {
   ota[F("aota")] = aOtaEnabled;
   #endif
 
-  File f = WLED_FS.open(FPSTR(s_wsec_json), "w");
-  if (f) serializeJson(root, f);
-  f.close();
+  if (!writeConfigInBackground(s_wsec_json, false)) {
+    File f = WLED_FS.open(FPSTR(s_wsec_json), "w");
+    if (f) serializeJson(root, f);
+    f.close();
+  }
   releaseJSONBufferLock();
 }
@@ -53,7 +53,8 @@ uint32_t WLED_O2_ATTR color_add(uint32_t c1, uint32_t c2, bool preserveCR) //121
     // example without overflow: input: 0x007F007F -> (0x00000000 - 0x00000000) = 0x00000000 -> input|0x00000000 = input  (no change)
     rb |= ((rb & 0x01000100) - ((rb >> 8) & 0x00010001)) & 0x00FF00FF;
     wg |= ((wg & 0x01000100) - ((wg >> 8) & 0x00010001)) & 0x00FF00FF;
-    wg <<= 8; // restore WG position
+    rb &= TWO_CHANNEL_MASK;            // drop carry bits, they would leak into G and W
+    wg = (wg & TWO_CHANNEL_MASK) << 8; // restore WG position
   }
   return rb | wg;
 }
@@ -130,6 +131,89 @@ uint32_t ColorFromPaletteWLED(const CRGBPalette16& pal, unsigned index, uint8_t
   return RGBW32(red1,green1,blue1,0);
 }
 
+// same result as ColorFromPaletteWLED() using 256 entry expansion of a palette (see loadFixedPalette()), NOBLEND is not supported
+uint32_t ColorFromExpandedPalette(const uint32_t *expanded, unsigned index, uint8_t brightness, TBlendType blendType) {
+  if (blendType == LINEARBLEND_NOWRAP) {
+    index = (index * 0xF0) >> 8; // same remapping as ColorFromPaletteWLED()
+  }
+  uint32_t color = expanded[byte(index)];
+  if (brightness < 255) {
+    uint32_t scale = brightness + 1; // adjust for rounding (bitshift)
+    color = RGBW32((R(color) * scale) >> 8, (G(color) * scale) >> 8, (B(color) * scale) >> 8, 0);
+  }
+  return color;
+}
+
+/*
+ * Palette table
+ * Fixed palettes that do not depend on segment colors (default, FastLED and gradient palettes) are decoded on first use
+ * and kept together with their 256 entry expansion (in PSRAM if available), so that loading a palette is a copy and
+ * color lookup is a single table access (see Segment::color_from_palette()). Least recently used entries are replaced
+ * if more palettes are in use than WLED_PALETTE_TABLE_SIZE, unless the entry was used in the same frame (the table would
+ * thrash, palette is decoded directly instead). Entries are immutable and only replaced from loop context.
+ * Custom palettes are not included as they may change at any time (i.e. audio reactive palettes).
+ */
+static void decodeFixedPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
+  if (pal < DYNAMIC_PALETTE_COUNT) {
+    targetPalette = PartyColors_p; // default palette
+  } else if (pal < DYNAMIC_PALETTE_COUNT + FASTLED_PALETTE_COUNT) { // palette 6 - 12, fastled palettes
+    targetPalette = *fastledPalettes[pal - DYNAMIC_PALETTE_COUNT];
+  } else {
+    byte tcp[72];
+    memcpy_P(tcp, (byte*)pgm_read_dword(&(gGradientPalettes[pal - (DYNAMIC_PALETTE_COUNT + FASTLED_PALETTE_COUNT)])), sizeof(tcp));
+    targetPalette.loadDynamicGradientPalette(tcp);
+  }
+}
+
+#if WLED_PALETTE_TABLE_SIZE > 0
+struct PaletteTableEntry {
+  CRGBPalette16 palette;
+  uint32_t      expanded[256]; // ColorFromPaletteWLED(palette, i, 255, LINEARBLEND)
+  unsigned long used;          // strip.now of last use (frame, for eviction)
+  uint8_t       id;
+};
+static PaletteTableEntry *paletteTable[WLED_PALETTE_TABLE_SIZE];
+
+static PaletteTableEntry *getPaletteTableEntry(uint8_t pal) {
+  PaletteTableEntry **slot = &paletteTable[0];
+  for (auto &e : paletteTable) {
+    if (e && e->id == pal) {
+      e->used = strip.now;
+      return e;
+    }
+    if (!e) slot = &e;
+    else if (*slot && e->used < (*slot)->used) slot = &e;
+  }
+  if (*slot && (*slot)->used == strip.now) return nullptr; // all entries used in this frame, replacing one would thrash
+  if (!*slot) *slot = static_cast<PaletteTableEntry*>(p_malloc(sizeof(PaletteTableEntry)));
+  if (!*slot) return nullptr;
+  PaletteTableEntry *entry = *slot;
+  decodeFixedPalette(entry->palette, pal);
+  for (unsigned i = 0; i < 256; i++) entry->expanded[i] = ColorFromPaletteWLED(entry->palette, i, 255, LINEARBLEND);
+  entry->used = strip.now;
+  entry->id = pal;
+  return entry;
+}
+#endif
+
+// loads fixed palette (0 = default, 6 and above), if expanded is given palette table is used and expanded is set to
+// 256 entry expansion of palette (nullptr if not available); only render path (loop context) may use palette table
+void loadFixedPalette(CRGBPalette16 &targetPalette, uint8_t pal, const uint32_t **expanded) {
+  #if WLED_PALETTE_TABLE_SIZE > 0
+  if (expanded) {
+    PaletteTableEntry *entry = getPaletteTableEntry(pal);
+    *expanded = entry ? entry->expanded : nullptr;
+    if (entry) {
+      targetPalette = entry->palette;
+      return;
+    }
+  }
+  #else
+  if (expanded) *expanded = nullptr;
+  #endif
+  decodeFixedPalette(targetPalette, pal);
+}
+
 void setRandomColor(byte* rgb)
 {
   lastRandomIndex = get_random_wheel_index(lastRandomIndex);
@@ -249,6 +333,7 @@ void loadCustomPalettes() {
   byte tcp[72]; //support gradient palettes with up to 18 entries
   CRGBPalette16 targetPalette;
   customPalettes.clear(); // start fresh
+  paletteVersion++;       // invalidate cached /json/palx pages
   StaticJsonDocument<1536> pDoc; // barely enough to fit 72 numbers -> TODO: current format uses 214 bytes max per palette, why is this buffer so large?
   unsigned emptyPaletteGap = 0; // count gaps in palette files to stop looking for more (each exists() call takes ~5ms)
   for (int index = 0; index < WLED_MAX_CUSTOM_PALETTES; index++) {
@@ -120,6 +120,8 @@ inline uint32_t color_blend16(uint32_t c1, uint32_t c2, uint16_t b) { return col
 [[gnu::hot, gnu::pure]] uint32_t color_fade(uint32_t c1, uint8_t amount, bool video = false);
 [[gnu::hot, gnu::pure]] uint32_t adjust_color(uint32_t rgb, uint32_t hueShift, uint32_t lighten, uint32_t brighten);
 [[gnu::hot, gnu::pure]] uint32_t ColorFromPaletteWLED(const CRGBPalette16 &pal, unsigned index, uint8_t brightness = (uint8_t)255U, TBlendType blendType = LINEARBLEND);
+[[gnu::hot, gnu::pure]] uint32_t ColorFromExpandedPalette(const uint32_t *expanded, unsigned index, uint8_t brightness = (uint8_t)255U, TBlendType blendType = LINEARBLEND);
+void loadFixedPalette(CRGBPalette16 &targetPalette, uint8_t pal, const uint32_t **expanded = nullptr);
 CRGBPalette16 generateHarmonicRandomPalette(const CRGBPalette16 &basepalette);
 CRGBPalette16 generateRandomPalette();
 void loadCustomPalettes();
@@ -148,6 +150,16 @@ static inline uint32_t fast_color_scale(const uint32_t c, const uint8_t scale) {
   return rb | wg;
 }
 
+// fast saturating add for colors, adds all four channels and clamps them to 255 (inlined color_add() without preserveCR)
+static inline uint32_t fast_color_add(const uint32_t c1, const uint32_t c2) {
+  uint32_t rb = ( c1     & 0x00FF00FF) + ( c2     & 0x00FF00FF); // mask and add two colors at once
+  uint32_t wg = ((c1>>8) & 0x00FF00FF) + ((c2>>8) & 0x00FF00FF);
+  // branchless per-channel saturation to 255 (extract 9th bit, subtract 1 if it is set, mask with 0xFF, input is 0xFF+0xFF=0x1FE max)
+  rb |= ((rb & 0x01000100) - ((rb >> 8) & 0x00010001)) & 0x00FF00FF;
+  wg |= ((wg & 0x01000100) - ((wg >> 8) & 0x00010001)) & 0x00FF00FF;
+  return (rb & 0x00FF00FF) | ((wg & 0x00FF00FF) << 8); // drop carry bits and restore WG position
+}
+
 // palettes
 extern const TProgmemRGBPalette16* const fastledPalettes[];
 extern const uint8_t* const gGradientPalettes[];
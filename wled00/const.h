@@ -133,6 +133,10 @@ static_assert(WLED_MAX_BUSSES <= 32, "WLED_MAX_BUSSES exceeds hard limit");
   #endif
 #endif
 
+#ifndef WLED_MAX_NOISE_FIELDS
+  #define WLED_MAX_NOISE_FIELDS 2 // number of cached 2D noise fields (see getNoiseField())
+#endif
+
 #ifndef WLED_MAX_SEGNAME_LEN
   #ifdef ESP8266
     #define WLED_MAX_SEGNAME_LEN 32
@@ -450,6 +454,17 @@ static_assert(WLED_MAX_BUSSES <= 32, "WLED_MAX_BUSSES exceeds hard limit");
 #define ERR_OVERCURRENT 31  // An attached current sensor has measured a current above the threshold (not implemented)
 #define ERR_UNDERVOLT   32  // An attached voltmeter has measured a voltage below the threshold (not implemented)
 
+// Boot phases (durations reported in /json/info "boot")
+#define BOOT_PHASE_FS       0  // FS mount, boot loop check, config verification
+#define BOOT_PHASE_CFG      1  // reading and applying cfg.json (incl. bus configuration)
+#define BOOT_PHASE_STRIP    2  // beginStrip()
+#define BOOT_PHASE_FINALIZE 3  // strip.finalizeInit() (bus creation, ledmap), part of BOOT_PHASE_STRIP
+#define BOOT_PHASE_UM       4  // usermod setup
+#define BOOT_PHASE_NET      5  // remainder of setup() (WiFi, web server, IR)
+#define BOOT_PHASE_SETUP    6  // entire WLED::setup()
+#define BOOT_PHASE_IF       7  // initInterfaces() after first connection
+#define BOOT_PHASES         8
+
 // JSON buffer lock owners
 #define JSON_LOCK_UNKNOWN        255
 #define JSON_LOCK_CFG_DES          1
@@ -474,6 +489,76 @@ static_assert(WLED_MAX_BUSSES <= 32, "WLED_MAX_BUSSES exceeds hard limit");
 #define JSON_LOCK_LEDGAP          20
 #define JSON_LOCK_LEDMAP_ENUM     21
 #define JSON_LOCK_REMOTE          22
+#define JSON_LOCK_MAX             22 // highest module ID tracked in JSON buffer contention statistics
+
+// Number of additional JSON documents for concurrent serialization (HTTP/WS responses), allocated in PSRAM at boot
+#ifndef WLED_JSON_POOL_SIZE
+  #ifdef BOARD_HAS_PSRAM
+    #define WLED_JSON_POOL_SIZE 2
+  #else
+    #define WLED_JSON_POOL_SIZE 0 // single JSON buffer
+  #endif
+#endif
+#if defined(ESP8266) && WLED_JSON_POOL_SIZE > 0
+  #undef WLED_JSON_POOL_SIZE
+  #define WLED_JSON_POOL_SIZE 0 // ESP8266 always uses single JSON buffer
+#endif
+
+// Number of recently used ledmaps kept in PSRAM (0 disables ledmap cache)
+#ifndef WLED_LEDMAP_CACHE_SIZE
+  #ifdef BOARD_HAS_PSRAM
+    #define WLED_LEDMAP_CACHE_SIZE 4
+  #else
+    #define WLED_LEDMAP_CACHE_SIZE 0
+  #endif
+#endif
+
+// Number of pre-parsed presets kept in RAM for playlist playback (0 disables preset cache)
+#ifndef WLED_PRESET_CACHE_SIZE
+  #ifdef BOARD_HAS_PSRAM
+    #define WLED_PRESET_CACHE_SIZE 16
+  #else
+    #define WLED_PRESET_CACHE_SIZE 0
+  #endif
+#endif
+#if defined(ESP8266) && WLED_PRESET_CACHE_SIZE > 0
+  #undef WLED_PRESET_CACHE_SIZE
+  #define WLED_PRESET_CACHE_SIZE 0
+#endif
+
+// PSRAM used for pre-decoded GIF frames (bytes, 0 disables GIF frame cache), only GIFs up to WLED_GIF_CACHE_MAX_FILE bytes are cached
+#ifndef WLED_GIF_CACHE_SIZE
+  #ifdef BOARD_HAS_PSRAM
+    #define WLED_GIF_CACHE_SIZE 524288
+  #else
+    #define WLED_GIF_CACHE_SIZE 0
+  #endif
+#endif
+#ifndef WLED_GIF_CACHE_MAX_FILE
+  #define WLED_GIF_CACHE_MAX_FILE 65536
+#endif
+#ifndef WLED_GIF_CACHE_ENTRIES
+  #define WLED_GIF_CACHE_ENTRIES 8
+#endif
+#ifndef WLED_GIF_CACHE_RETRY
+  #define WLED_GIF_CACHE_RETRY 10000 // ms until caching of an image that could not be cached is attempted again
+#endif
+
+// PSRAM used for caching frequently read files (bytes, 0 disables file cache), a single file may use up to half of it
+#ifndef WLED_FILE_CACHE_SIZE
+  #ifdef BOARD_HAS_PSRAM
+    #define WLED_FILE_CACHE_SIZE 262144
+  #else
+    #define WLED_FILE_CACHE_SIZE 0
+  #endif
+#endif
+#if defined(ESP8266) && WLED_FILE_CACHE_SIZE > 0
+  #undef WLED_FILE_CACHE_SIZE
+  #define WLED_FILE_CACHE_SIZE 0
+#endif
+#ifndef WLED_FILE_CACHE_ENTRIES
+  #define WLED_FILE_CACHE_ENTRIES 8
+#endif
 
 // Timer mode types
 #define NL_MODE_SET               0            //After nightlight time elapsed, set to target brightness
@@ -596,6 +681,31 @@ static_assert(WLED_MAX_BUSSES <= 32, "WLED_MAX_BUSSES exceeds hard limit");
   #endif
 #endif
 
+// Number of serialized JSON responses (/json/state, info, eff, fxdata, palx pages) kept in cache (0 = ETags only)
+#ifndef WLED_JSON_CACHE_ENTRIES
+  #ifdef ESP8266
+    #define WLED_JSON_CACHE_ENTRIES 0
+  #elif defined(BOARD_HAS_PSRAM)
+    #define WLED_JSON_CACHE_ENTRIES 16
+  #else
+    #define WLED_JSON_CACHE_ENTRIES 4
+  #endif
+#endif
+// Number of fixed palettes (default, FastLED and gradient) kept decoded with their 256 entry expansion (~1kB each, 0 disables palette table)
+#ifndef WLED_PALETTE_TABLE_SIZE
+  #ifdef ESP8266
+    #define WLED_PALETTE_TABLE_SIZE 0
+  #elif defined(BOARD_HAS_PSRAM)
+    #define WLED_PALETTE_TABLE_SIZE 32
+  #else
+    #define WLED_PALETTE_TABLE_SIZE 6
+  #endif
+#endif
+// /json/info contains live values (uptime, heap, fps) so it is cached only for a short while (ms)
+#ifndef WLED_JSON_CACHE_INFO_TTL
+  #define WLED_JSON_CACHE_INFO_TTL 1000
+#endif
+
 // minimum heap size required to process web requests: try to keep free heap above this value
 #ifdef ESP8266
   #define MIN_HEAP_SIZE (9*1024)
@@ -105,12 +105,22 @@ void sendArtnetPollReply(ArtPollReply* reply, IPAddress ipAddress, uint16_t port
 
 //file.cpp
 bool handleFileRead(AsyncWebServerRequest*, String path);
+void accountFileRead(size_t bytes, uint32_t us);
+void serializeFSStats(JsonObject fs_info);
 bool writeObjectToFileUsingId(const char* file, uint16_t id, const JsonDocument* content);
 bool writeObjectToFile(const char* file, const char* key, const JsonDocument* content);
 bool readObjectFromFileUsingId(const char* file, uint16_t id, JsonDocument* dest, const JsonDocument* filter = nullptr);
 bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest, const JsonDocument* filter = nullptr);
 void updateFSInfo();
 void closeFile();
+void invalidatePresetIndex();
+bool writeFileInBackground(const char *file, char *data, size_t len, bool backup = false);
+bool writeObjectInBackground(const char *file, uint16_t id, char *data, size_t len);
+bool isFileWritePending();
+bool lockFileSystem(unsigned waitMs);
+void unlockFileSystem();
+bool initPresetStore();
+bool importPresets(const char *file);
 inline bool writeObjectToFileUsingId(const String &file, uint16_t id, const JsonDocument* content) { return writeObjectToFileUsingId(file.c_str(), id, content); };
 inline bool writeObjectToFile(const String &file, const char* key, const JsonDocument* content) { return writeObjectToFile(file.c_str(), key, content); };
 inline bool readObjectFromFileUsingId(const String &file, uint16_t id, JsonDocument* dest, const JsonDocument* filter = nullptr) { return readObjectFromFileUsingId(file.c_str(), id, dest); };
@@ -140,6 +150,7 @@ int fileReadBlockCallback(void * buffer, int numberOfBytes);
 int fileSizeCallback(void);
 byte renderImageToSegment(Segment &seg);
 void endImagePlayback(Segment* seg);
+void invalidateImageCache();
 #endif
 
 //improv.cpp
@@ -169,6 +180,11 @@ void handleIR();
 #include "src/dependencies/json/AsyncJson-v6.h"
 
 bool deserializeState(JsonObject root, byte callMode = CALL_MODE_DIRECT_CHANGE, byte presetId = 0);
+#if WLED_PRESET_CACHE_SIZE > 0
+void *compactState(JsonObject root);
+void deserializeCompactState(const void *compact);
+bool compactStateChangesPreset(const void *compact);
+#endif
 void serializeSegment(const JsonObject& root, const Segment& seg, byte id, bool forPreset = false, bool segmentBounds = true);
 void serializeState(JsonObject root, bool forPreset = false, bool includeBri = true, bool segmentBounds = true, bool selectedSegmentsOnly = false);
 void serializeInfo(JsonObject root);
@@ -230,10 +246,13 @@ void unloadPlaylist();
 int16_t loadPlaylist(JsonObject playlistObject, byte presetId = 0);
 void handlePlaylist();
 void serializePlaylist(JsonObject obj);
+void serializePlaylistTiming(JsonObject info);
 
 //presets.cpp
 const char *getPresetsFileName(bool persistent = true);
 bool presetNeedsSaving();
+void requestPresetsImport();
+bool presetNeedsApplying();
 void initPresetsFile();
 void handlePresets();
 bool applyPreset(byte index, byte callMode = CALL_MODE_DIRECT_CHANGE);
@@ -244,6 +263,7 @@ void savePreset(byte index, const char* pname = nullptr, JsonObject saveobj = Js
 inline void saveTemporaryPreset() {savePreset(255);};
 void deletePreset(byte index);
 bool getPresetName(byte index, String& name);
+void prefetchPreset(byte index);
 
 //remote.cpp
 void handleWiZdata(uint8_t *incomingData, size_t len);
@@ -411,11 +431,17 @@ void prepareHostname(char* hostname);
 [[gnu::pure]] bool isAsterisksOnly(const char* str, byte maxLen);
 bool requestJSONBufferLock(uint8_t moduleID=JSON_LOCK_UNKNOWN);
 void releaseJSONBufferLock();
+void initJSONPool();
+uint8_t getJSONPoolSize();
+JsonDocument *requestJSONPoolDoc(uint8_t moduleID=JSON_LOCK_UNKNOWN); // returns pooled document (or pDoc), nullptr on failure
+void releaseJSONStateLock(JsonDocument *doc); // call as soon as pooled document is filled
+void releaseJSONPoolDoc(JsonDocument *doc);
+void serializeJSONLockStats(JsonObject root);
 uint8_t extractModeName(uint8_t mode, const char *src, char *dest, uint8_t maxLen);
 uint8_t extractModeSlider(uint8_t mode, uint8_t slider, char *dest, uint8_t maxLen, uint8_t *var = nullptr);
 int16_t extractModeDefaults(uint8_t mode, const char *segVar);
 void checkSettingsPIN(const char *pin);
-uint16_t crc16(const unsigned char* data_p, size_t length);
+uint16_t crc16(const unsigned char* data_p, size_t length, uint16_t crc = 0xFFFF);
 String computeSHA1(const String& input);
 String getDeviceId();
 uint16_t beatsin88_t(accum88 beats_per_minute_88, uint16_t lowest = 0, uint16_t highest = 65535, uint32_t timebase = 0, uint16_t phase_offset = 0);
@@ -435,6 +461,10 @@ uint16_t perlin16(uint32_t x, uint32_t y, uint32_t z);
 uint8_t perlin8(uint16_t x);
 uint8_t perlin8(uint16_t x, uint16_t y);
 uint8_t perlin8(uint16_t x, uint16_t y, uint16_t z);
+#define NOISE_FIELD_8BIT 0x01 // use perlin8() (8.8 fixed point coordinates) instead of perlin16()>>8 (16.16 fixed point coordinates)
+#define NOISE_FIELD_FAST 0x02 // allow calculating a coarser grid and interpolating (if the noise is smooth enough at given scale)
+const uint8_t *getNoiseField(unsigned cols, unsigned rows, uint32_t x, uint32_t y, uint32_t z, uint32_t scaleX, uint32_t scaleY, uint8_t flags = 0);
+void releaseNoiseFields(unsigned long idleTime);
 
 // fast (true) random numbers using hardware RNG, all functions return values in the range lowerlimit to upperlimit-1
 // note: for true random numbers with high entropy, do not call faster than every 200ns (5MHz)
@@ -32,8 +32,66 @@ static volatile size_t knownLargestSpace = MAX_SPACE;
 
 static File f; // don't export to other cpp files
 
+#ifdef ARDUINO_ARCH_ESP32
+// f (and preset index) is shared between loop and background writer task
+static SemaphoreHandle_t fileMutex = xSemaphoreCreateRecursiveMutex();
+namespace {
+  struct FileLock {
+    bool locked;
+    FileLock() : locked(xSemaphoreTakeRecursive(fileMutex, portMAX_DELAY) == pdTRUE) {}
+    explicit FileLock(unsigned waitMs) : locked(xSemaphoreTakeRecursive(fileMutex, pdMS_TO_TICKS(waitMs)) == pdTRUE) {} // check if locked!
+    ~FileLock() { if (locked) xSemaphoreGiveRecursive(fileMutex); }
+    explicit operator bool() const { return locked; }
+  };
+}
+#else
+namespace {
+  struct FileLock { // single threaded
+    FileLock() {}
+    explicit FileLock(unsigned) {}
+    explicit operator bool() const { return true; }
+  };
+}
+#endif
+
+// max time web server (async_tcp) task waits for file access (i.e. during background write), 503 is sent otherwise
+#ifndef WLED_FS_HTTP_LOCK_WAIT
+#define WLED_FS_HTTP_LOCK_WAIT 100
+#endif
+
+static uint32_t fsOpens = 0, fsReadBytes = 0, fsReadMicros = 0, fsCacheHits = 0, fsCacheMisses = 0; // I/O statistics (see serializeFSStats())
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE fsStatsMux = portMUX_INITIALIZER_UNLOCKED; // statistics are updated from loop, async_tcp and writer task
+#endif
+
+static void addFSStats(uint32_t opens, uint32_t bytes, uint32_t us, uint32_t hits = 0, uint32_t misses = 0) {
+  #ifdef ARDUINO_ARCH_ESP32
+  portENTER_CRITICAL(&fsStatsMux);
+  #endif
+  fsOpens       += opens;
+  fsReadBytes   += bytes;
+  fsReadMicros  += us;
+  fsCacheHits   += hits;
+  fsCacheMisses += misses;
+  #ifdef ARDUINO_ARCH_ESP32
+  portEXIT_CRITICAL(&fsStatsMux);
+  #endif
+}
+
+#if WLED_FILE_CACHE_SIZE > 0
+static volatile uint8_t fileCacheGeneration = 0; // incremented on every write made through this module (see getCachedFile())
+#endif
+
+// must be called (with FileLock held) by every write path of this module before the file is modified
+static inline void invalidateFileCache() {
+  #if WLED_FILE_CACHE_SIZE > 0
+  fileCacheGeneration++;
+  #endif
+}
+
 //wrapper to find out how long closing takes
 void closeFile() {
+  FileLock lock;
   #ifdef WLED_DEBUG_FS
     DEBUGFS_PRINT(F("Close -> "));
     uint32_t s = millis();
@@ -176,6 +234,569 @@ static void writeSpace(size_t l)
   if (knownLargestSpace < l) knownLargestSpace = l;
 }
 
+/*
+ * Offset index for presets.json
+ * Holds position and length of each preset object so that loading or replacing a preset does not need to
+ * search the file from the start. It is persisted in presets.idx (valid for a particular presets.json size)
+ * and rebuilt in a single pass over presets.json on mismatch (size differs or key not found at indexed position).
+ * Index is updated in place when presets are saved or deleted (only the changed entry is written to presets.idx).
+ */
+#define PRESET_INDEX_SIZE   251   // ids 0-250, temporary preset 255 lives in tmp.json
+#define PRESET_INDEX_MAGIC  0x31495057 // "WPI1"
+
+struct PresetIndexEntry {
+  uint32_t pos;   // position of '{' of the preset object
+  uint32_t len;   // length of the object, 0 if preset does not exist
+};
+
+static PresetIndexEntry *presetIndex = nullptr;
+static size_t presetIndexFileSize = 0;  // size of presets.json the index matches
+static bool presetIndexValid = false;
+static int presetIndexId = -1;          // id of the preset being written by writeObjectToFileUsingId(), -1 if not indexed
+static const char presets_idx[] PROGMEM = "/presets.idx";
+#ifdef WLED_ENABLE_PRESET_STORE
+static size_t presetStoreSize = 0;      // size of presets.bin the store table matches, 0 if it needs to be loaded
+#endif
+
+void invalidatePresetIndex() {
+  presetIndexValid = false;
+  #ifdef WLED_ENABLE_PRESET_STORE
+  presetStoreSize = 0;
+  #endif
+  WLED_FS.remove(FPSTR(presets_idx));
+}
+
+static bool isPresetIndexed(const char* file, uint16_t id) {
+  return file == getPresetsFileName() && id < PRESET_INDEX_SIZE; // getPresetsFileName() returns the same PROGMEM string
+}
+
+static void savePresetIndex() {
+  File fi = WLED_FS.open(FPSTR(presets_idx), "w");
+  if (!fi) return;
+  uint32_t hdr[2] = {PRESET_INDEX_MAGIC, (uint32_t)presetIndexFileSize};
+  fi.write((const uint8_t*)hdr, sizeof(hdr));
+  fi.write((const uint8_t*)presetIndex, PRESET_INDEX_SIZE * sizeof(PresetIndexEntry));
+  fi.close();
+}
+
+//scans entire presets.json (opened as f) for root level objects with numeric keys
+static bool rebuildPresetIndex() {
+  #ifdef WLED_DEBUG_FS
+    DEBUGFS_PRINTLN(F("Rebuild preset index"));
+    uint32_t s = millis();
+  #endif
+  memset(presetIndex, 0, PRESET_INDEX_SIZE * sizeof(PresetIndexEntry));
+  presetIndexValid = false;
+  if (!f || !f.size()) return false;
+
+  unsigned depth = 0;
+  bool inString = false, escape = false;
+  int keyId = -1, objId = -1;   // numeric key of the current root level string, of the current root level object
+  uint32_t objStart = 0;
+  uint32_t pos = 0;
+  byte buf[FS_BUFSIZE];
+  f.seek(0);
+  while (pos < f.size()) {
+    size_t bufsize = f.read(buf, FS_BUFSIZE);
+    if (!bufsize) return false;
+    for (size_t count = 0; count < bufsize; count++, pos++) {
+      char c = buf[count];
+      if (inString) {
+        if (escape) escape = false;
+        else if (c == '\\') escape = true;
+        else if (c == '"') inString = false;
+        else if (depth == 1 && keyId >= 0) keyId = (c >= '0' && c <= '9' && keyId < PRESET_INDEX_SIZE) ? keyId*10 + c - '0' : INT_MAX;
+        continue;
+      }
+      switch (c) {
+        case '"':
+          inString = true;
+          if (depth == 1) keyId = 0;
+          break;
+        case '{':
+          if (depth == 1 && keyId >= 0 && keyId < PRESET_INDEX_SIZE) { objId = keyId; objStart = pos; }
+          depth++;
+          break;
+        case '}':
+          if (depth == 0) return false;
+          if (--depth == 1 && objId >= 0) {
+            presetIndex[objId].pos = objStart;
+            presetIndex[objId].len = pos + 1 - objStart;
+            objId = -1;
+          }
+          break;
+        case ',':
+          if (depth == 1) keyId = -1;
+          break;
+      }
+    }
+  }
+  presetIndexFileSize = f.size();
+  presetIndexValid = true;
+  savePresetIndex();
+  DEBUGFS_PRINTF("Preset index rebuilt, took %lu ms\n", millis() - s);
+  return true;
+}
+
+//makes sure index matches presets.json opened as f, loads or rebuilds it if needed
+static bool checkPresetIndex() {
+  if (!presetIndex) {
+    presetIndex = static_cast<PresetIndexEntry*>(p_malloc(PRESET_INDEX_SIZE * sizeof(PresetIndexEntry)));
+    if (!presetIndex) return false;
+    presetIndexValid = false;
+    File fi = WLED_FS.open(FPSTR(presets_idx), "r");
+    if (fi) {
+      uint32_t hdr[2];
+      presetIndexValid = fi.read((uint8_t*)hdr, sizeof(hdr)) == sizeof(hdr) && hdr[0] == PRESET_INDEX_MAGIC
+                      && fi.read((uint8_t*)presetIndex, PRESET_INDEX_SIZE * sizeof(PresetIndexEntry)) == PRESET_INDEX_SIZE * sizeof(PresetIndexEntry);
+      presetIndexFileSize = hdr[1];
+      fi.close();
+    }
+  }
+  if (presetIndexValid && presetIndexFileSize == f.size()) return true;
+  return rebuildPresetIndex();
+}
+
+//seeks to indexed preset object after verifying that it is preceded by its key
+//returns 1 if found, 0 if preset does not exist and -1 if index does not match the file
+static int seekToIndexedPreset(uint16_t id) {
+  const PresetIndexEntry &entry = presetIndex[id];
+  if (!entry.len) return 0;
+  char objKey[10], buf[10];
+  size_t keyLen = sprintf(objKey, "\"%d\":", id);
+  if (entry.pos < keyLen || entry.pos + entry.len > f.size()) return -1;
+  f.seek(entry.pos - keyLen);
+  if (f.read((uint8_t*)buf, keyLen + 1) != keyLen + 1 || memcmp(buf, objKey, keyLen) != 0 || buf[keyLen] != '{') return -1;
+  f.seek(entry.pos);
+  return 1;
+}
+
+//finds preset in index, rebuilding it once if it does not match the file
+static bool findIndexedPreset(uint16_t id) {
+  int found = seekToIndexedPreset(id);
+  if (found < 0 && rebuildPresetIndex()) found = seekToIndexedPreset(id);
+  return found > 0;
+}
+
+//finds a run of spaces between indexed objects (deleted or shrunk presets) and seeks to its start
+static bool findIndexedSpace(size_t targetLen) {
+  #ifdef WLED_DEBUG_FS
+    DEBUGFS_PRINTF("Find %d spaces (index)\n", targetLen);
+    uint32_t s = millis();
+  #endif
+  uint32_t fileEnd = f.size() - 1; // closing '}'
+  for (unsigned i = 0; i < PRESET_INDEX_SIZE; i++) {
+    if (!presetIndex[i].len) continue;
+    uint32_t gapStart = presetIndex[i].pos + presetIndex[i].len;
+    uint32_t gapEnd = fileEnd;
+    // nearest object following this one, its key and separating comma end the gap
+    for (unsigned j = 0; j < PRESET_INDEX_SIZE; j++) {
+      if (!presetIndex[j].len || presetIndex[j].pos <= gapStart) continue;
+      uint32_t keyStart = presetIndex[j].pos - (j < 10 ? 4 : j < 100 ? 5 : 6) - 1;
+      if (keyStart < gapEnd) gapEnd = keyStart;
+    }
+    if (gapEnd < gapStart || gapEnd - gapStart < targetLen) continue;
+    // verify that gap consists of spaces only (it may contain whitespace from manual edits)
+    byte buf[FS_BUFSIZE];
+    size_t checked = 0;
+    f.seek(gapStart);
+    while (checked < targetLen) {
+      size_t bufsize = f.read(buf, min(targetLen - checked, (size_t)FS_BUFSIZE));
+      if (!bufsize) break;
+      size_t count = 0;
+      while (count < bufsize && buf[count] == ' ') count++;
+      checked += count;
+      if (count < bufsize) break;
+    }
+    if (checked >= targetLen) {
+      f.seek(gapStart);
+      DEBUGFS_PRINTF("Found at pos %d, took %lu ms", gapStart, millis() - s);
+      return true;
+    }
+  }
+  DEBUGFS_PRINTF("No match, took %lu ms\n", millis() - s);
+  return false;
+}
+
+//updates index entry after presets.json was modified
+//updates entry of a saved or deleted preset, only the file size and the changed entry are written to presets.idx
+static void updatePresetIndex(uint16_t id, uint32_t pos, uint32_t len) {
+  presetIndex[id].pos = pos;
+  presetIndex[id].len = len;
+  presetIndexFileSize = f.size();
+  File fi = WLED_FS.open(FPSTR(presets_idx), "r+");
+  if (!fi || fi.size() != 2 * sizeof(uint32_t) + PRESET_INDEX_SIZE * sizeof(PresetIndexEntry)) {
+    fi.close();
+    savePresetIndex(); // missing or damaged
+    return;
+  }
+  uint32_t size = presetIndexFileSize;
+  fi.seek(sizeof(uint32_t));
+  fi.write((const uint8_t*)&size, sizeof(size));
+  fi.seek(2 * sizeof(uint32_t) + id * sizeof(PresetIndexEntry)); // a stale entry is detected by seekToIndexedPreset()
+  fi.write((const uint8_t*)&presetIndex[id], sizeof(PresetIndexEntry));
+  fi.close();
+}
+
+#ifdef WLED_ENABLE_PRESET_STORE
+/*
+ * Binary preset store (presets.bin)
+ * Fixed header with a table of record offsets for ids 0-250 followed by records (id, CRC, length, compact JSON object).
+ * Saving appends a record and rewrites header (deleting appends an empty record), loading seeks directly to the record,
+ * so neither depends on number of presets or age of the file. Once superseded records take up more space than live
+ * ones the store is rewritten (compacted). Records appended after the last header write (i.e. power loss) are
+ * recovered by scanning the tail of the file.
+ * presets.json is imported on first use or upload and generated on request (UI, backups), so the format is unchanged
+ * for clients. Only numeric root level keys are kept (as with the preset index), "0":{} is emitted as first object.
+ */
+#define PRESET_STORE_MAGIC  0x31535057 // "WPS1"
+#ifndef WLED_PRESET_STORE_SLACK
+#define WLED_PRESET_STORE_SLACK 4096   // superseded bytes tolerated before compaction
+#endif
+
+struct PresetStoreHeader {
+  uint32_t magic;
+  uint32_t size;   // file size the table covers, records beyond it are recovered on load
+  uint16_t crc;    // of table
+  uint16_t count;  // number of presets
+};
+
+struct PresetStoreRecord {
+  uint16_t id;
+  uint16_t crc;    // of JSON object
+  uint32_t len;    // length of JSON object, 0 if preset was deleted
+};
+static_assert(sizeof(PresetStoreRecord) == 8, "unexpected padding in preset record");
+
+constexpr size_t PRESET_STORE_DATA = sizeof(PresetStoreHeader) + PRESET_INDEX_SIZE * sizeof(PresetIndexEntry); // start of records
+
+static const char presets_bin[] PROGMEM = "/presets.bin";
+static const char presets_bin_tmp[] PROGMEM = "/presets.bin.tmp";
+static PresetIndexEntry *presetStore = nullptr; // position of record and length of JSON object for each id
+static volatile uint8_t presetExports = 0;      // number of presets.json responses in flight (store is not compacted)
+
+// computes CRC (and length) of JSON as it is serialized
+class CrcPrint : public Print {
+  public:
+    uint16_t crc = 0xFFFF;
+    size_t   len = 0;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t size) override { crc = crc16(buf, size, crc); len += size; return size; }
+};
+
+// CRC of file contents, file position is advanced by len
+static bool crcFileRange(File &file, uint32_t len, uint16_t &crc) {
+  byte buf[FS_BUFSIZE];
+  crc = 0xFFFF;
+  while (len) {
+    size_t bufsize = file.read(buf, min(len, (uint32_t)FS_BUFSIZE));
+    if (!bufsize) return false;
+    crc = crc16(buf, bufsize, crc);
+    len -= bufsize;
+  }
+  return true;
+}
+
+// verifies record at pos, leaves file positioned at its JSON object
+static bool checkStoreRecord(File &file, uint32_t pos, PresetStoreRecord &rec) {
+  uint16_t crc;
+  if (pos + sizeof(rec) > file.size() || !file.seek(pos) || file.read((uint8_t*)&rec, sizeof(rec)) != sizeof(rec)) return false;
+  if (rec.id >= PRESET_INDEX_SIZE || pos + sizeof(rec) + rec.len > file.size()) return false;
+  if (!crcFileRange(file, rec.len, crc) || crc != rec.crc) return false;
+  return file.seek(pos + sizeof(rec));
+}
+
+static size_t presetStoreLiveBytes(unsigned *count = nullptr) {
+  size_t live = 0;
+  if (count) *count = 0;
+  for (unsigned i = 0; i < PRESET_INDEX_SIZE; i++) {
+    if (!presetStore[i].len) continue;
+    live += sizeof(PresetStoreRecord) + presetStore[i].len;
+    if (count) (*count)++;
+  }
+  return live;
+}
+
+static bool writePresetStoreHeader(File &file) {
+  unsigned count;
+  presetStoreLiveBytes(&count);
+  PresetStoreHeader hdr = {PRESET_STORE_MAGIC, (uint32_t)presetStoreSize, crc16((const unsigned char*)presetStore, PRESET_INDEX_SIZE * sizeof(PresetIndexEntry)), (uint16_t)count};
+  file.seek(0);
+  return file.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr)
+      && file.write((const uint8_t*)presetStore, PRESET_INDEX_SIZE * sizeof(PresetIndexEntry)) == PRESET_INDEX_SIZE * sizeof(PresetIndexEntry);
+}
+
+// writes new presets.bin from JSON objects in src (located by srcTable, objects start at pos + offset) and replaces table
+// srcTable may be presetStore itself (compaction)
+static bool buildPresetStore(File &src, const PresetIndexEntry *srcTable, size_t offset, bool validate) {
+  #ifdef WLED_DEBUG_FS
+    DEBUGFS_PRINTLN(F("Build preset store"));
+    uint32_t s = millis();
+  #endif
+  File dst = WLED_FS.open(FPSTR(presets_bin_tmp), "w+");
+  if (!dst) return false;
+  presetStoreSize = PRESET_STORE_DATA;
+  bool success = true;
+  byte buf[FS_BUFSIZE];
+  memset(buf, 0, sizeof(buf));
+  for (size_t l = PRESET_STORE_DATA; success && l; ) { // placeholder, header is written last
+    size_t block = min(l, sizeof(buf));
+    success = dst.write(buf, block) == block;
+    l -= block;
+  }
+  for (unsigned id = 1; success && id < PRESET_INDEX_SIZE; id++) {
+    PresetIndexEntry entry = srcTable[id];
+    presetStore[id] = {0, 0};
+    if (!entry.len) continue;
+    PresetStoreRecord rec = {(uint16_t)id, 0, entry.len};
+    if (!src.seek(entry.pos + offset) || !crcFileRange(src, entry.len, rec.crc)) { success = false; break; }
+    src.seek(entry.pos + offset);
+    if (validate) {
+      StaticJsonDocument<0> doc, filter; // https://arduinojson.org/v6/how-to/validate-json/
+      if (deserializeJson(doc, src, DeserializationOption::Filter(filter)) != DeserializationError::Ok) {
+        DEBUGFS_PRINTF("Invalid preset %u skipped\n", id);
+        continue;
+      }
+      src.seek(entry.pos + offset);
+    }
+    success = dst.write((const uint8_t*)&rec, sizeof(rec)) == sizeof(rec);
+    for (size_t l = entry.len; success && l; ) {
+      size_t bufsize = src.read(buf, min(l, sizeof(buf)));
+      success = bufsize && dst.write(buf, bufsize) == bufsize;
+      l -= bufsize;
+    }
+    presetStore[id] = {(uint32_t)presetStoreSize, entry.len};
+    presetStoreSize += sizeof(rec) + entry.len;
+  }
+  success = success && writePresetStoreHeader(dst);
+  dst.close();
+  src.close();
+  if (success) success = WLED_FS.rename(FPSTR(presets_bin_tmp), FPSTR(presets_bin)) || (WLED_FS.remove(FPSTR(presets_bin)) && WLED_FS.rename(FPSTR(presets_bin_tmp), FPSTR(presets_bin)));
+  if (!success) {
+    WLED_FS.remove(FPSTR(presets_bin_tmp));
+    presetStoreSize = 0; // reload table from file
+  }
+  DEBUGFS_PRINTF("Preset store built (%u bytes), took %lu ms\n", presetStoreSize, millis() - s);
+  return success;
+}
+
+static bool compactPresetStore() {
+  File src = WLED_FS.open(FPSTR(presets_bin), "r");
+  if (!src) return false;
+  return buildPresetStore(src, presetStore, sizeof(PresetStoreRecord), false);
+}
+
+// loads table from presets.bin unless it already matches the file, recovers records appended after last header write
+static bool loadPresetStore(File &file) {
+  if (!presetStore) {
+    presetStore = static_cast<PresetIndexEntry*>(p_malloc(PRESET_INDEX_SIZE * sizeof(PresetIndexEntry)));
+    if (!presetStore) return false;
+    presetStoreSize = 0;
+  }
+  if (presetStoreSize && presetStoreSize == file.size()) return true;
+
+  PresetStoreHeader hdr;
+  size_t pos = PRESET_STORE_DATA;
+  file.seek(0);
+  if (file.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) && hdr.magic == PRESET_STORE_MAGIC && hdr.size >= PRESET_STORE_DATA && hdr.size <= file.size()
+   && file.read((uint8_t*)presetStore, PRESET_INDEX_SIZE * sizeof(PresetIndexEntry)) == PRESET_INDEX_SIZE * sizeof(PresetIndexEntry)
+   && crc16((const unsigned char*)presetStore, PRESET_INDEX_SIZE * sizeof(PresetIndexEntry)) == hdr.crc) {
+    pos = hdr.size;
+  } else {
+    memset(presetStore, 0, PRESET_INDEX_SIZE * sizeof(PresetIndexEntry)); // damaged header, scan all records
+    if (file.size() < PRESET_STORE_DATA) return false;
+  }
+  bool recovered = false;
+  PresetStoreRecord rec;
+  while (pos < file.size() && checkStoreRecord(file, pos, rec)) {
+    presetStore[rec.id] = {(uint32_t)pos, rec.len};
+    pos += sizeof(rec) + rec.len;
+    recovered = true;
+  }
+  presetStoreSize = file.size();
+  if (recovered || pos < file.size()) {
+    DEBUGFS_PRINTF("Preset store recovered up to %u of %u bytes\n", pos, file.size());
+    file.close();
+    return compactPresetStore(); // drop damaged tail and persist table
+  }
+  return true;
+}
+
+// opens presets.bin (importing presets.json or creating empty store if it does not exist) and loads table
+static bool openPresetStore(File &file, bool write = false) {
+  if (!WLED_FS.exists(FPSTR(presets_bin)) && !initPresetStore()) return false;
+  file = WLED_FS.open(FPSTR(presets_bin), write ? "r+" : "r");
+  addFSStats(1, 0, 0);
+  if (!file) return false;
+  if (!loadPresetStore(file)) return false;
+  if (!file) file = WLED_FS.open(FPSTR(presets_bin), write ? "r+" : "r"); // reopen after recovery
+  return file;
+}
+
+// imports JSON presets file (i.e. uploaded backup) replacing all stored presets, removes JSON file on success
+bool importPresets(const char *file) {
+  FileLock lock;
+  if (doCloseFile) closeFile();
+  char fileName[33]; strncpy_P(fileName, file, 32); fileName[32] = 0; //use PROGMEM safe copy as FS.open() does not
+  if (!presetIndex) presetIndex = static_cast<PresetIndexEntry*>(p_malloc(PRESET_INDEX_SIZE * sizeof(PresetIndexEntry)));
+  if (!presetStore) presetStore = static_cast<PresetIndexEntry*>(p_malloc(PRESET_INDEX_SIZE * sizeof(PresetIndexEntry)));
+  if (!presetIndex || !presetStore) return false;
+  f = WLED_FS.open(fileName, "r");
+  bool success = f && rebuildPresetIndex(); // locate root level objects
+  success = success && buildPresetStore(f, presetIndex, 0, true);
+  f.close();
+  invalidatePresetIndex();
+  if (success) WLED_FS.remove(fileName);
+  DEBUG_PRINTF_P(PSTR("Presets import from %s %s.\n"), fileName, success ? "ok" : "failed");
+  return success;
+}
+
+// creates presets.bin if it does not exist, importing presets.json (kept as backup) if present
+bool initPresetStore() {
+  FileLock lock;
+  if (WLED_FS.exists(FPSTR(presets_bin))) return true;
+  char fileName[33]; strncpy_P(fileName, getPresetsFileName(), 32); fileName[32] = 0; //use PROGMEM safe copy as FS.open() does not
+  if (WLED_FS.exists(fileName)) {
+    backupFile(fileName); // keep original presets.json
+    return importPresets(fileName);
+  }
+  if (!presetStore) presetStore = static_cast<PresetIndexEntry*>(p_malloc(PRESET_INDEX_SIZE * sizeof(PresetIndexEntry)));
+  if (!presetStore) return false;
+  memset(presetStore, 0, PRESET_INDEX_SIZE * sizeof(PresetIndexEntry));
+  File file = WLED_FS.open(FPSTR(presets_bin), "w");
+  presetStoreSize = PRESET_STORE_DATA;
+  bool success = file && writePresetStoreHeader(file);
+  file.close();
+  if (!success) {
+    WLED_FS.remove(FPSTR(presets_bin));
+    presetStoreSize = 0;
+  }
+  return success;
+}
+
+static bool readPresetFromStore(uint16_t id, JsonDocument* dest, const JsonDocument* filter) {
+  uint32_t s = micros();
+  File file;
+  PresetStoreRecord rec;
+  if (!openPresetStore(file) || !presetStore[id].len) {
+    dest->clear();
+    return false;
+  }
+  if (!checkStoreRecord(file, presetStore[id].pos, rec) || rec.id != id || rec.len != presetStore[id].len) {
+    DEBUGFS_PRINTF("Preset %u damaged\n", id);
+    dest->clear();
+    presetStoreSize = 0; // reload table on next access
+    return false;
+  }
+  if (filter) deserializeJson(*dest, file, DeserializationOption::Filter(*filter));
+  else        deserializeJson(*dest, file);
+  addFSStats(0, 2 * rec.len, micros() - s); // CRC check reads object twice
+  return true;
+}
+
+static bool writePresetToStore(uint16_t id, const JsonDocument* content) {
+  #ifdef WLED_DEBUG_FS
+    uint32_t s = millis();
+  #endif
+  if (id == 0) return true; // reserved for "0":{} placeholder
+  File file;
+  if (!openPresetStore(file, true)) return false;
+  CrcPrint crc;
+  if (!content->isNull()) serializeJson(*content, crc);
+  if (!crc.len && !presetStore[id].len) return true; // nothing to delete
+
+  // keep room for a compacted copy of the store
+  size_t needed = sizeof(PresetStoreRecord) + crc.len + PRESET_STORE_DATA + presetStoreLiveBytes();
+  updateFSInfo();
+  if (needed > fsBytesTotal - fsBytesUsed && !presetExports) {
+    file.close();
+    if (compactPresetStore()) updateFSInfo(); // reclaim superseded records first
+    if (!openPresetStore(file, true)) return false;
+  }
+  if (needed > fsBytesTotal - fsBytesUsed) {
+    errorFlag = ERR_FS_QUOTA;
+    return false;
+  }
+  PresetStoreRecord rec = {id, crc.crc, (uint32_t)crc.len};
+  uint32_t pos = file.size();
+  file.seek(pos);
+  bool success = file.write((const uint8_t*)&rec, sizeof(rec)) == sizeof(rec);
+  if (success && rec.len) success = serializeJson(*content, file) == rec.len;
+  if (success) {
+    presetStore[id] = rec.len ? PresetIndexEntry{pos, rec.len} : PresetIndexEntry{0, 0};
+    presetStoreSize = pos + sizeof(rec) + rec.len;
+    success = writePresetStoreHeader(file);
+    if (success) presetStoreSize = file.size();
+  }
+  file.close();
+  if (!success) {
+    presetStoreSize = 0; // recover from file
+    return false;
+  }
+  size_t superseded = presetStoreSize - PRESET_STORE_DATA - presetStoreLiveBytes();
+  if (superseded > WLED_PRESET_STORE_SLACK && superseded > presetStoreSize / 2 && !presetExports) compactPresetStore();
+  DEBUGFS_PRINTF("Stored preset %u (%u bytes), took %lu ms\n", id, rec.len, millis() - s);
+  return true;
+}
+
+// presets.json generated from store, objects are read from presets.bin as the response is sent
+// superseded records stay in place until compaction, which waits until response is complete
+struct PresetExport {
+  PresetIndexEntry table[PRESET_INDEX_SIZE];
+  uint16_t id = 0;     // object being sent
+  uint32_t offset = 0; // within key + object
+  PresetExport()  { presetExports++; }
+  ~PresetExport() { presetExports--; }
+};
+
+static size_t presetExportKey(char *key, unsigned id) {
+  return id ? sprintf_P(key, PSTR(",\"%u\":"), id) : strlen(strcpy_P(key, PSTR("{\"0\":{}")));
+}
+
+static size_t fillPresetExport(PresetExport &exp, uint8_t *buf, size_t maxLen) {
+  FileLock lock;
+  File file;
+  size_t written = 0;
+  while (written < maxLen && exp.id <= PRESET_INDEX_SIZE) {
+    if (exp.id == PRESET_INDEX_SIZE) { buf[written++] = '}'; exp.id++; break; }
+    const PresetIndexEntry &entry = exp.table[exp.id];
+    if (exp.id && !entry.len) { exp.id++; continue; }
+    char key[12];
+    size_t keyLen = presetExportKey(key, exp.id);
+    size_t len;
+    if (exp.offset < keyLen) {
+      len = min(keyLen - exp.offset, maxLen - written);
+      memcpy(buf + written, key + exp.offset, len);
+    } else {
+      size_t objOffset = exp.offset - keyLen;
+      len = min(entry.len - objOffset, maxLen - written);
+      if (!file) file = WLED_FS.open(FPSTR(presets_bin), "r");
+      if (!file || !file.seek(entry.pos + sizeof(PresetStoreRecord) + objOffset) || file.read(buf + written, len) != len) memset(buf + written, ' ', len); // keep announced length
+    }
+    written += len;
+    exp.offset += len;
+    if (exp.offset == keyLen + (exp.id ? entry.len : 0)) { exp.id++; exp.offset = 0; }
+  }
+  return written;
+}
+
+static bool sendPresetStore(AsyncWebServerRequest* request) {
+  FileLock lock;
+  File file;
+  if (!openPresetStore(file)) return false;
+  file.close();
+  std::shared_ptr<PresetExport> exp = std::make_shared<PresetExport>();
+  memcpy(exp->table, presetStore, sizeof(exp->table));
+  char key[12];
+  size_t len = presetExportKey(key, 0) + 1; // "0" object and closing bracket
+  for (unsigned i = 1; i < PRESET_INDEX_SIZE; i++) if (exp->table[i].len) len += presetExportKey(key, i) + exp->table[i].len;
+  request->send(request->beginResponse(FPSTR(CONTENT_TYPE_JSON), len, [exp](uint8_t *buf, size_t maxLen, size_t index) -> size_t {
+    return fillPresetExport(*exp, buf, maxLen);
+  }));
+  return true;
+}
+#endif
+
 static bool appendObjectToFile(const char* key, const JsonDocument* content, uint32_t s, uint32_t contentLen = 0)
 {
   #ifdef WLED_DEBUG_FS
@@ -199,10 +820,13 @@ static bool appendObjectToFile(const char* key, const JsonDocument* content, uin
   //if there is enough empty space in file, insert there instead of appending
   if (!contentLen) contentLen = measureJson(*content);
   DEBUGFS_PRINTF("CLen %d\n", contentLen);
-  if (bufferedFindSpace(contentLen + strlen(key) + 1)) {
+  bool indexed = presetIndexId >= 0;
+  if (indexed ? findIndexedSpace(contentLen + strlen(key) + 1) : bufferedFindSpace(contentLen + strlen(key) + 1)) {
     if (f.position() > 2) f.write(','); //add comma if not first object
     f.print(key);
+    pos = f.position();
     serializeJson(*content, f);
+    if (indexed) updatePresetIndex(presetIndexId, pos, contentLen);
     DEBUGFS_PRINTF("Inserted, took %lu ms (total %lu)", millis() - s1, millis() - s);
     doCloseFile = true;
     return true;
@@ -247,8 +871,10 @@ static bool appendObjectToFile(const char* key, const JsonDocument* content, uin
   f.print(key);
 
   //Append object
+  pos = f.position();
   serializeJson(*content, f);
   f.write('}');
+  if (indexed) updatePresetIndex(presetIndexId, pos, contentLen);
 
   doCloseFile = true;
   DEBUGFS_PRINTF("Appended, took %lu ms (total %lu)", millis() - s1, millis() - s);
@@ -257,13 +883,21 @@ static bool appendObjectToFile(const char* key, const JsonDocument* content, uin
 
 bool writeObjectToFileUsingId(const char* file, uint16_t id, const JsonDocument* content)
 {
+  FileLock lock;
+  #ifdef WLED_ENABLE_PRESET_STORE
+  if (isPresetIndexed(file, id)) return writePresetToStore(id, content);
+  #endif
   char objKey[10];
   sprintf(objKey, "\"%d\":", id);
-  return writeObjectToFile(file, objKey, content);
+  presetIndexId = isPresetIndexed(file, id) ? id : -1;
+  bool success = writeObjectToFile(file, objKey, content);
+  presetIndexId = -1;
+  return success;
 }
 
 bool writeObjectToFile(const char* file, const char* key, const JsonDocument* content)
 {
+  FileLock lock;
   uint32_t s = 0; //timing
   #ifdef WLED_DEBUG_FS
     DEBUGFS_PRINTF("Write to %s with key %s >>>\n", file, (key==nullptr)?"nullptr":key);
@@ -280,8 +914,10 @@ bool writeObjectToFile(const char* file, const char* key, const JsonDocument* co
     DEBUGFS_PRINTLN(F("Failed to open!"));
     return false;
   }
+  invalidateFileCache(); // covers all cases below (insert, append, replace, delete)
 
-  if (!bufferedFind(key)) //key does not exist in file
+  if (presetIndexId >= 0 && !checkPresetIndex()) presetIndexId = -1; // index unavailable (i.e. empty file or out of memory)
+  if (presetIndexId >= 0 ? !findIndexedPreset(presetIndexId) : !bufferedFind(key)) //key does not exist in file
   {
     return appendObjectToFile(key, content, s);
   }
@@ -309,16 +945,19 @@ bool writeObjectToFile(const char* file, const char* key, const JsonDocument* co
     f.seek(pos);
     serializeJson(*content, f);
     writeSpace(pos2 - f.position());
+    if (presetIndexId >= 0) updatePresetIndex(presetIndexId, pos, contentLen);
   } else if (contentLen && bufferedFindSpace(contentLen - oldLen, false)) { //enough leading spaces to replace
     DEBUGFS_PRINTLN(F("replace (trailing)"));
     f.seek(pos);
     serializeJson(*content, f);
+    if (presetIndexId >= 0) updatePresetIndex(presetIndexId, pos, contentLen);
   } else {
     DEBUGFS_PRINTLN(F("delete"));
     pos -= strlen(key);
     if (pos > 3) pos--; //also delete leading comma if not first object
     f.seek(pos);
     writeSpace(pos2 - pos);
+    if (presetIndexId >= 0) updatePresetIndex(presetIndexId, 0, 0);
     if (contentLen) return appendObjectToFile(key, content, s, contentLen);
   }
 
@@ -327,24 +966,222 @@ bool writeObjectToFile(const char* file, const char* key, const JsonDocument* co
   return true;
 }
 
+/*
+ * File system I/O profiling and read cache for hot files
+ * Small, frequently read files (presets, config, ledmaps, palettes) are kept in PSRAM. Entries are validated against
+ * size and modification time of the file and against writes made through this module or uploads (cacheInvalidate).
+ * Contents are shared with in-flight HTTP responses. Counters are reported in /json/info.
+ */
+// adds a file read made outside of this module to I/O statistics
+void accountFileRead(size_t bytes, uint32_t us) {
+  addFSStats(1, bytes, us);
+}
+
+void serializeFSStats(JsonObject fs_info) {
+  #ifdef ARDUINO_ARCH_ESP32
+  portENTER_CRITICAL(&fsStatsMux);
+  #endif
+  uint32_t opens = fsOpens, bytes = fsReadBytes, us = fsReadMicros, hits = fsCacheHits, lookups = fsCacheHits + fsCacheMisses;
+  #ifdef ARDUINO_ARCH_ESP32
+  portEXIT_CRITICAL(&fsStatsMux);
+  #endif
+  fs_info[F("opn")] = opens;
+  fs_info[F("rd")]  = bytes / 1000; // kB
+  fs_info[F("rt")]  = us / 1000;    // ms
+  fs_info[F("hit")] = lookups ? (unsigned)((hits * 100ULL) / lookups) : 0; // %
+}
+
+#if WLED_FILE_CACHE_SIZE > 0
+class FileCacheBlob {
+  public:
+    uint8_t *data;
+    size_t   len;
+    FileCacheBlob(size_t size) : data(static_cast<uint8_t*>(p_malloc(size + 1))), len(data ? size : 0) {} // +1 for zero termination
+    ~FileCacheBlob() { if (data) p_free(data); }
+    FileCacheBlob(const FileCacheBlob&) = delete; // Noncopyable
+    FileCacheBlob& operator=(const FileCacheBlob&) = delete;
+};
+
+struct FileCacheEntry {
+  char          path[33];
+  time_t        mtime;
+  uint8_t       generation; // fileCacheGeneration + cacheInvalidate the entry is valid for
+  unsigned long used;       // last time entry was used (for eviction)
+  std::shared_ptr<FileCacheBlob> blob;
+};
+static FileCacheEntry fileCache[WLED_FILE_CACHE_ENTRIES];
+
+// opens file and returns its contents from cache, reading it into cache if it fits
+// returns nullptr if file cannot be cached, file is then left open for reading
+static std::shared_ptr<FileCacheBlob> getCachedFile(const char *path, File &file) {
+  FileLock lock;
+  uint32_t s = micros();
+  file = WLED_FS.open(path, "r");
+  addFSStats(1, 0, 0);
+  if (!file || !psramFound()) return nullptr;
+  size_t size = file.size();
+  time_t mtime = file.getLastWrite();
+  uint8_t generation = fileCacheGeneration + cacheInvalidate;
+  for (auto &e : fileCache) {
+    if (!e.blob || strcmp(e.path, path) != 0) continue;
+    if (e.blob->len == size && e.mtime == mtime && e.generation == generation) {
+      file.close();
+      e.used = millis();
+      addFSStats(0, 0, micros() - s, 1);
+      return e.blob;
+    }
+    e.blob.reset(); // outdated, release memory (in-flight responses keep their copy alive)
+  }
+  addFSStats(0, 0, 0, 0, 1);
+  if (size == 0 || size > WLED_FILE_CACHE_SIZE / 2 || strlen(path) >= sizeof(fileCache[0].path)) return nullptr;
+
+  // release least recently used entries until file fits
+  FileCacheEntry *slot;
+  for (;;) {
+    size_t used = 0;
+    FileCacheEntry *lru = nullptr;
+    slot = nullptr;
+    for (auto &e : fileCache) {
+      if (!e.blob) { slot = &e; continue; }
+      used += e.blob->len;
+      if (!lru || e.used < lru->used) lru = &e;
+    }
+    if (slot && used + size <= WLED_FILE_CACHE_SIZE) break;
+    if (!lru) return nullptr;
+    lru->blob.reset();
+  }
+  auto blob = std::make_shared<FileCacheBlob>(size);
+  if (!blob->data) return nullptr;
+  if (file.read(blob->data, size) != size) {
+    file.seek(0);
+    return nullptr;
+  }
+  file.close();
+  blob->data[size] = 0;
+  addFSStats(0, size, micros() - s);
+  strcpy(slot->path, path);
+  slot->mtime = mtime;
+  slot->generation = generation;
+  slot->used = millis();
+  slot->blob = blob;
+  DEBUGFS_PRINTF("Cached %s (%u bytes)\n", path, size);
+  return blob;
+}
+
+// deserializes object following key (or entire file if key is nullptr) from cached file contents
+static bool readObjectFromCache(const FileCacheBlob &blob, const char *key, JsonDocument* dest, const JsonDocument* filter) {
+  const char *json = reinterpret_cast<const char*>(blob.data);
+  if (key != nullptr) {
+    const char *found = strstr(json, key);
+    if (!found) {
+      dest->clear();
+      DEBUGFS_PRINTLN(F("Obj not found."));
+      return false;
+    }
+    json = found + strlen(key);
+  }
+  size_t len = blob.len - (json - reinterpret_cast<const char*>(blob.data));
+  if (filter) deserializeJson(*dest, json, len, DeserializationOption::Filter(*filter));
+  else        deserializeJson(*dest, json, len);
+  return true;
+}
+
+// response that streams cached file contents (keeps blob alive until response is destroyed)
+class CachedFileResponse: public AsyncAbstractResponse {
+  std::shared_ptr<FileCacheBlob> _blob;
+  public:
+  CachedFileResponse(std::shared_ptr<FileCacheBlob> blob, const String &contentType) : _blob(std::move(blob)) {
+    _code = 200;
+    _contentType = contentType;
+    _contentLength = _blob->len;
+  }
+  bool _sourceValid() const { return _blob && _blob->data; }
+  virtual size_t _fillBuffer(uint8_t *buf, size_t maxLen) {
+    size_t len = MIN(maxLen, _contentLength - _sentLength);
+    memcpy(buf, _blob->data + _sentLength, len);
+    return len;
+  }
+};
+#endif
+
 bool readObjectFromFileUsingId(const char* file, uint16_t id, JsonDocument* dest, const JsonDocument* filter)
 {
+  FileLock lock;
+  #ifdef WLED_ENABLE_PRESET_STORE
+  if (isPresetIndexed(file, id)) return readPresetFromStore(id, dest, filter);
+  #endif
   char objKey[10];
   sprintf(objKey, "\"%d\":", id);
-  return readObjectFromFile(file, objKey, dest, filter);
+  if (!isPresetIndexed(file, id)) return readObjectFromFile(file, objKey, dest, filter);
+
+  // presets.json: seek directly to the object using index
+  if (doCloseFile) closeFile();
+  #ifdef WLED_DEBUG_FS
+    DEBUGFS_PRINTF("Read preset %d using index >>>\n", id);
+    uint32_t s = millis();
+  #endif
+  char fileName[33]; strncpy_P(fileName, file, 32); fileName[32] = 0; //use PROGMEM safe copy as FS.open() does not
+  #if WLED_FILE_CACHE_SIZE > 0
+  std::shared_ptr<FileCacheBlob> cached = getCachedFile(fileName, f);
+  if (cached) {
+    if (!presetIndex || !presetIndexValid || presetIndexFileSize != cached->len) return readObjectFromCache(*cached, objKey, dest, filter);
+    const PresetIndexEntry &entry = presetIndex[id];
+    size_t keyLen = strlen(objKey);
+    if (!entry.len || entry.pos < keyLen || entry.pos + entry.len > cached->len || memcmp(cached->data + entry.pos - keyLen, objKey, keyLen) != 0) {
+      dest->clear();
+      return false;
+    }
+    const char *json = reinterpret_cast<const char*>(cached->data) + entry.pos;
+    if (filter) deserializeJson(*dest, json, entry.len, DeserializationOption::Filter(*filter));
+    else        deserializeJson(*dest, json, entry.len);
+    DEBUGFS_PRINTF("Read (cached), took %lu ms\n", millis() - s);
+    return true;
+  }
+  #else
+  f = WLED_FS.open(fileName, "r");
+  addFSStats(1, 0, 0);
+  #endif
+  if (!f) return false;
+  uint32_t us = micros();
+  if (checkPresetIndex() ? !findIndexedPreset(id) : !bufferedFind(objKey)) { // fall back to search if index is unavailable
+    f.close();
+    dest->clear();
+    DEBUGFS_PRINTLN(F("Obj not found."));
+    return false;
+  }
+
+  if (filter) deserializeJson(*dest, f, DeserializationOption::Filter(*filter));
+  else        deserializeJson(*dest, f);
+
+  addFSStats(0, f.position(), micros() - us);
+  f.close();
+  DEBUGFS_PRINTF("Read, took %lu ms\n", millis() - s);
+  return true;
 }
 
 //if the key is a nullptr, deserialize entire object
 bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest, const JsonDocument* filter)
 {
+  FileLock lock;
   if (doCloseFile) closeFile();
   #ifdef WLED_DEBUG_FS
     DEBUGFS_PRINTF("Read from %s with key %s >>>\n", file, (key==nullptr)?"nullptr":key);
     uint32_t s = millis();
   #endif
   char fileName[129]; strncpy_P(fileName, file, 128); fileName[128] = 0; //use PROGMEM safe copy as FS.open() does not
+  #if WLED_FILE_CACHE_SIZE > 0
+  std::shared_ptr<FileCacheBlob> cached = getCachedFile(fileName, f);
+  if (cached) {
+    bool found = readObjectFromCache(*cached, key, dest, filter);
+    DEBUGFS_PRINTF("Read (cached), took %lu ms\n", millis() - s);
+    return found;
+  }
+  #else
   f = WLED_FS.open(fileName, "r");
+  addFSStats(1, 0, 0);
+  #endif
   if (!f) return false;
+  uint32_t us = micros();
 
   if (key != nullptr && !bufferedFind(key)) //key does not exist in file
   {
@@ -357,11 +1194,167 @@ bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest, c
   if (filter) deserializeJson(*dest, f, DeserializationOption::Filter(*filter));
   else        deserializeJson(*dest, f);
 
+  addFSStats(0, f.position(), micros() - us);
   f.close();
   DEBUGFS_PRINTF("Read, took %lu ms\n", millis() - s);
   return true;
 }
 
+/*
+ * Background file writer (ESP32)
+ * Presets and configuration are serialized into RAM on the loop task and written to flash by a low priority task
+ * so that LED updates are not stalled for the duration of the flash write. Whole files are written to a temporary
+ * file first and then renamed, so a crash or power loss during write leaves the previous file intact.
+ * Jobs are processed in order; writeXXXInBackground() returns false if the job could not be queued (caller
+ * keeps ownership of data and should write synchronously).
+ */
+#ifdef ARDUINO_ARCH_ESP32
+#ifndef WLED_FS_WRITER_QUEUE
+#define WLED_FS_WRITER_QUEUE 8
+#endif
+
+typedef struct FileWriteJob {
+  const char *file;   // PROGMEM file name (i.e. s_cfg_json or getPresetsFileName())
+  char       *data;   // serialized JSON allocated with p_malloc(), nullptr to delete object
+  size_t      len;
+  int16_t     id;     // object id within file or -1 for whole file
+  bool        backup; // backup existing file before writing
+} fwj;
+
+static QueueHandle_t fileWriteQueue = nullptr;
+static TaskHandle_t  fileWriteTask = nullptr;
+
+static bool writeWholeFile(const char *file, const char *data, size_t len) {
+  invalidateFileCache();
+  char fileName[33], tmpName[37];
+  strncpy_P(fileName, file, 32); fileName[32] = 0; //use PROGMEM safe copy as FS.open() does not
+  snprintf_P(tmpName, sizeof(tmpName), PSTR("%s.tmp"), fileName);
+  File tmp = WLED_FS.open(tmpName, "w");
+  if (!tmp) return false;
+  bool success = tmp.write(reinterpret_cast<const uint8_t*>(data), len) == len;
+  tmp.close();
+  if (success) {
+    // LittleFS replaces existing file on rename, others may not
+    success = WLED_FS.rename(tmpName, fileName) || (WLED_FS.remove(fileName) && WLED_FS.rename(tmpName, fileName));
+  }
+  if (!success) WLED_FS.remove(tmpName);
+  return success;
+}
+
+// writes object into a copy of the file that then replaces it, so an interrupted write (i.e. power loss) does not damage the file
+static bool writeObjectToFileCopy(const char *file, uint16_t id, const JsonDocument *content) {
+  #ifdef WLED_ENABLE_PRESET_STORE
+  if (isPresetIndexed(file, id)) return writeObjectToFileUsingId(file, id, content); // store is append only
+  #endif
+  char fileName[33], tmpName[37];
+  strncpy_P(fileName, file, 32); fileName[32] = 0; //use PROGMEM safe copy as FS.open() does not
+  snprintf_P(tmpName, sizeof(tmpName), PSTR("%s.tmp"), fileName);
+  if (doCloseFile) closeFile();
+  if (WLED_FS.exists(fileName) && !copyFile(fileName, tmpName)) return false;
+  char objKey[10];
+  sprintf(objKey, "\"%d\":", id);
+  presetIndexId = isPresetIndexed(file, id) ? id : -1; // copy has the same layout, index is valid for it
+  bool success = writeObjectToFile(tmpName, objKey, content);
+  presetIndexId = -1;
+  if (doCloseFile) closeFile();
+  if (success) {
+    // LittleFS replaces existing file on rename, others may not
+    success = WLED_FS.rename(tmpName, fileName) || (WLED_FS.remove(fileName) && WLED_FS.rename(tmpName, fileName));
+  }
+  if (!success) {
+    WLED_FS.remove(tmpName);
+    presetIndexValid = false; // may have been updated for the copy
+  }
+  return success;
+}
+
+static void fileWriterTask(void *) {
+  FileWriteJob job;
+  for (;;) {
+    // job stays in queue until it is written so that isFileWritePending() covers the write itself
+    if (xQueuePeek(fileWriteQueue, &job, portMAX_DELAY) != pdTRUE) continue;
+    #ifdef WLED_DEBUG_FS
+    uint32_t s = millis();
+    #endif
+    bool success;
+    {
+      FileLock lock;
+      if (job.id < 0) {
+        if (job.backup) backupFile(job.file);
+        success = writeWholeFile(job.file, job.data, job.len);
+      } else {
+        StaticJsonDocument<64> doc; // holds serialized object as raw JSON (not copied)
+        if (job.data) doc.set(serialized(const_cast<const char*>(job.data), job.len));
+        success = writeObjectToFileCopy(job.file, job.id, &doc);
+        presetsWriteCount++; // file may have changed even if write failed
+      }
+    }
+    DEBUGFS_PRINTF("Background write %s (%d), took %lu ms\n", job.file, (int)job.id, millis() - s);
+    if (success) {
+      if (job.id >= 0) presetsModifiedTime = toki.second(); // only presets are written as objects, UI reloads presets when changed
+      updateFSInfo();
+    } else errorFlag = ERR_FS_GENERAL;
+    p_free(job.data);
+    xQueueReceive(fileWriteQueue, &job, 0);
+  }
+}
+
+static bool queueFileWrite(const FileWriteJob &job) {
+  if (!fileWriteQueue) {
+    fileWriteQueue = xQueueCreate(WLED_FS_WRITER_QUEUE, sizeof(FileWriteJob));
+    if (!fileWriteQueue) return false;
+    // same priority as loop task, flash access is handled in short chunks by the FS driver
+    if (xTaskCreatePinnedToCore(fileWriterTask, "FS_WRITER", 6144, nullptr, 1, &fileWriteTask, 0) != pdPASS) {
+      vQueueDelete(fileWriteQueue);
+      fileWriteQueue = nullptr;
+      return false;
+    }
+  }
+  return xQueueSend(fileWriteQueue, &job, 0) == pdTRUE;
+}
+#endif
+
+// takes ownership of data (allocated with p_malloc()) on success
+bool writeFileInBackground(const char *file, char *data, size_t len, bool backup) {
+  #ifdef ARDUINO_ARCH_ESP32
+  return queueFileWrite({file, data, len, -1, backup});
+  #else
+  return false;
+  #endif
+}
+
+// takes ownership of data (allocated with p_malloc()) on success, nullptr data deletes object
+bool writeObjectInBackground(const char *file, uint16_t id, char *data, size_t len) {
+  #ifdef ARDUINO_ARCH_ESP32
+  return queueFileWrite({file, data, len, (int16_t)id, false});
+  #else
+  return false;
+  #endif
+}
+
+// excludes writes made through this module while other code (i.e. another task) accesses files, returns false on timeout
+bool lockFileSystem(unsigned waitMs) {
+  #ifdef ARDUINO_ARCH_ESP32
+  return xSemaphoreTakeRecursive(fileMutex, pdMS_TO_TICKS(waitMs)) == pdTRUE;
+  #else
+  return true;
+  #endif
+}
+
+void unlockFileSystem() {
+  #ifdef ARDUINO_ARCH_ESP32
+  xSemaphoreGiveRecursive(fileMutex);
+  #endif
+}
+
+bool isFileWritePending() {
+  #ifdef ARDUINO_ARCH_ESP32
+  return fileWriteQueue && uxQueueMessagesWaiting(fileWriteQueue);
+  #else
+  return false;
+  #endif
+}
+
 void updateFSInfo() {
   #ifdef ARDUINO_ARCH_ESP32
     #if WLED_FS == LITTLEFS || ESP_IDF_VERSION_MAJOR >= 4
@@ -379,63 +1372,35 @@ void updateFSInfo() {
 }
 
 
-#ifdef ARDUINO_ARCH_ESP32
-// caching presets in PSRAM may prevent occasional flashes seen when HomeAssitant polls WLED
-// original idea by @akaricchi (https://github.com/Akaricchi)
-// returns a pointer to the PSRAM buffer, updates size parameter
-static const uint8_t *getPresetCache(size_t &size) {
-  static unsigned long presetsCachedTime = 0;
-  static uint8_t *presetsCached = nullptr;
-  static size_t presetsCachedSize = 0;
-  static byte presetsCachedValidate = 0;
-
-  //if (presetsModifiedTime != presetsCachedTime) DEBUG_PRINTLN(F("getPresetCache(): presetsModifiedTime changed."));
-  //if (presetsCachedValidate != cacheInvalidate) DEBUG_PRINTLN(F("getPresetCache(): cacheInvalidate changed."));
-
-  if ((presetsModifiedTime != presetsCachedTime) || (presetsCachedValidate != cacheInvalidate)) {
-    if (presetsCached) {
-      p_free(presetsCached);
-      presetsCached = nullptr;
-    }
-  }
-
-  if (!presetsCached) {
-    File file = WLED_FS.open(FPSTR(getPresetsFileName()), "r");
-    if (file) {
-      presetsCachedTime = presetsModifiedTime;
-      presetsCachedValidate = cacheInvalidate;
-      presetsCachedSize = 0;
-      presetsCached = (uint8_t*)p_malloc(file.size() + 1);
-      if (presetsCached) {
-        presetsCachedSize = file.size();
-        file.read(presetsCached, presetsCachedSize);
-        presetsCached[presetsCachedSize] = 0;
-        file.close();
-      }
-    }
-  }
-
-  size = presetsCachedSize;
-  return presetsCached;
-}
-#endif
-
 bool handleFileRead(AsyncWebServerRequest* request, String path){
   DEBUGFS_PRINT(F("WS FileRead: ")); DEBUGFS_PRINTLN(path);
   if(path.endsWith("/")) path += "index.htm";
   if(path.indexOf(F("sec")) > -1) return false;
-  #ifdef BOARD_HAS_PSRAM
-  if (path.endsWith(FPSTR(getPresetsFileName()))) {
-    size_t psize;
-    const uint8_t *presets = getPresetCache(psize);
-    if (presets) {
-      AsyncWebServerResponse *response = request->beginResponse_P(200, FPSTR(CONTENT_TYPE_JSON), presets, psize);
-      request->send(response);
+  // presets and config are written by background writer task: wait for it a bit, do not stall web server for the duration of a write
+  // other files are served right away (file cache is skipped while the file system is busy)
+  bool writtenInBackground = path.equals(FPSTR(getPresetsFileName())) || path.equals(F("/cfg.json"));
+  FileLock lock(writtenInBackground ? WLED_FS_HTTP_LOCK_WAIT : 0);
+  if (!lock && writtenInBackground) {
+    request->send(503, FPSTR(CONTENT_TYPE_PLAIN), F("File system busy"));
+    return true;
+  }
+  #ifdef WLED_ENABLE_PRESET_STORE
+  if (path.equals(FPSTR(getPresetsFileName())) && sendPresetStore(request)) return true; // export
+  #endif
+  #if WLED_FILE_CACHE_SIZE > 0
+  // serving presets from cache may prevent occasional flashes seen when HomeAssitant polls WLED (idea by @akaricchi)
+  if (lock && path.endsWith(F(".json")) && !request->hasArg(F("download"))) {
+    File file;
+    std::shared_ptr<FileCacheBlob> cached = getCachedFile(path.c_str(), file);
+    file.close();
+    if (cached) {
+      request->send(new CachedFileResponse(cached, FPSTR(CONTENT_TYPE_JSON)));
       return true;
     }
   }
   #endif
   if(WLED_FS.exists(path) || WLED_FS.exists(path + ".gz")) {
+    addFSStats(1, 0, 0);
     request->send(request->beginResponse(WLED_FS, path, {}, request->hasArg(F("download")), {}));
     return true;
   }
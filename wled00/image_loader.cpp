@@ -15,28 +15,60 @@ static GifDecoder<320,320,12,true> decoder;  // this creates the basic object; p
 static bool gifDecodeFailed = false;
 static unsigned long lastFrameDisplayTime = 0, currentFrameDelay = 0;
 
+// the decoder reads from memory (gifData) if the whole file was loaded, otherwise from file through a read-ahead buffer
+static const uint8_t *gifData = nullptr;
+static size_t gifDataSize = 0, gifDataPos = 0;
+static uint8_t readBuf[256];
+static size_t readBufLen = 0, readBufPos = 0;
+
 bool fileSeekCallback(unsigned long position) {
+  if (gifData) {
+    if (position > gifDataSize) return false;
+    gifDataPos = position;
+    return true;
+  }
+  readBufLen = readBufPos = 0; // drop read-ahead
   return file.seek(position);
 }
 
 unsigned long filePositionCallback(void) {
-  return file.position();
+  if (gifData) return gifDataPos;
+  return file.position() - (readBufLen - readBufPos);
 }
 
 int fileReadCallback(void) {
-  return file.read();
+  if (gifData) return gifDataPos < gifDataSize ? gifData[gifDataPos++] : -1;
+  if (readBufPos >= readBufLen) {
+    readBufLen = file.read(readBuf, sizeof(readBuf));
+    readBufPos = 0;
+    if (readBufLen == 0) return -1;
+  }
+  return readBuf[readBufPos++];
 }
 
 int fileReadBlockCallback(void * buffer, int numberOfBytes) {
-  return file.read((uint8_t*)buffer, numberOfBytes);
+  if (numberOfBytes <= 0) return 0;
+  if (gifData) {
+    size_t len = min((size_t)numberOfBytes, gifDataSize - gifDataPos);
+    memcpy(buffer, gifData + gifDataPos, len);
+    gifDataPos += len;
+    return len;
+  }
+  size_t len = min((size_t)numberOfBytes, readBufLen - readBufPos); // consume read-ahead first
+  memcpy(buffer, readBuf + readBufPos, len);
+  readBufPos += len;
+  if (len < (size_t)numberOfBytes) len += file.read((uint8_t*)buffer + len, numberOfBytes - len);
+  return len;
 }
 
 int fileSizeCallback(void) {
+  if (gifData) return gifDataSize;
   return file.size();
 }
 
 bool openGif(const char *filename) {  // side-effect: updates "file"
   file = WLED_FS.open(filename, "r");
+  readBufLen = readBufPos = 0;
   DEBUG_PRINTF_P(PSTR("opening GIF file %s\n"), filename);
 
   if (!file) return false;
@@ -52,14 +84,17 @@ void screenClearCallback(void) {
   activeSeg->fill(0);
 }
 
+static void blurImage(Segment &seg) {
+  if (seg.intensity > 1) {
+    uint8_t blurAmount = seg.intensity;
+    if ((blurAmount < 24) && (seg.is2D())) seg.blurRows(seg.intensity);  // some blur - fast
+    else seg.blur(blurAmount);                                          // more blur - slower
+  }
+}
+
 // this callback runs when the decoder has finished painting all pixels
 void updateScreenCallback(void) {
-  // perfect time for adding blur
-  if (activeSeg->intensity > 1) {
-    uint8_t blurAmount = activeSeg->intensity;
-    if ((blurAmount < 24) && (activeSeg->is2D())) activeSeg->blurRows(activeSeg->intensity);  // some blur - fast
-    else activeSeg->blur(blurAmount);                                                         // more blur - slower
-  }
+  blurImage(*activeSeg); // perfect time for adding blur
   lastCoordinate = -1; // invalidate last position
 }
 
@@ -104,12 +139,354 @@ void drawPixelCallback2D(int16_t x, int16_t y, uint8_t red, uint8_t green, uint8
 #define IMAGE_ERROR_DECODER_ALLOC 5
 #define IMAGE_ERROR_GIF_DECODE 6
 #define IMAGE_ERROR_FRAME_DECODE 7
+#define IMAGE_ERROR_NOT_CACHED 253
 #define IMAGE_ERROR_WAITING 254
 #define IMAGE_ERROR_PREV 255
 
+#if WLED_GIF_CACHE_SIZE > 0
+/*
+ * Pre-decoded GIF frame cache (PSRAM)
+ * Small GIFs are decoded once into RGB565 frames at their native resolution, playback then only scales cached
+ * frames to the segment. Frames are decoded one at a time while the image is first played (no decoding spikes).
+ * Each segment keeps its own playback position (in segment data), so any number of
+ * segments can play cached images concurrently. Larger GIFs are streamed through the (single) decoder as before.
+ */
+typedef struct GifCacheEntry {
+  char          name[WLED_MAX_SEGNAME_LEN+2]; // file name incl. leading '/'
+  uint16_t     *delays;   // frame delays in ms followed by frames * width * height RGB565 pixels, nullptr if unused
+  uint16_t     *pixels;
+  size_t        size;     // allocated bytes
+  uint16_t      width, height, frames;
+  uint16_t      decoded;  // frames decoded so far (entry is complete if decoded == frames)
+  uint32_t      id;       // unique id, segments refer to entries by id
+  unsigned long used;     // millis() of last use (LRU)
+  uint8_t       generation;
+} gce;
+static GifCacheEntry gifCache[WLED_GIF_CACHE_ENTRIES];
+static uint32_t gifCacheNextId = 1;
+static volatile uint8_t gifCacheGeneration = 0; // incremented when a GIF is uploaded (entries are released in loop context)
+
+// per segment playback state (kept in segment data)
+typedef struct ImagePlayback {
+  char          name[WLED_MAX_SEGNAME_LEN+2];
+  uint32_t      id;       // cache entry being played, 0 if none
+  uint16_t      frame;
+  bool          notCached;
+  uint8_t       generation;     // gifCacheGeneration when caching failed
+  unsigned long notCachedTime;  // millis() when caching failed (retried after WLED_GIF_CACHE_RETRY)
+  unsigned long lastFrameTime;
+  unsigned long frameDelay;
+} ipb;
+
+static uint16_t *cacheFrame = nullptr;          // frame being decoded into cache
+static GifCacheEntry *gifCacheFill = nullptr;   // entry being decoded (by activeSeg, using the decoder)
+static uint8_t *gifCacheFillData = nullptr;     // GIF file contents while entry is decoded
+
+void screenClearCallbackCache(void) {
+  memset(cacheFrame, 0, gifWidth * gifHeight * sizeof(uint16_t));
+}
+
+void updateScreenCallbackCache(void) {}
+
+void drawPixelCallbackCache(int16_t x, int16_t y, uint8_t red, uint8_t green, uint8_t blue) {
+  if (x < 0 || y < 0 || x >= gifWidth || y >= gifHeight) return;
+  cacheFrame[y * gifWidth + x] = ((red & 0xF8) << 8) | ((green & 0xFC) << 3) | (blue >> 3);
+}
+
+static inline uint32_t colorFromRGB565(uint16_t c) {
+  uint8_t r = (c >> 8) & 0xF8, g = (c >> 3) & 0xFC, b = c << 3;
+  return RGBW32(r | r >> 5, g | g >> 6, b | b >> 5, 0);
+}
+
+// walks GIF block structure, returns number of frames (0 if data is not a GIF)
+static unsigned countGifFrames(const uint8_t *data, size_t size) {
+  if (size < 13 || strncmp((const char*)data, "GIF", 3) != 0) return 0;
+  size_t pos = 13;
+  if (data[10] & 0x80) pos += 3 << ((data[10] & 0x07) + 1); // global color table
+  unsigned frames = 0;
+  while (pos < size) {
+    switch (data[pos++]) {
+      case 0x21: // extension: label followed by data sub-blocks
+        pos++;
+        break;
+      case 0x2C: // image descriptor, optional local color table, LZW code size followed by data sub-blocks
+        if (pos + 9 > size) return frames;
+        if (data[pos+8] & 0x80) pos += 3 << ((data[pos+8] & 0x07) + 1);
+        pos += 10;
+        frames++;
+        break;
+      case 0x3B: // trailer
+        return frames;
+      default:
+        return 0;
+    }
+    while (pos < size && data[pos]) pos += data[pos] + 1; // skip data sub-blocks
+    pos++;
+  }
+  return frames;
+}
+
+static void releaseCachedImage(GifCacheEntry &e) {
+  p_free(e.delays);
+  e.delays = e.pixels = nullptr;
+  e.size = 0;
+  e.id = 0;
+}
+
+// returns complete entry by name or (possibly incomplete) entry by id
+static GifCacheEntry *findCachedImage(const char *name, uint32_t id) {
+  if (gifCacheFill && gifCacheFill->generation != gifCacheGeneration) endImagePlayback(activeSeg); // image replaced while decoding
+  for (auto &e : gifCache) if (e.delays && e.generation != gifCacheGeneration) releaseCachedImage(e);
+  for (auto &e : gifCache) if (e.delays && (id ? e.id == id : (e.decoded == e.frames && strcmp(e.name, name) == 0))) {
+    e.used = millis();
+    return &e;
+  }
+  return nullptr;
+}
+
+// images that can not be cached regardless of available memory (too large, decoding error), not retried until a GIF is uploaded
+static struct { char name[WLED_MAX_SEGNAME_LEN+2]; uint8_t generation; } gifNotCacheable[4];
+static unsigned gifNotCacheableNext = 0;
+
+static bool isImageNotCacheable(const char *name) {
+  for (const auto &n : gifNotCacheable) if (n.generation == gifCacheGeneration && strcmp(n.name, name) == 0) return true;
+  return false;
+}
+
+static void setImageNotCacheable(const char *name) {
+  auto &n = gifNotCacheable[gifNotCacheableNext++ % 4];
+  strlcpy(n.name, name, sizeof(n.name));
+  n.generation = gifCacheGeneration;
+}
+
+// ends decoding into cache entry gifCacheFill, entry is released unless all frames were decoded
+static void endImageCaching() {
+  if (!gifCacheFill) return;
+  GifCacheEntry &e = *gifCacheFill;
+  decoder.dealloc();
+  gifData = nullptr;
+  p_free(gifCacheFillData);
+  gifCacheFillData = nullptr;
+  cacheFrame = nullptr;
+  gifWidth = gifHeight = 0;
+  gifCacheFill = nullptr;
+  activeSeg = nullptr;
+  if (e.decoded < e.frames) releaseCachedImage(e);
+  else DEBUG_PRINTF_P(PSTR("GIF cache: %s %ux%u, %u frames, %u bytes\n"), e.name, e.width, e.height, e.frames, e.size);
+}
+
+// prepares cache entry for a GIF and starts decoding it (frames are decoded during playback, see decodeCachedFrame())
+// returns IMAGE_ERROR_NONE, IMAGE_ERROR_SEG_LIMIT if decoder is busy or IMAGE_ERROR_NOT_CACHED if the image can not be cached
+static byte cacheImage(const char *fileName, Segment &seg, GifCacheEntry **entry) {
+  if (!psramFound()) return IMAGE_ERROR_NOT_CACHED;
+  if (activeSeg && activeSeg != &seg && !gifDecodeFailed && activeSeg->isActive()) return IMAGE_ERROR_SEG_LIMIT; // another image is decoded
+  size_t fnameLen = strlen(fileName);
+  if ((fnameLen < 4) || strcmp(fileName + fnameLen - 4, ".gif") != 0) return IMAGE_ERROR_NOT_CACHED;
+
+  uint32_t readStart = micros();
+  File f = WLED_FS.open(fileName, "r");
+  size_t fileSize = f ? f.size() : 0;
+  if (fileSize == 0 || fileSize > WLED_GIF_CACHE_MAX_FILE) {
+    if (fileSize) setImageNotCacheable(fileName);
+    return IMAGE_ERROR_NOT_CACHED;
+  }
+  uint8_t *data = static_cast<uint8_t*>(p_malloc(fileSize));
+  if (!data) return IMAGE_ERROR_NOT_CACHED;
+  bool ok = f.read(data, fileSize) == fileSize; // single block read
+  accountFileRead(fileSize, micros() - readStart);
+  f.close();
+  unsigned frames = ok ? countGifFrames(data, fileSize) : 0;
+  size_t width  = frames ? data[6] | data[7] << 8 : 0; // logical screen size
+  size_t height = frames ? data[8] | data[9] << 8 : 0;
+  size_t size = frames * (sizeof(uint16_t) + width * height * sizeof(uint16_t));
+  if (width * height == 0 || size > WLED_GIF_CACHE_SIZE) {
+    p_free(data);
+    if (ok) setImageNotCacheable(fileName);
+    return IMAGE_ERROR_NOT_CACHED;
+  }
+
+  // release least recently used entries until new one fits
+  GifCacheEntry *e = nullptr;
+  for (;;) {
+    size_t used = 0;
+    GifCacheEntry *lru = nullptr;
+    e = nullptr;
+    for (auto &c : gifCache) {
+      used += c.size;
+      if (!c.delays) e = &c;
+      else if (&c != gifCacheFill && (!lru || c.used < lru->used)) lru = &c;
+    }
+    if (e && used + size <= WLED_GIF_CACHE_SIZE) break;
+    if (!lru) break;
+    DEBUG_PRINTF_P(PSTR("GIF cache: releasing %s\n"), lru->name);
+    releaseCachedImage(*lru);
+  }
+  if (e) e->delays = static_cast<uint16_t*>(p_malloc(size));
+  if (!e || !e->delays) {
+    p_free(data);
+    return IMAGE_ERROR_NOT_CACHED;
+  }
+  e->pixels = e->delays + frames;
+  strlcpy(e->name, fileName, sizeof(e->name));
+  e->size = size;
+  e->width = width;
+  e->height = height;
+  e->frames = frames;
+  e->decoded = 0;
+  e->id = gifCacheNextId++;
+  e->used = millis();
+  e->generation = gifCacheGeneration;
+
+  if (activeSeg) endImagePlayback(activeSeg); // takes over decoder (stale or own streaming playback), segment keeps showing last frame
+  activeSeg = &seg;
+  gifCacheFill = e;
+  gifCacheFillData = data;
+  gifData = data;
+  gifDataSize = fileSize;
+  gifDataPos = 0;
+  decoder.setScreenClearCallback(screenClearCallbackCache);
+  decoder.setUpdateScreenCallback(updateScreenCallbackCache);
+  decoder.setDrawPixelCallback(drawPixelCallbackCache);
+  decoder.setFileSeekCallback(fileSeekCallback);
+  decoder.setFilePositionCallback(filePositionCallback);
+  decoder.setFileReadCallback(fileReadCallback);
+  decoder.setFileReadBlockCallback(fileReadBlockCallback);
+  decoder.setFileSizeCallback(fileSizeCallback);
+#if __cpp_exceptions
+  try {
+#endif
+  decoder.alloc();
+#if __cpp_exceptions
+  } catch (...) {
+    endImageCaching();
+    return IMAGE_ERROR_NOT_CACHED;
+  }
+#endif
+  gifWidth = width;
+  gifHeight = height;
+  ok = decoder.startDecoding() >= 0;
+  if (ok) {
+    uint16_t w, h;
+    decoder.getSize(&w, &h);
+    ok = w == width && h == height;
+  }
+  if (!ok) {
+    DEBUG_PRINTF_P(PSTR("GIF cache: decoding %s failed\n"), fileName);
+    setImageNotCacheable(fileName);
+    endImageCaching();
+    return IMAGE_ERROR_NOT_CACHED;
+  }
+  *entry = e;
+  return IMAGE_ERROR_NONE;
+}
+
+// decodes next frame of the image being cached (one frame per displayed frame, no decoding spikes), returns false on error
+static bool decodeCachedFrame(GifCacheEntry &e) {
+  const size_t frameSize = e.width * e.height;
+  cacheFrame = e.pixels + e.decoded * frameSize;
+  if (e.decoded) memcpy(cacheFrame, cacheFrame - frameSize, frameSize * sizeof(uint16_t)); // frames may only update parts of the image
+  else           memset(cacheFrame, 0, frameSize * sizeof(uint16_t));
+  bool ok = decoder.decodeFrame(false) >= 0;
+  e.delays[e.decoded] = decoder.getFrameDelay_ms();
+  if (ok) e.decoded++;
+  else {
+    DEBUG_PRINTF_P(PSTR("GIF cache: decoding %s failed\n"), e.name);
+    setImageNotCacheable(e.name);
+  }
+  if (!ok || e.decoded == e.frames) endImageCaching();
+  return ok;
+}
+
+// draws cached frame scaled to segment (nearest neighbor)
+static void drawCachedFrame(Segment &seg, const GifCacheEntry &e, unsigned frame) {
+  const uint16_t *px = e.pixels + frame * e.width * e.height;
+  if (seg.is2D()) {
+    const int w = seg.vWidth(), h = seg.vHeight();
+    for (int y = 0; y < h; y++) {
+      const uint16_t *row = px + (y * e.height / h) * e.width;
+      for (int x = 0; x < w; x++) seg.setPixelColorXY(x, y, colorFromRGB565(row[x * e.width / w]));
+    }
+  } else {
+    const int len = seg.vLength();
+    int totalImgPix = (int)e.width * e.height;
+    if (totalImgPix - len == 1) totalImgPix--; // skip padded last pixel (see renderImageToSegment())
+    for (int i = 0; i < len; i++) seg.setPixelColor(i, colorFromRGB565(px[i * totalImgPix / len]));
+  }
+  blurImage(seg);
+}
+
+// plays image from cache, returns IMAGE_ERROR_NOT_CACHED if the image has to be streamed
+static byte renderCachedImage(Segment &seg) {
+  if (!seg.allocateData(sizeof(ImagePlayback))) return IMAGE_ERROR_NOT_CACHED;
+  ImagePlayback *pb = reinterpret_cast<ImagePlayback*>(seg.data);
+  if (strncmp(pb->name +1, seg.name, WLED_MAX_SEGNAME_LEN) != 0) { // segment name changed
+    memset(pb, 0, sizeof(ImagePlayback));
+    strcpy(pb->name, "/");
+    strncpy(pb->name +1, seg.name, WLED_MAX_SEGNAME_LEN);
+    pb->name[WLED_MAX_SEGNAME_LEN+1] = '\0';
+  }
+  if (isImageNotCacheable(pb->name)) return IMAGE_ERROR_NOT_CACHED; // stay on streaming path
+  if (pb->notCached) {
+    // image may have been replaced or memory may have become available meanwhile
+    if (pb->generation == gifCacheGeneration && millis() - pb->notCachedTime < WLED_GIF_CACHE_RETRY) return IMAGE_ERROR_NOT_CACHED;
+    pb->notCached = false;
+  }
+
+  GifCacheEntry *e = pb->id ? findCachedImage(pb->name, pb->id) : nullptr;
+  if (!e) {
+    e = findCachedImage(pb->name, 0); // cached by another segment or evicted and reloaded
+    if (!e) {
+      byte result = cacheImage(pb->name, seg, &e);
+      if (result == IMAGE_ERROR_NOT_CACHED) {
+        pb->notCached = true;
+        pb->generation = gifCacheGeneration;
+        pb->notCachedTime = millis();
+      }
+      if (result != IMAGE_ERROR_NONE) return result;
+    }
+    pb->id = e->id;
+    pb->frame = 0;
+    pb->frameDelay = 0;
+  }
+
+  // same timing as streamed playback, see below
+  uint32_t wait = pb->frameDelay * 2 - seg.speed * pb->frameDelay / 128;
+  if (millis() - pb->lastFrameTime < wait) return IMAGE_ERROR_WAITING;
+
+  if (e->decoded < e->frames) { // image is being cached: show frames as they are decoded
+    if (e != gifCacheFill || activeSeg != &seg) return IMAGE_ERROR_SEG_LIMIT; // sanity check: decoded by another segment
+    pb->frame = e->decoded;
+    if (!decodeCachedFrame(*e)) { // remembered as not cacheable, continue streaming
+      pb->id = 0;
+      return IMAGE_ERROR_NOT_CACHED;
+    }
+  }
+  if (pb->frame >= e->frames) pb->frame = 0;
+  drawCachedFrame(seg, *e, pb->frame);
+
+  pb->frameDelay = e->delays[pb->frame];
+  unsigned long tooSlowBy = (millis() - pb->lastFrameTime) - wait;
+  pb->frameDelay = tooSlowBy > pb->frameDelay ? 0 : pb->frameDelay - tooSlowBy;
+  pb->lastFrameTime = millis();
+  pb->frame++;
+  return IMAGE_ERROR_NONE;
+}
+#endif
+
+// drops pre-decoded frames of all images (call when a .gif file is modified, may be called from web server task)
+void invalidateImageCache() {
+  #if WLED_GIF_CACHE_SIZE > 0
+  gifCacheGeneration++;
+  #endif
+}
+
 // renders an image (.gif only; .bmp and .fseq to be added soon) from FS to a segment
 byte renderImageToSegment(Segment &seg) {
   if (!seg.name) return IMAGE_ERROR_NO_NAME;
+  #if WLED_GIF_CACHE_SIZE > 0
+  byte cached = renderCachedImage(seg);
+  if (cached != IMAGE_ERROR_NOT_CACHED) return cached;
+  #endif
   // disable during effect transition, causes flickering, multiple allocations and depending on image, part of old FX remaining
   //if (seg.mode != seg.currentMode()) return IMAGE_ERROR_WAITING;
   if (activeSeg && activeSeg != &seg) {            // only one segment at a time
@@ -225,6 +602,9 @@ byte renderImageToSegment(Segment &seg) {
 void endImagePlayback(Segment *seg) {
   DEBUG_PRINTLN(F("Image playback end called"));
   if (!activeSeg || activeSeg != seg) return;
+  #if WLED_GIF_CACHE_SIZE > 0
+  endImageCaching(); // partially decoded image is released
+  #endif
   if (file) file.close();
   decoder.dealloc();
   gifDecodeFailed = false;
@@ -66,6 +66,31 @@ namespace {
 
     return d;
   }
+
+  SegmentCopy copyOf(const Segment& seg) {
+    return {
+      {seg.colors[0], seg.colors[1], seg.colors[2]},
+      seg.start,
+      seg.stop,
+      seg.offset,
+      seg.grouping,
+      seg.spacing,
+      seg.startY,
+      seg.stopY,
+      seg.options,
+      seg.mode,
+      seg.palette,
+      seg.opacity,
+      seg.speed,
+      seg.intensity,
+      seg.custom1,
+      seg.custom2,
+      seg.custom3,
+      seg.check1,
+      seg.check2,
+      seg.check3
+    };
+  }
 }
 
 static bool deserializeSegment(JsonObject elem, byte it, byte presetId = 0)
@@ -88,28 +113,7 @@ static bool deserializeSegment(JsonObject elem, byte it, byte presetId = 0)
   Segment& seg = strip.getSegment(id);
   // we do not want to make segment copy as it may use a lot of RAM (effect data and pixel buffer)
   // so we will create a copy of segment options and compare it with original segment when done processing
-  SegmentCopy prev = {
-    {seg.colors[0], seg.colors[1], seg.colors[2]},
-    seg.start,
-    seg.stop,
-    seg.offset,
-    seg.grouping,
-    seg.spacing,
-    seg.startY,
-    seg.stopY,
-    seg.options,
-    seg.mode,
-    seg.palette,
-    seg.opacity,
-    seg.speed,
-    seg.intensity,
-    seg.custom1,
-    seg.custom2,
-    seg.custom3,
-    seg.check1,
-    seg.check2,
-    seg.check3
-  };
+  SegmentCopy prev = copyOf(seg);
 
   int start = elem["start"] | seg.start;
   if (stop < 0) {
@@ -365,6 +369,441 @@ static bool deserializeSegment(JsonObject elem, byte it, byte presetId = 0)
   return true;
 }
 
+#if WLED_PRESET_CACHE_SIZE > 0
+/*
+ * Compact (pre-parsed) state used by preset cache
+ * Holds only plain values of a preset (no relative, random or toggle values, no HTTP API, playlist, nightlight etc.)
+ * so it can be applied repeatedly without JSON buffer. compactState() returns nullptr if preset cannot be represented.
+ */
+#define CSEG_START   0x000001
+#define CSEG_STOP    0x000002
+#define CSEG_STARTY  0x000004
+#define CSEG_STOPY   0x000008
+#define CSEG_GRP     0x000010
+#define CSEG_SPC     0x000020
+#define CSEG_OF      0x000040
+#define CSEG_BRI     0x000080
+#define CSEG_CCT     0x000100
+#define CSEG_SET     0x000200
+#define CSEG_NAME    0x000400
+#define CSEG_FX      0x000800
+#define CSEG_SX      0x001000
+#define CSEG_IX      0x002000
+#define CSEG_PAL     0x004000
+#define CSEG_C1      0x008000
+#define CSEG_C2      0x010000
+#define CSEG_C3      0x020000
+#define CSEG_SI      0x040000
+#define CSEG_M12     0x080000
+#define CSEG_BM      0x100000
+#define CSEG_COL     0x200000 // "col" array present (even if all colors are skipped)
+
+// boolean segment options (presence and value bits)
+#define CSEG_B_ON    0x0001
+#define CSEG_B_FRZ   0x0002
+#define CSEG_B_SEL   0x0004
+#define CSEG_B_REV   0x0008
+#define CSEG_B_MI    0x0010
+#define CSEG_B_RY    0x0020
+#define CSEG_B_MY    0x0040
+#define CSEG_B_TP    0x0080
+#define CSEG_B_O1    0x0100
+#define CSEG_B_O2    0x0200
+#define CSEG_B_O3    0x0400
+
+#define CSTATE_ON          0x01
+#define CSTATE_BRI         0x02
+#define CSTATE_TRANSITION  0x04
+#define CSTATE_BS          0x08
+#define CSTATE_MAINSEG     0x10
+#define CSTATE_SEG         0x20
+
+namespace {
+  typedef struct {
+    uint32_t has;                 // CSEG_* fields present
+    uint32_t colors[NUM_COLORS];
+    int32_t  stop;
+    int32_t  offset;
+    uint16_t start, startY, stopY;
+    uint16_t boolHas, boolVal;    // CSEG_B_* options present and their values
+    uint16_t nameOfs;             // offset of segment name from start of CompactState
+    uint8_t  id;
+    uint8_t  colHas;              // bit per valid color in "col"
+    uint8_t  grouping, spacing, opacity, cct, set, mode, speed, intensity, palette;
+    uint8_t  custom1, custom2, custom3, soundSim, map1D2D, blendMode;
+  } CompactSegment;
+
+  typedef struct {
+    uint16_t size;                // total size including segments and names
+    uint8_t  has;                 // CSTATE_* fields present
+    uint8_t  on, bri, bs, mainseg;
+    uint8_t  segCount;
+    int32_t  transition;
+    CompactSegment seg[];         // followed by zero terminated segment names
+  } CompactState;
+
+  // returns false if the value is present but can not be represented (i.e. string with relative or random value)
+  template<typename T> bool compactVal(JsonVariant v, T &val, uint32_t &has, uint32_t flag) {
+    if (v.isNull()) return true;
+    if (v.is<const char*>()) return false;
+    if (v.is<T>()) { val = v.as<T>(); has |= flag; }
+    return true;
+  }
+
+  // same as getVal() (negative values are ignored)
+  bool compactByte(JsonVariant v, uint8_t &val, uint32_t &has, uint32_t flag) {
+    if (v.isNull()) return true;
+    if (v.is<const char*>()) return false;
+    if (v.is<int>() && v.as<int>() >= 0) { val = v.as<int>(); has |= flag; }
+    return true;
+  }
+
+  // same as getBoolVal() without toggle
+  bool compactBool(JsonVariant v, CompactSegment &cs, uint16_t flag) {
+    if (v.isNull()) return true;
+    if (v.is<const char*>()) return false;
+    if (v.is<bool>()) {
+      cs.boolHas |= flag;
+      if (v.as<bool>()) cs.boolVal |= flag;
+    }
+    return true;
+  }
+
+  bool compactSegment(JsonObject elem, CompactSegment &cs, byte it, char *&names) {
+    for (JsonPair kv : elem) {
+      // keys that are understood, anything else (i.e. "len", "rpt", "i", "fxdef", "lx") prevents caching
+      static const char keys[] = "|id|start|stop|startY|stopY|grp|spc|of|on|frz|bri|cct|set|lc|n|col|fx|sx|ix|pal|c1|c2|c3|sel|rev|mi|rY|mY|tp|o1|o2|o3|si|m12|bm|";
+      char key[10];
+      const char *k = kv.key().c_str();
+      if (strlen(k) > sizeof(key)-3) return false;
+      sprintf(key, "|%s|", k);
+      if (!strstr(keys, key)) return false;
+    }
+    cs.has = cs.boolHas = cs.boolVal = 0;
+    cs.id = elem["id"] | it;
+    cs.colHas = 0;
+    cs.nameOfs = 0;
+    if (!compactVal<uint16_t>(elem["start"],  cs.start,  cs.has, CSEG_START))  return false;
+    if (!compactVal<int32_t>(elem["stop"],    cs.stop,   cs.has, CSEG_STOP))   return false;
+    if (!compactVal<uint16_t>(elem["startY"], cs.startY, cs.has, CSEG_STARTY)) return false;
+    if (!compactVal<uint16_t>(elem["stopY"],  cs.stopY,  cs.has, CSEG_STOPY))  return false;
+    if (!compactVal<uint8_t>(elem["grp"],     cs.grouping, cs.has, CSEG_GRP))  return false;
+    if (!compactVal<uint8_t>(elem[F("spc")],  cs.spacing,  cs.has, CSEG_SPC))  return false;
+    if (!compactVal<int32_t>(elem[F("of")],   cs.offset,   cs.has, CSEG_OF))   return false;
+    if (elem["cct"].is<int>() && elem["cct"].as<int>() > 255) return false; // CCT in Kelvin is left to deserializeSegment()
+    if (!compactVal<uint8_t>(elem["cct"],     cs.cct,      cs.has, CSEG_CCT))  return false;
+    if (!compactVal<uint8_t>(elem[F("set")],  cs.set,      cs.has, CSEG_SET))  return false;
+    if (!compactVal<uint8_t>(elem["si"],      cs.soundSim, cs.has, CSEG_SI))   return false;
+    if (!compactVal<uint8_t>(elem["m12"],     cs.map1D2D,  cs.has, CSEG_M12))  return false;
+    if (!compactByte(elem["bri"], cs.opacity,   cs.has, CSEG_BRI)) return false;
+    if (!compactByte(elem["fx"],  cs.mode,      cs.has, CSEG_FX))  return false;
+    if (!compactByte(elem["sx"],  cs.speed,     cs.has, CSEG_SX))  return false;
+    if (!compactByte(elem["ix"],  cs.intensity, cs.has, CSEG_IX))  return false;
+    if (!compactByte(elem["pal"], cs.palette,   cs.has, CSEG_PAL)) return false;
+    if (!compactByte(elem["c1"],  cs.custom1,   cs.has, CSEG_C1))  return false;
+    if (!compactByte(elem["c2"],  cs.custom2,   cs.has, CSEG_C2))  return false;
+    if (!compactByte(elem["c3"],  cs.custom3,   cs.has, CSEG_C3))  return false;
+    if (!compactByte(elem["bm"],  cs.blendMode, cs.has, CSEG_BM))  return false;
+    // unknown effect or palette (i.e. removed usermod or custom palette) is left to deserializeSegment() which falls back to defaults
+    if ((cs.has & CSEG_FX)  && elem["fx"].as<int>() >= strip.getModeCount()) return false;
+    if ((cs.has & CSEG_PAL) && (elem["pal"].as<int>() > 255 || (cs.palette > FIXED_PALETTE_COUNT && cs.palette <= 255-customPalettes.size()))) return false;
+    if (!compactBool(elem["on"],     cs, CSEG_B_ON))  return false;
+    if (!compactBool(elem["frz"],    cs, CSEG_B_FRZ)) return false;
+    if (!compactBool(elem["sel"],    cs, CSEG_B_SEL)) return false;
+    if (!compactBool(elem["rev"],    cs, CSEG_B_REV)) return false;
+    if (!compactBool(elem["mi"],     cs, CSEG_B_MI))  return false;
+    if (!compactBool(elem["rY"],     cs, CSEG_B_RY))  return false;
+    if (!compactBool(elem["mY"],     cs, CSEG_B_MY))  return false;
+    if (!compactBool(elem[F("tp")],  cs, CSEG_B_TP))  return false;
+    if (!compactBool(elem["o1"],     cs, CSEG_B_O1))  return false;
+    if (!compactBool(elem["o2"],     cs, CSEG_B_O2))  return false;
+    if (!compactBool(elem["o3"],     cs, CSEG_B_O3))  return false;
+
+    if (elem["n"]) {
+      // name field exists (same condition as in deserializeSegment())
+      cs.has |= CSEG_NAME;
+      const char *name = elem["n"].as<const char*>();
+      strlcpy(names, name ? name : "", WLED_MAX_SEGNAME_LEN+1);
+      names += strlen(names) + 1;
+    }
+
+    JsonVariant col = elem["col"];
+    if (!col.isNull()) {
+      if (!col.is<JsonArray>()) return false;
+      cs.has |= CSEG_COL;
+      JsonArray colarr = col;
+      for (size_t i = 0; i < NUM_COLORS; i++) {
+        int rgbw[] = {0,0,0,0};
+        JsonVariant c = colarr[i];
+        if (c.is<JsonArray>()) {
+          if (c.size() == 0) continue;
+          copyArray(c.as<JsonArray>(), rgbw, 4);
+        } else if (c.is<const char*>()) {
+          byte brgbw[] = {0,0,0,0};
+          const char *hexCol = c;
+          if (hexCol[0] == 'r' && hexCol[1] == '\0') return false; // random color
+          if (!colorFromHexString(brgbw, hexCol)) continue;
+          for (size_t j = 0; j < 4; j++) rgbw[j] = brgbw[j];
+        } else if (c.is<int>()) {
+          byte brgbw[] = {0,0,0,0};
+          int kelvin = c;
+          if (kelvin < 0) continue;
+          if (kelvin > 0) colorKtoRGB(kelvin, brgbw);
+          for (size_t j = 0; j < 4; j++) rgbw[j] = brgbw[j];
+        } else if (c.isNull()) {
+          continue;
+        } else return false; // JSON object with individual channels depends on current color
+        cs.colors[i] = RGBW32(rgbw[0],rgbw[1],rgbw[2],rgbw[3]);
+        cs.colHas |= 1 << i;
+      }
+    }
+    return true;
+  }
+}
+
+// applies compact segment, mirrors deserializeSegment()
+static bool deserializeCompactSegment(const CompactState *state, const CompactSegment &cs)
+{
+  byte id = cs.id;
+  if (id >= WS2812FX::getMaxSegments()) return false;
+
+  bool newSeg = false;
+  int stop = (cs.has & CSEG_STOP) ? cs.stop : -1;
+
+  // append segment
+  if (id >= strip.getSegmentsNum()) {
+    if (stop <= 0) return false; // ignore empty/inactive segments
+    strip.appendSegment(0, strip.getLengthTotal());
+    id = strip.getSegmentsNum()-1; // segments are added at the end of list
+    newSeg = true;
+  }
+
+  Segment& seg = strip.getSegment(id);
+  SegmentCopy prev = copyOf(seg);
+
+  int start  = (cs.has & CSEG_START)  ? cs.start  : seg.start;
+  if (stop < 0) stop = seg.stop;
+  int startY = (cs.has & CSEG_STARTY) ? cs.startY : seg.startY;
+  int stopY  = (cs.has & CSEG_STOPY)  ? cs.stopY  : seg.stopY;
+
+  if (cs.has & CSEG_NAME) seg.setName(reinterpret_cast<const char*>(state) + cs.nameOfs);
+  else if (start != seg.start || stop != seg.stop) seg.clearName();
+
+  auto boolOpt = [&cs](uint16_t flag, bool dflt) { return (cs.boolHas & flag) ? (bool)(cs.boolVal & flag) : dflt; };
+  uint16_t grp       = (cs.has & CSEG_GRP) ? cs.grouping : seg.grouping;
+  uint16_t spc       = (cs.has & CSEG_SPC) ? cs.spacing  : seg.spacing;
+  uint16_t of        = seg.offset;
+  uint8_t  soundSim  = (cs.has & CSEG_SI)  ? cs.soundSim : seg.soundSim;
+  uint8_t  map1D2D   = (cs.has & CSEG_M12) ? cs.map1D2D  : seg.map1D2D;
+  uint8_t  set       = (cs.has & CSEG_SET) ? cs.set      : seg.set;
+  bool     selected  = boolOpt(CSEG_B_SEL, seg.selected);
+  bool     reverse   = boolOpt(CSEG_B_REV, seg.reverse);
+  bool     mirror    = boolOpt(CSEG_B_MI,  seg.mirror);
+  #ifndef WLED_DISABLE_2D
+  bool     reverse_y = boolOpt(CSEG_B_RY,  seg.reverse_y);
+  bool     mirror_y  = boolOpt(CSEG_B_MY,  seg.mirror_y);
+  bool     transpose = boolOpt(CSEG_B_TP,  seg.transpose);
+  #endif
+
+  if (seg.mirror != mirror) seg.markForReset();
+  #ifndef WLED_DISABLE_2D
+  if (seg.mirror_y != mirror_y || seg.transpose != transpose) seg.markForReset();
+  #endif
+
+  int len = (stop > start) ? stop - start : 1;
+  if (cs.has & CSEG_OF) {
+    int offsetAbs = abs(cs.offset);
+    if (offsetAbs > len - 1) offsetAbs %= len;
+    if (cs.offset < 0) offsetAbs = len - offsetAbs;
+    of = offsetAbs;
+  }
+  if (stop > start && of > len -1) of = len -1;
+
+  seg.setGeometry(start, stop, grp, spc, of, startY, stopY, map1D2D);
+
+  if (newSeg) seg.refreshLightCapabilities(); // fix for #3403
+
+  if (seg.reset && seg.stop == 0) {
+    if (id == strip.getMainSegmentId()) strip.setMainSegmentId(0); // fix for #3403
+    return true; // segment was deleted & is marked for reset, no need to change anything else
+  }
+
+  if (cs.has & CSEG_BRI) {
+    if (cs.opacity > 0) seg.setOpacity(cs.opacity); // use transition
+    seg.setOption(SEG_OPTION_ON, cs.opacity); // use transition
+  }
+
+  seg.setOption(SEG_OPTION_ON, boolOpt(CSEG_B_ON, seg.on)); // use transition
+  seg.freeze = boolOpt(CSEG_B_FRZ, seg.freeze);
+
+  seg.setCCT((cs.has & CSEG_CCT) ? cs.cct : seg.cct);
+
+  if (cs.has & CSEG_COL) {
+    if (seg.getLightCapabilities() & 3) {
+      for (size_t i = 0; i < NUM_COLORS; i++) {
+        if (!(cs.colHas & (1 << i))) continue;
+        seg.setColor(i, cs.colors[i]); // use transition
+        if (seg.mode == FX_MODE_STATIC) strip.trigger(); //instant refresh
+      }
+    } else {
+      // non RGB & non White segment (usually On/Off bus)
+      seg.setColor(0, ULTRAWHITE); // use transition
+      seg.setColor(1, BLACK); // use transition
+    }
+  }
+
+  seg.set       = constrain(set, 0, 3);
+  seg.soundSim  = constrain(soundSim, 0, 3);
+  seg.selected  = selected;
+  seg.reverse   = reverse;
+  seg.mirror    = mirror;
+  #ifndef WLED_DISABLE_2D
+  seg.reverse_y = reverse_y;
+  seg.mirror_y  = mirror_y;
+  seg.transpose = transpose;
+  #endif
+
+  if ((cs.has & CSEG_FX) && cs.mode != seg.mode) seg.setMode(cs.mode); // use transition
+  if (cs.has & CSEG_SX) seg.speed = cs.speed;
+  if (cs.has & CSEG_IX) seg.intensity = cs.intensity;
+  if ((seg.getLightCapabilities() & 1) && (cs.has & CSEG_PAL)) seg.setPalette(cs.palette);
+  if (cs.has & CSEG_C1) seg.custom1 = cs.custom1;
+  if (cs.has & CSEG_C2) seg.custom2 = cs.custom2;
+  if (cs.has & CSEG_C3) seg.custom3 = constrain(cs.custom3, 0, 31);
+  seg.check1 = boolOpt(CSEG_B_O1, seg.check1);
+  seg.check2 = boolOpt(CSEG_B_O2, seg.check2);
+  seg.check3 = boolOpt(CSEG_B_O3, seg.check3);
+  if (cs.has & CSEG_BM) seg.blendMode = constrain(cs.blendMode, 0, 15);
+
+  if (differs(seg, prev) & ~SEG_DIFFERS_SEL) stateChanged = true;
+
+  return true;
+}
+
+// converts preset JSON into compact state, returns nullptr if not possible (free with p_free())
+void *compactState(JsonObject root)
+{
+  // root keys that are understood, anything else (i.e. "win", "playlist", "nl", "ps", "ledmap", usermod keys) prevents caching
+  static const char keys[] = "|n|ql|on|bri|transition|bs|mainseg|seg|";
+  for (JsonPair kv : root) {
+    char key[14];
+    const char *k = kv.key().c_str();
+    if (strlen(k) > sizeof(key)-3) return nullptr;
+    sprintf(key, "|%s|", k);
+    if (!strstr(keys, key)) return nullptr;
+  }
+
+  JsonVariant segVar = root["seg"];
+  if (!segVar.isNull() && !segVar.is<JsonArray>()) return nullptr; // single segment object applies to selected segments
+  JsonArray segs = segVar;
+  size_t segCount = segs.size();
+  if (segCount > WS2812FX::getMaxSegments()) return nullptr;
+
+  // measure segment names
+  size_t namesLen = 0;
+  for (JsonVariant elem : segs) {
+    if (!elem.is<JsonObject>()) return nullptr;
+    if (elem["n"]) {
+      const char *name = elem["n"].as<const char*>();
+      namesLen += (name ? strnlen(name, WLED_MAX_SEGNAME_LEN) : 0) + 1;
+    }
+  }
+  size_t size = sizeof(CompactState) + segCount * sizeof(CompactSegment) + namesLen;
+  if (size > UINT16_MAX) return nullptr;
+
+  CompactState *state = static_cast<CompactState*>(p_malloc(size));
+  if (!state) return nullptr;
+  memset(state, 0, sizeof(CompactState));
+  state->size = size;
+  state->segCount = segCount;
+
+  uint32_t has = 0;
+  bool valid = compactByte(root["bri"], state->bri, has, CSTATE_BRI)
+            && compactVal<int32_t>(root[F("transition")], state->transition, has, CSTATE_TRANSITION)
+            && compactVal<uint8_t>(root[F("bs")], state->bs, has, CSTATE_BS)
+            && compactVal<uint8_t>(root[F("mainseg")], state->mainseg, has, CSTATE_MAINSEG)
+            && !root["on"].is<const char*>(); // toggle
+  if (root["on"].is<bool>()) {
+    has |= CSTATE_ON;
+    state->on = root["on"].as<bool>();
+  }
+  if (!segVar.isNull()) has |= CSTATE_SEG;
+  state->has = has;
+
+  char *names = reinterpret_cast<char*>(&state->seg[segCount]);
+  size_t i = 0;
+  for (JsonObject elem : segs) {
+    if (!valid) break;
+    char *name = names;
+    valid = compactSegment(elem, state->seg[i], i, names);
+    if (state->seg[i].has & CSEG_NAME) state->seg[i].nameOfs = name - reinterpret_cast<char*>(state);
+    i++;
+  }
+  if (!valid) {
+    p_free(state);
+    return nullptr;
+  }
+  return state;
+}
+
+// applies compact state from preset cache, mirrors deserializeState()
+void deserializeCompactState(const void *compact)
+{
+  const CompactState *state = static_cast<const CompactState*>(compact);
+
+  bool onBefore = bri;
+  if (state->has & CSTATE_BRI) bri = state->bri;
+  if (bri != briOld) stateChanged = true;
+
+  bool on = (state->has & CSTATE_ON) ? state->on : (bri > 0);
+  if (!on != !bri) toggleOnOff();
+
+  if (bri && !onBefore) { // unfreeze all segments when turning on
+    for (size_t s=0; s < strip.getSegmentsNum(); s++) {
+      strip.getSegment(s).freeze = false;
+    }
+    if (realtimeMode && !realtimeOverride && useMainSegmentOnly) { // keep live segment frozen if live
+      strip.getMainSegment().freeze = true;
+    }
+  }
+
+  if (currentPlaylist < 0 && (state->has & CSTATE_TRANSITION) && state->transition >= 0) { //do not apply transition time from preset if playlist active
+    transitionDelay = state->transition * 100;
+    strip.setTransition(transitionDelay);
+  }
+
+  if (state->has & CSTATE_BS) blendingStyle = state->bs;
+  blendingStyle &= 0x1F;
+
+  if (!realtimeMode && (state->has & CSTATE_MAINSEG)) strip.setMainSegmentId(state->mainseg);
+
+  if (realtimeMode && useMainSegmentOnly) {
+    strip.getMainSegment().freeze = !realtimeOverride;
+    realtimeOverride = REALTIME_OVERRIDE_NONE;  // ignore request for override if using main segment only
+  }
+
+  if (state->has & CSTATE_SEG) {
+    strip.suspend();
+    strip.waitForIt();
+    size_t deleted = 0;
+    for (size_t i = 0; i < state->segCount; i++) {
+      const CompactSegment &cs = state->seg[i];
+      if (deserializeCompactSegment(state, cs) && (cs.has & CSEG_STOP) && cs.stop == 0) deleted++;
+    }
+    if (strip.getSegmentsNum() > 3 && deleted >= strip.getSegmentsNum()/2U) strip.purgeSegments(); // batch deleting more than half segments
+    strip.resume();
+  }
+
+  if (stateChanged) stateUpdated(CALL_MODE_NO_NOTIFY);
+}
+
+// returns true if compact state changes anything that makes preset current (segments, on or brightness)
+bool compactStateChangesPreset(const void *compact)
+{
+  return static_cast<const CompactState*>(compact)->has & (CSTATE_SEG | CSTATE_ON | CSTATE_BRI);
+}
+#endif
+
 // deserializes WLED state
 // presetId is non-0 if called from handlePreset()
 bool deserializeState(JsonObject root, byte callMode, byte presetId)
@@ -558,7 +997,7 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
   }
 
   if (stateChanged) stateUpdated(callMode);
-  if (presetToRestore) currentPreset = presetToRestore;
+  if (presetToRestore) { currentPreset = presetToRestore; stateVersion++; }
 
   return stateResponse;
 }
@@ -644,7 +1083,7 @@ void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segme
   }
 
   if (!forPreset) {
-    if (errorFlag) {root[F("error")] = errorFlag; errorFlag = ERR_NONE;} //prevent error message to persist on screen
+    if (errorFlag) {root[F("error")] = errorFlag; errorFlag = ERR_NONE; stateVersion++;} //prevent error message to persist on screen (and in cached /json/state)
 
     root["ps"] = (currentPreset > 0) ? currentPreset : -1;
     root[F("pl")] = currentPlaylist;
@@ -802,6 +1241,7 @@ void serializeInfo(JsonObject root)
   fs_info["u"] = fsBytesUsed / 1000;
   fs_info["t"] = fsBytesTotal / 1000;
   fs_info[F("pmt")] = presetsModifiedTime;
+  serializeFSStats(fs_info);
 
   root[F("ndc")] = nodeListEnabled ? (int)Nodes.size() : -1;
 
@@ -849,6 +1289,19 @@ void serializeInfo(JsonObject root)
   #endif
   root[F("uptime")] = millis()/1000 + rolloverMillis*4294967;
 
+  JsonObject boot = root.createNestedObject(F("boot")); // boot profiling (ms)
+  boot[F("fs")]    = bootPhaseMillis[BOOT_PHASE_FS];
+  boot[F("cfg")]   = bootPhaseMillis[BOOT_PHASE_CFG];
+  boot[F("strip")] = bootPhaseMillis[BOOT_PHASE_STRIP];
+  boot[F("fin")]   = bootPhaseMillis[BOOT_PHASE_FINALIZE];
+  boot[F("um")]    = bootPhaseMillis[BOOT_PHASE_UM];
+  boot[F("net")]   = bootPhaseMillis[BOOT_PHASE_NET];
+  boot[F("setup")] = bootPhaseMillis[BOOT_PHASE_SETUP];
+  boot[F("if")]    = bootPhaseMillis[BOOT_PHASE_IF];
+  boot[F("frame")] = bootFirstFrame; // millis() since power on
+  serializePlaylistTiming(root);
+  serializeJSONLockStats(root);
+
   char time[32];
   getTimeString(time);
   root[F("time")] = time;
@@ -1080,35 +1533,187 @@ void serializeModeNames(JsonArray arr)
   }
 }
 
-// Global buffer locking response helper class (to make sure lock is released when AsyncJsonResponse is destroyed)
+// Buffer locking response helper class (to make sure lock is released when AsyncJsonResponse is destroyed)
 class LockedJsonResponse: public AsyncJsonResponse {
-  bool _holding_lock;
+  JsonDocument *_doc; // locked document (global JSON buffer or pooled document)
   public:
-  // WARNING: constructor assumes requestJSONBufferLock() was successfully acquired externally/prior to constructing the instance
+  // WARNING: constructor assumes requestJSONPoolDoc() was successfully acquired externally/prior to constructing the instance
   // Not a good practice with C++. Unfortunately AsyncJsonResponse only has 2 constructors - for dynamic buffer or existing buffer,
   // with existing buffer it clears its content during construction
   // if the lock was not acquired (using JSONBufferGuard class) previous implementation still cleared existing buffer
-  inline LockedJsonResponse(JsonDocument* doc, bool isArray) : AsyncJsonResponse(doc, isArray), _holding_lock(true) {};
+  inline LockedJsonResponse(JsonDocument* doc, bool isArray) : AsyncJsonResponse(doc, isArray), _doc(doc) {};
 
   virtual size_t _fillBuffer(uint8_t *buf, size_t maxLen) { 
     size_t result = AsyncJsonResponse::_fillBuffer(buf, maxLen);
     // Release lock as soon as we're done filling content
-    if (((result + _sentLength) >= (_contentLength)) && _holding_lock) {
-      releaseJSONBufferLock();
-      _holding_lock = false;
+    if (((result + _sentLength) >= (_contentLength)) && _doc) {
+      releaseJSONPoolDoc(_doc);
+      _doc = nullptr;
     }
     return result;
   }
 
   // destructor will remove JSON buffer lock when response is destroyed in AsyncWebServer
-  virtual ~LockedJsonResponse() { if (_holding_lock) releaseJSONBufferLock(); };
+  virtual ~LockedJsonResponse() { if (_doc) releaseJSONPoolDoc(_doc); };
+};
+
+enum class json_target {
+  all, state, info, state_info, nodes, effects, palettes, fxdata, networks, config
+};
+
+// fills JSON document with requested target content
+static void serializeJsonTarget(JsonVariant lDoc, json_target subJson, int page)
+{
+  switch (subJson)
+  {
+    case json_target::state:
+      serializeState(lDoc); break;
+    case json_target::info:
+      serializeInfo(lDoc); break;
+    case json_target::nodes:
+      serializeNodes(lDoc); break;
+    case json_target::palettes:
+      serializePalettes(lDoc, page); break;
+    case json_target::effects:
+      serializeModeNames(lDoc); break;
+    case json_target::fxdata:
+      serializeModeData(lDoc); break;
+    case json_target::networks:
+      serializeNetworks(lDoc); break;
+    case json_target::config:
+      serializeConfig(lDoc); break;
+    case json_target::state_info:
+    case json_target::all:
+      JsonObject state = lDoc.createNestedObject("state");
+      serializeState(state);
+      JsonObject info = lDoc.createNestedObject("info");
+      serializeInfo(info);
+      if (subJson == json_target::all)
+      {
+        JsonArray effects = lDoc.createNestedArray(F("effects"));
+        serializeModeNames(effects); // remove WLED-SR extensions from effect names
+        lDoc[F("palettes")] = serialized((const __FlashStringHelper*)JSON_palette_names);
+      }
+      //lDoc["m"] = lDoc.memoryUsage(); // JSON buffer usage, for remote debugging
+  }
+}
+
+/*
+ * Versioned JSON response cache
+ * Responses for state, info, effects, fxdata and palx pages are identified by a version derived from
+ * stateVersion, configVersion and effectListVersion. The version is sent as ETag so that clients
+ * revalidating with "If-None-Match" get 304 without touching the JSON buffer.
+ * Serialized bytes are kept (in PSRAM if available) and shared with in-flight responses.
+ */
+class JsonCacheBlob {
+  public:
+    uint8_t *data;
+    size_t   len;
+    JsonCacheBlob(size_t size) : data(static_cast<uint8_t*>(p_malloc(size))), len(data ? size : 0) {}
+    ~JsonCacheBlob() { if (data) p_free(data); }
+    JsonCacheBlob(const JsonCacheBlob&) = delete; // Noncopyable
+    JsonCacheBlob& operator=(const JsonCacheBlob&) = delete;
 };
 
+// response that streams content of a cached blob (keeps blob alive until response is destroyed)
+class CachedJsonResponse: public AsyncAbstractResponse {
+  std::shared_ptr<JsonCacheBlob> _blob;
+  public:
+  CachedJsonResponse(std::shared_ptr<JsonCacheBlob> blob) : _blob(std::move(blob)) {
+    _code = 200;
+    _contentType = FPSTR(CONTENT_TYPE_JSON);
+    _contentLength = _blob->len;
+  }
+  bool _sourceValid() const { return _blob && _blob->data; }
+  virtual size_t _fillBuffer(uint8_t *buf, size_t maxLen) {
+    size_t len = MIN(maxLen, _contentLength - _sentLength);
+    memcpy(buf, _blob->data + _sentLength, len);
+    return len;
+  }
+};
+
+#if WLED_JSON_CACHE_ENTRIES > 0
+struct JsonCacheEntry {
+  uint16_t key;       // json_target + palette page
+  uint32_t version;   // sum of monotonic version counters the content depends upon
+  uint32_t epoch;     // time window for content with live values (info)
+  unsigned long used; // last time entry was used (for eviction)
+  std::shared_ptr<JsonCacheBlob> blob;
+};
+static JsonCacheEntry jsonCache[WLED_JSON_CACHE_ENTRIES];
+
+static std::shared_ptr<JsonCacheBlob> getJsonCache(uint16_t key, uint32_t version, uint32_t epoch)
+{
+  for (auto &e : jsonCache) {
+    if (!e.blob || e.key != key) continue;
+    if (e.version != version || e.epoch != epoch) {
+      e.blob.reset(); // outdated, release memory (in-flight responses keep their copy alive)
+      return nullptr;
+    }
+    e.used = millis();
+    return e.blob;
+  }
+  return nullptr;
+}
+
+static void putJsonCache(uint16_t key, uint32_t version, uint32_t epoch, std::shared_ptr<JsonCacheBlob> blob)
+{
+  JsonCacheEntry *slot = &jsonCache[0];
+  for (auto &e : jsonCache) {
+    if (e.blob && e.key == key) { slot = &e; break; }             // replace same target
+    if (!e.blob) slot = &e;                                        // or use empty slot
+    else if (slot->blob && e.used < slot->used) slot = &e;         // or evict least recently used
+  }
+  slot->key     = key;
+  slot->version = version;
+  slot->epoch   = epoch;
+  slot->used    = millis();
+  slot->blob    = std::move(blob);
+}
+#endif
+
+// returns true if target can be cached/ETagged and fills its key & version
+static bool getJsonCacheVersion(json_target subJson, int page, uint16_t &key, uint32_t &version, uint32_t &epoch)
+{
+  key   = uint16_t(subJson) | (page << 4);
+  epoch = 0;
+  switch (subJson) {
+    case json_target::state:
+      if (nightlightActive || realtimeMode) return false; // contains time dependant values
+      if (errorFlag != ERR_NONE) return false;          // error is reported (and cleared) only once
+      version = stateVersion;
+      return true;
+    case json_target::info:
+      version = stateVersion + configVersion;
+      epoch   = millis() / WLED_JSON_CACHE_INFO_TTL; // uptime, heap, fps etc. change continuously
+      return true;
+    case json_target::effects:
+    case json_target::fxdata:
+      version = effectListVersion;
+      return true;
+    case json_target::palettes:
+      version = paletteVersion;
+      return true;
+    default:
+      return false;
+  }
+}
+
+static void generateJsonEtag(char *etag, uint16_t key, uint32_t version, uint32_t epoch)
+{
+  static uint16_t bootId = 0; // version counters restart at boot, make sure ETags from previous boot do not match
+  if (!bootId) bootId = hw_random16() | 1;
+  sprintf_P(etag, PSTR("%u-%04x-%x-%x-%x"), VERSION, bootId, key, version, epoch);
+}
+
+static void setJsonCacheHeaders(AsyncWebServerResponse *response, const char *etag)
+{
+  response->addHeader(F("Cache-Control"), F("no-cache")); // revalidate on every request using "If-None-Match"
+  response->addHeader(F("ETag"), etag);
+}
+
 void serveJson(AsyncWebServerRequest* request)
 {
-  enum class json_target {
-    all, state, info, state_info, nodes, effects, palettes, fxdata, networks, config
-  };
   json_target subJson = json_target::all;
 
   const String& url = request->url();
@@ -1136,54 +1741,75 @@ void serveJson(AsyncWebServerRequest* request)
     return;
   }
 
-  if (!requestJSONBufferLock(JSON_LOCK_SERVEJSON)) {
+  int page = 0;
+  if (subJson == json_target::palettes && request->hasParam(F("page"))) page = constrain(request->getParam(F("page"))->value().toInt(), 0, 255);
+
+  char etag[48] = {'\0'};
+  uint16_t cacheKey;
+  uint32_t cacheVersion, cacheEpoch;
+  bool cacheable = getJsonCacheVersion(subJson, page, cacheKey, cacheVersion, cacheEpoch);
+  if (cacheable) {
+    generateJsonEtag(etag, cacheKey, cacheVersion, cacheEpoch);
+    AsyncWebHeader *header = request->getHeader(F("If-None-Match"));
+    if (header && header->value() == etag) {
+      AsyncWebServerResponse *response = request->beginResponse(304);
+      setJsonCacheHeaders(response, etag);
+      request->send(response);
+      return;
+    }
+    #if WLED_JSON_CACHE_ENTRIES > 0
+    std::shared_ptr<JsonCacheBlob> blob = getJsonCache(cacheKey, cacheVersion, cacheEpoch);
+    if (blob) {
+      AsyncWebServerResponse *response = new CachedJsonResponse(std::move(blob));
+      setJsonCacheHeaders(response, etag);
+      request->send(response);
+      return;
+    }
+    #endif
+  }
+
+  JsonDocument *doc = requestJSONPoolDoc(JSON_LOCK_SERVEJSON);
+  if (!doc) {
     request->deferResponse();    
     return;
   }
-  // releaseJSONBufferLock() will be called when "response" is destroyed (from AsyncWebServer)
+  const bool isArray = subJson==json_target::fxdata || subJson==json_target::effects;
+
+  #if WLED_JSON_CACHE_ENTRIES > 0
+  if (cacheable) {
+    // serialize into cache blob and release JSON buffer immediately (instead of after the response has been sent)
+    JsonVariant lDoc = isArray ? JsonVariant(doc->to<JsonArray>()) : JsonVariant(doc->to<JsonObject>());
+    serializeJsonTarget(lDoc, subJson, page);
+    size_t len = measureJson(lDoc);
+    auto blob = std::make_shared<JsonCacheBlob>(len);
+    if (blob && blob->data) {
+      serializeJson(lDoc, blob->data, len);
+      releaseJSONPoolDoc(doc);
+      DEBUG_PRINTF_P(PSTR("JSON cached: %u bytes for request: %d\n"), len, subJson);
+      putJsonCache(cacheKey, cacheVersion, cacheEpoch, blob);
+      AsyncWebServerResponse *response = new CachedJsonResponse(std::move(blob));
+      setJsonCacheHeaders(response, etag);
+      request->send(response);
+      return;
+    }
+    // not enough memory for cache blob, fall back to streaming from JSON buffer (serialized again below)
+  }
+  #endif
+
+  // releaseJSONPoolDoc() will be called when "response" is destroyed (from AsyncWebServer)
   // make sure you delete "response" if no "request->send(response);" is made
-  LockedJsonResponse *response = new LockedJsonResponse(pDoc, subJson==json_target::fxdata || subJson==json_target::effects); // will clear and convert JsonDocument into JsonArray if necessary
+  LockedJsonResponse *response = new LockedJsonResponse(doc, isArray); // will clear and convert JsonDocument into JsonArray if necessary
 
   JsonVariant lDoc = response->getRoot();
-
-  switch (subJson)
-  {
-    case json_target::state:
-      serializeState(lDoc); break;
-    case json_target::info:
-      serializeInfo(lDoc); break;
-    case json_target::nodes:
-      serializeNodes(lDoc); break;
-    case json_target::palettes:
-      serializePalettes(lDoc, request->hasParam(F("page")) ? request->getParam(F("page"))->value().toInt() : 0); break;
-    case json_target::effects:
-      serializeModeNames(lDoc); break;
-    case json_target::fxdata:
-      serializeModeData(lDoc); break;
-    case json_target::networks:
-      serializeNetworks(lDoc); break;
-    case json_target::config:
-      serializeConfig(lDoc); break;
-    case json_target::state_info:
-    case json_target::all:
-      JsonObject state = lDoc.createNestedObject("state");
-      serializeState(state);
-      JsonObject info = lDoc.createNestedObject("info");
-      serializeInfo(info);
-      if (subJson == json_target::all)
-      {
-        JsonArray effects = lDoc.createNestedArray(F("effects"));
-        serializeModeNames(effects); // remove WLED-SR extensions from effect names
-        lDoc[F("palettes")] = serialized((const __FlashStringHelper*)JSON_palette_names);
-      }
-      //lDoc["m"] = lDoc.memoryUsage(); // JSON buffer usage, for remote debugging
-  }
+  serializeJsonTarget(lDoc, subJson, page);
+  releaseJSONStateLock(doc); // pooled document is filled, allow state changes while response is transmitted
 
   DEBUG_PRINTF_P(PSTR("JSON buffer size: %u for request: %d\n"), lDoc.memoryUsage(), subJson);
 
   [[maybe_unused]] size_t len = response->setLength();
   DEBUG_PRINTF_P(PSTR("JSON content length: %u\n"), len);
 
+  if (cacheable) setJsonCacheHeaders(response, etag);
   request->send(response);
 }
 
@@ -1230,7 +1856,14 @@ bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient)
     r = scale8(qadd8(w, r), strip.getBrightness()); //R, add white channel to RGB channels as a simple RGBW -> RGB map
     g = scale8(qadd8(w, g), strip.getBrightness()); //G
     b = scale8(qadd8(w, b), strip.getBrightness()); //B
-    buf += sprintf_P(buf, PSTR("\"%06X\","), RGBW32(r,g,b,0));
+    // equivalent of sprintf_P(buf, PSTR("\"%06X\","), RGBW32(r,g,b,0)) without the formatting overhead
+    static const char hex[] = "0123456789ABCDEF";
+    *buf++ = '"';
+    *buf++ = hex[r >> 4]; *buf++ = hex[r & 0x0F];
+    *buf++ = hex[g >> 4]; *buf++ = hex[g & 0x0F];
+    *buf++ = hex[b >> 4]; *buf++ = hex[b & 0x0F];
+    *buf++ = '"';
+    *buf++ = ',';
   }
   buf--;  // remove last comma
   buf += sprintf_P(buf, PSTR("],\"n\":%d"), n);
@@ -88,6 +88,7 @@ void stateUpdated(byte callMode) {
   //call for notifier -> 0: init 1: direct change 2: button 3: notification 4: nightlight 5: other (No notification)
   //                     6: fx changed 7: hue 8: preset cycle 9: blynk 10: alexa 11: ws send only 12: button preset
   setValuesFromFirstSelectedSeg();  // a much better approach would be to use main segment: setValuesFromMainSeg()
+  stateVersion++; // invalidate cached /json/state (stateUpdated() is the common path for all state changes)
 
   if (bri != briOld || stateChanged) {
     if (stateChanged) currentPreset = 0; //something changed, so we are no longer in the preset
@@ -142,6 +143,7 @@ void stateUpdated(byte callMode) {
 void updateInterfaces(uint8_t callMode) {
   if (!interfaceUpdateCallMode || millis() - lastInterfaceUpdate < INTERFACE_UPDATE_COOLDOWN) return;
 
+  stateVersion++; // anything pushed to interfaces is a state change for cached /json/state
   sendDataWs();
   lastInterfaceUpdate = millis();
   interfaceUpdateCallMode = CALL_MODE_INIT; //disable further updates
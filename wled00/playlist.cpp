@@ -18,6 +18,13 @@ static PlaylistEntry *playlistEntries = nullptr;
 static byte           playlistLen;               //number of playlist entries
 static int8_t         playlistIndex = -1;
 static uint16_t       playlistEntryDur = 0;      //duration of the current entry in tenths of seconds
+static bool           playlistShuffled = false;  //entries were shuffled ahead of roll-over (to prefetch correct entry)
+
+//entry switch timing, in strip time (strip.now) so that nodes with synced timebase switch simultaneously
+static unsigned long  playlistSwitchDue = 0;     //scheduled time of last switch
+static long           playlistSwitchLate = 0;    //actual minus scheduled time of last switch (ms)
+static long           playlistSwitchMaxLate = 0;
+static bool           playlistSwitchPending = false; //preset is not cached and still loading
 
 //values we need to keep about the parent playlist while inside sub-playlist
 static int16_t        parentPlaylistIndex = -1;
@@ -47,8 +54,11 @@ void unloadPlaylist() {
     delete[] playlistEntries;
     playlistEntries = nullptr;
   }
+  if (currentPlaylist >= 0) stateVersion++; // "pl" is part of /json/state
   currentPlaylist = playlistIndex = -1;
   playlistLen = playlistEntryDur = playlistOptions = 0;
+  playlistShuffled = playlistSwitchPending = false;
+  playlistSwitchLate = playlistSwitchMaxLate = 0;
   DEBUG_PRINTLN(F("Playlist unloaded."));
 }
 
@@ -138,17 +148,40 @@ int16_t loadPlaylist(JsonObject playlistObj, byte presetId) {
   }
 
   currentPlaylist = presetId;
+  stateVersion++;
   DEBUG_PRINTLN(F("Playlist loaded."));
   return currentPlaylist;
 }
 
 
+static void recordPlaylistSwitch() {
+  unsigned long now = millis() + strip.timebase;
+  if ((long)(now - playlistSwitchDue) < 0) playlistSwitchDue = now; // strip time jumped backwards meanwhile (timebase reset or sync)
+  playlistSwitchLate = (long)(now - playlistSwitchDue);
+  if (abs(playlistSwitchLate) > abs(playlistSwitchMaxLate)) playlistSwitchMaxLate = playlistSwitchLate;
+  playlistSwitchPending = false;
+  DEBUG_PRINTF_P(PSTR("Playlist switch %ld ms late.\n"), playlistSwitchLate);
+}
+
+
 void handlePlaylist() {
-  static unsigned long presetCycledTime = 0;
+  static unsigned long presetCycledTime = 0; //scheduled start of current entry (strip time)
   if (currentPlaylist < 0 || playlistEntries == nullptr) return;
 
-  if ((playlistEntryDur < UINT16_MAX && millis() - presetCycledTime > 100 * playlistEntryDur) || doAdvancePlaylist) {
-    presetCycledTime = millis();
+  if (playlistSwitchPending && !presetNeedsApplying()) recordPlaylistSwitch(); // preset was loaded from file
+
+  // switch entries only when a frame is about to be rendered so the new preset shows on the first frame at or after due time
+  unsigned long now = millis();
+  if ((long)(now - strip.getNextFrameTime()) < 0 && !doAdvancePlaylist) return;
+  now += strip.timebase;
+  // strip time jumps backwards on timebase reset (turning on) or sync, restart schedule so the playlist does not stall
+  if ((long)(now - presetCycledTime) < 0) presetCycledTime = now;
+
+  unsigned long due = presetCycledTime + 100UL * playlistEntryDur;
+  if ((playlistEntryDur < UINT16_MAX && (long)(now - due) >= 0) || playlistEntryDur == 0 || doAdvancePlaylist) {
+    // continue on schedule (no drift) unless playlist was just (re)loaded, advanced manually or fell behind by more than an entry
+    if (playlistEntryDur == 0 || doAdvancePlaylist || now - due > 100UL * playlistEntryDur) due = now;
+    presetCycledTime = due;
     if (bri == 0 || nightlightActive) return;
 
     ++playlistIndex %= playlistLen; // -1 at 1st run (limit to playlistLen)
@@ -165,14 +198,27 @@ void handlePlaylist() {
       }
       if (playlistRepeat > 1) playlistRepeat--; // decrease repeat count on each index reset if not an endless playlist
       // playlistRepeat == 0: endless loop
-      if (playlistOptions & PL_OPTION_SHUFFLE) shufflePlaylist(); // shuffle playlist and start over
+      if ((playlistOptions & PL_OPTION_SHUFFLE) && !playlistShuffled) shufflePlaylist(); // shuffle playlist and start over
+      playlistShuffled = false;
     }
 
     jsonTransitionOnce = true;
     strip.setTransition(playlistEntries[playlistIndex].tr * 100);
     playlistEntryDur = playlistEntries[playlistIndex].dur > 0 ? playlistEntries[playlistIndex].dur : UINT16_MAX;
-    applyPresetFromPlaylist(playlistEntries[playlistIndex].preset);
+    playlistSwitchDue = due;
+    playlistSwitchPending = true;
+    if (applyPresetFromPlaylist(playlistEntries[playlistIndex].preset)) recordPlaylistSwitch(); // cached presets apply immediately
     doAdvancePlaylist = false;
+
+    // resolve next entry (shuffle ahead of roll-over) and load it into cache during this one
+    if (playlistLen > 1) {
+      unsigned next = (playlistIndex + 1) % playlistLen;
+      if (next == 0 && (playlistOptions & PL_OPTION_SHUFFLE) && playlistRepeat != 1) {
+        shufflePlaylist();
+        playlistShuffled = true;
+      }
+      prefetchPreset(playlistEntries[next].preset);
+    }
   }
 }
 
@@ -191,3 +237,13 @@ void serializePlaylist(JsonObject sObj) {
     transition.add(playlistEntries[i].tr);
   }
 }
+
+
+// reports entry switch timing (in /json/info) for judging playlist sync across nodes
+void serializePlaylistTiming(JsonObject info) {
+  if (currentPlaylist < 0) return;
+  JsonObject pl = info.createNestedObject(F("pl"));
+  pl[F("due")]  = playlistSwitchDue;     // scheduled time of last switch (strip time)
+  pl[F("late")] = playlistSwitchLate;    // ms
+  pl[F("max")]  = playlistSwitchMaxLate; // ms
+}
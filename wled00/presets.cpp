@@ -15,6 +15,9 @@ static volatile int8_t saveLedmap = -1;
 static char *quickLoad = nullptr;
 static char *saveName = nullptr;
 static bool includeBri = true, segBounds = true, selectedOnly = false, playlistSave = false;;
+#ifdef WLED_ENABLE_PRESET_STORE
+static volatile bool presetsImportPending = false; // uploaded presets.json is imported in loop (not in async_tcp)
+#endif
 
 static const char presets_json[] PROGMEM = "/presets.json";
 static const char tmp_json[] PROGMEM = "/tmp.json";
@@ -22,16 +25,141 @@ const char *getPresetsFileName(bool persistent) {
   return persistent ? presets_json : tmp_json;
 }
 
+#ifdef WLED_ENABLE_PRESET_STORE
+void requestPresetsImport() {
+  presetsImportPending = true;
+}
+#endif
+
 bool presetNeedsSaving() {
   return presetToSave;
 }
 
+bool presetNeedsApplying() {
+  return presetToApply;
+}
+
+#if WLED_PRESET_CACHE_SIZE > 0
+/*
+ * Cache of pre-parsed presets for playlist playback
+ * Presets are stored in compact binary form (see compactState()) and applied without file system or JSON buffer access.
+ * Presets that cannot be represented (HTTP API, playlists, relative values etc.) are remembered and loaded from file as usual.
+ */
+typedef struct PresetCacheEntry {
+  void         *state;    // compact state, nullptr if unused
+  unsigned long used;     // millis() of last use (LRU)
+  byte          id;
+} pce;
+
+static PresetCacheEntry presetCache[WLED_PRESET_CACHE_SIZE];
+static uint32_t         presetNotCacheable[8];   // bitmap of presets that cannot be cached
+static uint32_t         presetCacheWrites = 0;   // presetsWriteCount the cache is valid for
+static byte             presetCacheValidate = 0; // cacheInvalidate the cache is valid for
+static byte             presetToPrefetch = 0;
+
+static void checkPresetCache() {
+  if (presetCacheWrites == presetsWriteCount && presetCacheValidate == cacheInvalidate) return;
+  for (auto &e : presetCache) {
+    p_free(e.state);
+    e.state = nullptr;
+  }
+  memset(presetNotCacheable, 0, sizeof(presetNotCacheable));
+  presetCacheWrites = presetsWriteCount;
+  presetCacheValidate = cacheInvalidate;
+  DEBUG_PRINTLN(F("Preset cache cleared."));
+}
+
+static PresetCacheEntry *findCachedPreset(byte index) {
+  checkPresetCache();
+  for (auto &e : presetCache) if (e.state && e.id == index) return &e;
+  return nullptr;
+}
+
+static bool isPresetCacheable(byte index) {
+  return index > 0 && index < 251 && !(presetNotCacheable[index >> 5] & (1UL << (index & 31)));
+}
+
+// converts preset JSON into compact state and stores it in least recently used cache entry
+static void cachePreset(byte index, JsonObject fdo) {
+  if (!isPresetCacheable(index) || findCachedPreset(index)) return;
+  void *state = compactState(fdo);
+  if (!state) {
+    presetNotCacheable[index >> 5] |= 1UL << (index & 31);
+    DEBUG_PRINTF_P(PSTR("Preset %u not cacheable.\n"), (unsigned)index);
+    return;
+  }
+  PresetCacheEntry *lru = &presetCache[0];
+  for (auto &e : presetCache) {
+    if (!e.state) { lru = &e; break; }
+    if (e.used < lru->used) lru = &e;
+  }
+  p_free(lru->state);
+  lru->state = state;
+  lru->id = index;
+  lru->used = millis();
+  DEBUG_PRINTF_P(PSTR("Preset %u cached.\n"), (unsigned)index);
+}
+#endif
+
+// applies pre-parsed preset (no file system or JSON buffer access), returns false if preset is not cached
+static bool applyCachedPreset(byte index, byte callMode) {
+  #if WLED_PRESET_CACHE_SIZE > 0
+  if (presetToSave || isFileWritePending()) return false; // cache may be outdated
+  PresetCacheEntry *cached = findCachedPreset(index);
+  if (!cached) return false;
+  cached->used = millis();
+  DEBUG_PRINTF_P(PSTR("Applying cached preset: %u\n"), (unsigned)index);
+  bool changePreset = compactStateChangesPreset(cached->state);
+  deserializeCompactState(cached->state);
+  if (!errorFlag && changePreset) currentPreset = index;
+  if (changePreset) notify(callMode); // force UDP notification
+  stateUpdated(callMode);
+  updateInterfaces(callMode);
+  return true;
+  #else
+  return false;
+  #endif
+}
+
+// request loading of a preset into preset cache (i.e. next preset of a playlist) while nothing else is going on
+void prefetchPreset(byte index) {
+  #if WLED_PRESET_CACHE_SIZE > 0
+  if (isPresetCacheable(index) && !findCachedPreset(index)) presetToPrefetch = index;
+  #endif
+}
+
+// writes preset object using background writer (LED updates continue during flash write) or synchronously if not possible
+// (strip is only suspended for saves requested from loop, API saves and deletes are written right away as before)
+// presetsModifiedTime (used by UI to reload presets) is updated once the preset is actually written
+static void writePresetToFile(byte index, const JsonDocument *doc, bool persist = true, bool suspendStrip = false) {
+  #ifdef ARDUINO_ARCH_ESP32
+  if (persist) {
+    char *data = nullptr;
+    size_t len = 0;
+    if (!doc->isNull()) {
+      len = measureJson(*doc);
+      data = static_cast<char*>(p_malloc(len + 1));
+      if (data) serializeJson(*doc, data, len + 1);
+    }
+    if ((data || doc->isNull()) && writeObjectInBackground(getPresetsFileName(), index, data, len)) return; // writer task updates presetsModifiedTime
+    p_free(data);
+  }
+  #endif
+  if (suspendStrip) {
+    strip.suspend();
+    unsigned long maxWait = millis() + strip.getFrameTime();
+    while (strip.isUpdating() && millis() < maxWait) delay(1); // wait for strip to finish updating, accessing FS during sendout causes glitches
+  }
+  writeObjectToFileUsingId(getPresetsFileName(persist), index, doc);
+  presetsWriteCount++;
+  if (suspendStrip) strip.resume();
+  if (persist) presetsModifiedTime = toki.second(); //unix time
+  updateFSInfo();
+}
+
 static void doSaveState() {
   bool persist = (presetToSave < 251);
 
-  unsigned long maxWait = millis() + strip.getFrameTime();
-  while (strip.isUpdating() && millis() < maxWait) delay(1); // wait for strip to finish updating, accessing FS during sendout causes glitches
-
   if (!requestJSONBufferLock(JSON_LOCK_PRESET_SAVE)) return;
 
   initPresetsFile(); // just in case if someone deleted presets.json using /edit
@@ -64,15 +192,13 @@ static void doSaveState() {
     if (tmpRAMbuffer!=nullptr) {
       serializeJson(*pDoc, tmpRAMbuffer, len);
     } else {
-      writeObjectToFileUsingId(getPresetsFileName(persist), presetToSave, pDoc);
+      writePresetToFile(presetToSave, pDoc, persist, true);
     }
   } else
   #endif
-  writeObjectToFileUsingId(getPresetsFileName(persist), presetToSave, pDoc);
+  writePresetToFile(presetToSave, pDoc, persist, true);
 
-  if (persist) presetsModifiedTime = toki.second(); //unix time
   releaseJSONBufferLock();
-  updateFSInfo();
 
   // clean up
   saveLedmap   = -1;
@@ -88,7 +214,9 @@ bool getPresetName(byte index, String& name)
 {
   if (!requestJSONBufferLock(JSON_LOCK_PRESET_NAME)) return false;
   bool presetExists = false;
-  if (readObjectFromFileUsingId(getPresetsFileName(), index, pDoc)) {
+  StaticJsonDocument<16> filter;
+  filter["n"] = true;
+  if (readObjectFromFileUsingId(getPresetsFileName(), index, pDoc, &filter)) {
     JsonObject fdo = pDoc->as<JsonObject>();
     if (fdo["n"]) {
       name = (const char*)(fdo["n"]);
@@ -101,6 +229,9 @@ bool getPresetName(byte index, String& name)
 
 void initPresetsFile()
 {
+  #ifdef WLED_ENABLE_PRESET_STORE
+  if (!initPresetStore()) errorFlag = ERR_FS_GENERAL;
+  #else
   char fileName[33]; strncpy_P(fileName, getPresetsFileName(), 32); fileName[32] = 0; //use PROGMEM safe copy as FS.open() does not
   if (WLED_FS.exists(fileName)) return;
 
@@ -114,14 +245,20 @@ void initPresetsFile()
   }
   serializeJson(doc, f);
   f.close();
+  #endif
 }
 
+// returns true if preset was applied immediately (from cache), otherwise it will be loaded by handlePresets()
 bool applyPresetFromPlaylist(byte index)
 {
   DEBUG_PRINTF_P(PSTR("Request to apply preset: %d\n"), index);
+  if (applyCachedPreset(index, CALL_MODE_DIRECT_CHANGE)) {
+    presetToApply = 0; // drop any outdated request
+    return true;
+  }
   presetToApply = index;
   callModeToApply = CALL_MODE_DIRECT_CHANGE;
-  return true;
+  return false;
 }
 
 bool applyPreset(byte index, byte callMode)
@@ -146,12 +283,47 @@ void handlePresets()
 {
   byte presetErrFlag = ERR_NONE;
   if (presetToSave) {
-    strip.suspend();
     doSaveState();
-    strip.resume();
     return;
   }
 
+  if (isFileWritePending()) return; // wait until presets are written before loading any
+
+  #ifdef WLED_ENABLE_PRESET_STORE
+  if (presetsImportPending) {
+    presetsImportPending = false;
+    if (importPresets(getPresetsFileName())) {
+      presetsModifiedTime = toki.second(); // UI reloads presets
+      presetsWriteCount++;
+      cacheInvalidate++;
+    } else errorFlag = ERR_FS_GENERAL;
+    return;
+  }
+  #endif
+
+  #if WLED_PRESET_CACHE_SIZE > 0
+  if (presetToApply && currentPlaylist >= 0 && applyCachedPreset(presetToApply, callModeToApply)) {
+    // applied pre-parsed preset from cache (no need for file system access or JSON buffer)
+    presetToApply = 0; //clear request for preset
+    callModeToApply = 0;
+    return;
+  }
+
+  if (presetToApply == 0 && presetToPrefetch) {
+    // nothing to apply, load requested preset into cache
+    if (!requestJSONBufferLock(JSON_LOCK_PRESET_LOAD)) return;
+    byte tmpPreset = presetToPrefetch;
+    presetToPrefetch = 0;
+    #if defined(ARDUINO_ARCH_ESP32S2) || defined(ARDUINO_ARCH_ESP32C3)
+    unsigned long maxWait = millis() + strip.getFrameTime();
+    while (strip.isUpdating() && millis() < maxWait) delay(1); // wait for strip to finish updating, accessing FS during sendout causes glitches
+    #endif
+    if (readObjectFromFileUsingId(getPresetsFileName(), tmpPreset, pDoc)) cachePreset(tmpPreset, pDoc->as<JsonObject>());
+    releaseJSONBufferLock();
+    return;
+  }
+  #endif
+
   if (presetToApply == 0 || !requestJSONBufferLock(JSON_LOCK_PRESET_LOAD)) return; // no preset waiting to apply, or JSON buffer is already allocated, return to loop until free
 
   bool changePreset = false;
@@ -180,6 +352,10 @@ void handlePresets()
   }
   fdo = pDoc->as<JsonObject>();
 
+  #if WLED_PRESET_CACHE_SIZE > 0
+  if (currentPlaylist >= 0 && presetErrFlag == ERR_NONE) cachePreset(tmpPreset, fdo); // must be done before deserializeState() modifies the object
+  #endif
+
   // only reset errorflag if previous error was preset-related
   if ((errorFlag == ERR_NONE) || (errorFlag == ERR_FS_PLOAD)) errorFlag = presetErrFlag;
 
@@ -260,9 +436,7 @@ void savePreset(byte index, const char* pname, JsonObject sObj)
         sObj.remove(F("psave"));
         if (sObj["n"].isNull()) sObj["n"] = saveName;
         initPresetsFile(); // just in case if someone deleted presets.json using /edit
-        writeObjectToFileUsingId(getPresetsFileName(), index, pDoc);
-        presetsModifiedTime = toki.second(); //unix time
-        updateFSInfo();
+        writePresetToFile(index, pDoc);
       }
       p_free(saveName);
       p_free(quickLoad);
@@ -279,7 +453,5 @@ void savePreset(byte index, const char* pname, JsonObject sObj)
 
 void deletePreset(byte index) {
   StaticJsonDocument<24> empty;
-  writeObjectToFileUsingId(getPresetsFileName(), index, &empty);
-  presetsModifiedTime = toki.second(); //unix time
-  updateFSInfo();
+  writePresetToFile(index, &empty);
 }
\ No newline at end of file
@@ -163,6 +163,34 @@ bool isAsterisksOnly(const char* str, byte maxLen)
 }
 
 
+// JSON buffer contention statistics (per module ID, unknown/usermod IDs are counted in slot 0)
+struct JsonLockStats {
+  uint32_t requests;
+  uint32_t failures;
+  uint64_t waitTotal; // us
+  uint32_t waitMax;   // us
+};
+static JsonLockStats jsonLockStats[JSON_LOCK_MAX+1];
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE jsonLockStatsMux = portMUX_INITIALIZER_UNLOCKED; // updated from loop, async_tcp and other tasks
+#endif
+
+static void updateJSONLockStats(uint8_t moduleID, unsigned long start, bool success)
+{
+  JsonLockStats &st = jsonLockStats[moduleID <= JSON_LOCK_MAX ? moduleID : 0];
+  uint32_t wait = micros() - start;
+#ifdef ARDUINO_ARCH_ESP32
+  portENTER_CRITICAL(&jsonLockStatsMux);
+#endif
+  if (st.requests < UINT32_MAX) st.requests++; // saturate
+  if (!success && st.failures < UINT32_MAX) st.failures++;
+  st.waitTotal += wait;
+  if (wait > st.waitMax) st.waitMax = wait;
+#ifdef ARDUINO_ARCH_ESP32
+  portEXIT_CRITICAL(&jsonLockStatsMux);
+#endif
+}
+
 //threading/network callback details: https://github.com/wled-dev/WLED/pull/2336#discussion_r762276994
 bool requestJSONBufferLock(uint8_t moduleID)
 {
@@ -171,11 +199,15 @@ bool requestJSONBufferLock(uint8_t moduleID)
     return false;
   }
 
+  unsigned long start = micros();
 #if defined(ARDUINO_ARCH_ESP32)
   // Use a recursive mutex type in case our task is the one holding the JSON buffer.
   // This can happen during large JSON web transactions.  In this case, we continue immediately
   // and then will return out below if the lock is still held.
-  if (xSemaphoreTakeRecursive(jsonBufferLockMutex, 250) == pdFALSE) return false;  // timed out waiting
+  if (xSemaphoreTakeRecursive(jsonBufferLockMutex, 250) == pdFALSE) {  // timed out waiting
+    updateJSONLockStats(moduleID, start, false);
+    return false;
+  }
 #elif defined(ARDUINO_ARCH_ESP8266)
   // If we're in system context, delay() won't return control to the user context, so there's
   // no point in waiting.
@@ -192,12 +224,14 @@ bool requestJSONBufferLock(uint8_t moduleID)
 #ifdef ARDUINO_ARCH_ESP32
     xSemaphoreGiveRecursive(jsonBufferLockMutex);
 #endif
+    updateJSONLockStats(moduleID, start, false);
     return false;
   }
 
   jsonBufferLock = moduleID ? moduleID : 255;
   DEBUG_PRINTF_P(PSTR("JSON buffer locked. (%d)\n"), jsonBufferLock);
   pDoc->clear();
+  updateJSONLockStats(moduleID, start, true);
   return true;
 }
 
@@ -212,6 +246,137 @@ void releaseJSONBufferLock()
 }
 
 
+/*
+ * Pool of JSON documents for responses (HTTP /json, WS state push)
+ * A pooled document has its own lock so that several responses can be transmitted concurrently
+ * while the global JSON buffer (pDoc) remains available to other modules.
+ * Serializing WLED state into a pooled document still requires exclusive access to the state, so
+ * requestJSONPoolDoc() also takes jsonBufferLockMutex (as if locking pDoc) which must be released using
+ * releaseJSONStateLock() as soon as the document is filled. The document itself is released by releaseJSONPoolDoc().
+ * Without pool (ESP8266, no PSRAM or all documents busy) the global JSON buffer is returned instead.
+ */
+#if WLED_JSON_POOL_SIZE > 0
+static JsonDocument *jsonPool[WLED_JSON_POOL_SIZE] = {nullptr};
+static volatile uint8_t jsonPoolOwner[WLED_JSON_POOL_SIZE] = {0};
+static volatile bool jsonPoolStateLock[WLED_JSON_POOL_SIZE] = {false};
+static portMUX_TYPE jsonPoolMux = portMUX_INITIALIZER_UNLOCKED;
+
+static int getJSONPoolIndex(const JsonDocument *doc)
+{
+  for (int i = 0; i < WLED_JSON_POOL_SIZE; i++) if (doc && jsonPool[i] == doc) return i;
+  return -1;
+}
+#endif
+
+void initJSONPool()
+{
+#if WLED_JSON_POOL_SIZE > 0
+  if (!psramFound()) return; // documents are only allocated in PSRAM
+  for (int i = 0; i < WLED_JSON_POOL_SIZE; i++) {
+    if (jsonPool[i]) continue;
+    jsonPool[i] = new PSRAMDynamicJsonDocument(JSON_BUFFER_SIZE);
+    if (jsonPool[i] && jsonPool[i]->capacity() == 0) { delete jsonPool[i]; jsonPool[i] = nullptr; } // allocation failed
+  }
+  DEBUG_PRINTF_P(PSTR("JSON pool: %d x %ubytes\n"), getJSONPoolSize(), JSON_BUFFER_SIZE);
+#endif
+}
+
+uint8_t getJSONPoolSize()
+{
+  uint8_t n = 0;
+#if WLED_JSON_POOL_SIZE > 0
+  for (int i = 0; i < WLED_JSON_POOL_SIZE; i++) if (jsonPool[i]) n++;
+#endif
+  return n;
+}
+
+JsonDocument *requestJSONPoolDoc(uint8_t moduleID)
+{
+#if WLED_JSON_POOL_SIZE > 0
+  int slot = -1;
+  portENTER_CRITICAL(&jsonPoolMux);
+  for (int i = 0; i < WLED_JSON_POOL_SIZE; i++) {
+    if (jsonPool[i] && !jsonPoolOwner[i]) {
+      jsonPoolOwner[i] = moduleID ? moduleID : 255;
+      slot = i;
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&jsonPoolMux);
+  if (slot >= 0) {
+    unsigned long start = micros();
+    // same exclusion as pDoc: state must not be modified while being serialized
+    if (xSemaphoreTakeRecursive(jsonBufferLockMutex, 250) == pdFALSE) {
+      jsonPoolOwner[slot] = 0;
+      updateJSONLockStats(moduleID, start, false);
+      return nullptr;
+    }
+    jsonPoolStateLock[slot] = true;
+    jsonPool[slot]->clear();
+    updateJSONLockStats(moduleID, start, true);
+    DEBUG_PRINTF_P(PSTR("JSON pool document %d locked. (%d)\n"), slot, moduleID);
+    return jsonPool[slot];
+  }
+#endif
+  return requestJSONBufferLock(moduleID) ? pDoc : nullptr; // no (free) pooled document, use global buffer
+}
+
+void releaseJSONStateLock(JsonDocument *doc)
+{
+#if WLED_JSON_POOL_SIZE > 0
+  int slot = getJSONPoolIndex(doc);
+  if (slot >= 0 && jsonPoolStateLock[slot]) {
+    jsonPoolStateLock[slot] = false;
+    xSemaphoreGiveRecursive(jsonBufferLockMutex);
+  }
+#endif
+  // global buffer: state stays locked until releaseJSONPoolDoc()
+}
+
+void releaseJSONPoolDoc(JsonDocument *doc)
+{
+#if WLED_JSON_POOL_SIZE > 0
+  int slot = getJSONPoolIndex(doc);
+  if (slot >= 0) {
+    releaseJSONStateLock(doc);
+    DEBUG_PRINTF_P(PSTR("JSON pool document %d released. (%d)\n"), slot, jsonPoolOwner[slot]);
+    jsonPoolOwner[slot] = 0;
+    return;
+  }
+#endif
+  if (doc == pDoc) releaseJSONBufferLock();
+}
+
+// adds JSON buffer usage & contention statistics to info object (used to size the JSON pool)
+void serializeJSONLockStats(JsonObject root)
+{
+  JsonObject jbuf = root.createNestedObject(F("jbuf"));
+  jbuf[F("pool")] = getJSONPoolSize();
+  uint8_t busy = jsonBufferLock ? 1 : 0;
+#if WLED_JSON_POOL_SIZE > 0
+  for (int i = 0; i < WLED_JSON_POOL_SIZE; i++) if (jsonPoolOwner[i]) busy++;
+#endif
+  jbuf[F("busy")] = busy;
+  JsonArray mods = jbuf.createNestedArray(F("mods")); // [module ID, requests, failures, avg wait (us), max wait (us)]
+  for (size_t i = 0; i <= JSON_LOCK_MAX; i++) {
+#ifdef ARDUINO_ARCH_ESP32
+    portENTER_CRITICAL(&jsonLockStatsMux);
+#endif
+    const JsonLockStats st = jsonLockStats[i]; // consistent copy
+#ifdef ARDUINO_ARCH_ESP32
+    portEXIT_CRITICAL(&jsonLockStatsMux);
+#endif
+    if (!st.requests) continue;
+    JsonArray m = mods.createNestedArray();
+    m.add(i ? i : JSON_LOCK_UNKNOWN);
+    m.add(st.requests);
+    m.add(st.failures);
+    m.add((uint32_t)(st.waitTotal / st.requests));
+    m.add(st.waitMax);
+  }
+}
+
+
 // extracts effect mode (or palette) name from names serialized string
 // caller must provide large enough buffer for name (including SR extensions)! maxLen is (buffersize - 1)
 uint8_t extractModeName(uint8_t mode, const char *src, char *dest, uint8_t maxLen)
@@ -376,10 +541,10 @@ void checkSettingsPIN(const char* pin) {
 }
 
 
-uint16_t crc16(const unsigned char* data_p, size_t length) {
+// crc of previous block may be passed to continue calculation over multiple blocks
+uint16_t crc16(const unsigned char* data_p, size_t length, uint16_t crc) {
   uint8_t x;
-  uint16_t crc = 0xFFFF;
-  if (!length) return 0x1D0F;
+  if (!length) return crc;
   while (length--) {
     x = crc >> 8 ^ *data_p++;
     x ^= x>>4;
@@ -444,6 +609,12 @@ um_data_t* simulateSound(uint8_t simulationId)
   static float    volumeSmth;
   static uint16_t volumeRaw;
   static float    my_magnitude;
+  static uint32_t audioSequence;
+  static uint32_t audioTimestamp;
+  static float    beatBPM;
+  static float    beatPhase;
+  static float    beatConfidence;
+  static uint8_t  numBands;
 
   //arrays
   uint8_t *fftResult;
@@ -458,7 +629,7 @@ um_data_t* simulateSound(uint8_t simulationId)
     // NOTE!!!
     // This may change as AudioReactive usermod may change
     um_data = new um_data_t;
-    um_data->u_size = 8;
+    um_data->u_size = 15;
     um_data->u_type = new um_types_t[um_data->u_size];
     um_data->u_data = new void*[um_data->u_size];
     um_data->u_data[0] = &volumeSmth;
@@ -469,12 +640,25 @@ um_data_t* simulateSound(uint8_t simulationId)
     um_data->u_data[5] = &my_magnitude;
     um_data->u_data[6] = &maxVol;
     um_data->u_data[7] = &binNum;
+    um_data->u_data[8] = &audioSequence;
+    um_data->u_data[9] = &audioTimestamp;
+    um_data->u_data[10] = &beatBPM;
+    um_data->u_data[11] = &beatPhase;
+    um_data->u_data[12] = &beatConfidence;
+    um_data->u_data[13] = fftResult;      // simulations only provide the 16 standard channels
+    um_data->u_data[14] = &numBands;
+    numBands = 16;
   } else {
     // get arrays from um_data
     fftResult =  (uint8_t*)um_data->u_data[2];
   }
 
   uint32_t ms = millis();
+  audioSequence++;        // simulated data is always fresh
+  audioTimestamp = ms;
+  beatBPM = 120;          // simulations don't follow a tempo, just provide a steady beat
+  beatPhase = (ms % 500) / 500.0f;
+  beatConfidence = 0;
 
   switch (simulationId) {
     default:
@@ -1132,6 +1316,210 @@ uint8_t perlin8(uint16_t x, uint16_t y, uint16_t z) {
   return (((perlin3D_raw((uint32_t)x << 8, (uint32_t)y << 8, (uint32_t)z << 8, true) * 2015) >> 10) + 33168) >> 8; //scale to 16 bit, offset, then scale to 8bit
 }
 
+/*
+ * 2D noise fields: noise(x + i*scaleX, y + j*scaleY, z) for a whole cols x rows grid, as used by most 2D noise effects
+ * - fields are cached: segments asking for the same field (same parameters) share the result, a field that only moved by whole grid
+ *   cells in x and/or y is scrolled and only the new columns/rows are calculated
+ * - NOISE_FIELD_FAST: if the noise is smooth enough at the given scale (grid spacing up to 1/4 of a noise cell) it is only
+ *   calculated on every 2nd, 4th or 8th pixel and bilinearly interpolated in between
+ * returned buffer (cols*rows values, row by row) is owned by the cache and valid until the next call; nullptr if out of memory
+ * (effects should then fall back to per pixel noise)
+ * WLED_DEBUG_NOISE prints average time per call (cache hit, scrolled, calculated) and of the equivalent per pixel loop every 5s
+ */
+struct NoiseField {
+  uint32_t x, y, z;         // coordinates of first grid point
+  uint32_t scaleX, scaleY;  // coordinate step per pixel
+  uint16_t cols, rows;      // field dimensions
+  uint16_t gridCols, gridRows; // dimensions of calculated grid
+  uint8_t  step;            // pixels per grid step (1, 2, 4 or 8)
+  uint8_t  flags;
+  unsigned long lastUsed;   // millis() of last use, unused fields are released
+  size_t   size;            // allocated size
+  uint8_t  *data;           // calculated noise values: 16 bit grid followed by the interpolated 8 bit field (8 bit field only if step is 1)
+
+  uint16_t *grid() const  { return reinterpret_cast<uint16_t*>(data); }
+  uint8_t  *field() const { return step == 1 ? data : data + gridCols * gridRows * sizeof(uint16_t); }
+};
+static NoiseField noiseFields[WLED_MAX_NOISE_FIELDS];
+
+// calculates noise values of grid points [fromCol, toCol) x [fromRow, toRow)
+static void calcNoiseGrid(const NoiseField &f, unsigned fromCol, unsigned toCol, unsigned fromRow, unsigned toRow) {
+  const uint32_t dx = f.scaleX * f.step;
+  const uint32_t dy = f.scaleY * f.step;
+  const bool is8bit = f.flags & NOISE_FIELD_8BIT;
+  for (unsigned j = fromRow; j < toRow; j++) {
+    const uint32_t y = f.y + j * dy;
+    if (f.step == 1) { // grid is the field
+      uint8_t *line = &f.data[j * f.gridCols];
+      for (unsigned i = fromCol; i < toCol; i++) {
+        const uint32_t x = f.x + i * dx;
+        line[i] = is8bit ? perlin8(x, y, f.z) : perlin16(x, y, f.z) >> 8;
+      }
+    } else {
+      uint16_t *line = &f.grid()[j * f.gridCols];
+      for (unsigned i = fromCol; i < toCol; i++) {
+        const uint32_t x = f.x + i * dx;
+        line[i] = is8bit ? perlin8(x, y, f.z) << 8 : perlin16(x, y, f.z);
+      }
+    }
+  }
+}
+
+// fills 8 bit field from grid using bilinear interpolation (step > 1)
+static void interpolateNoiseGrid(const NoiseField &f) {
+  const uint16_t *grid = f.grid();
+  uint8_t *field = f.field();
+  const unsigned shift = f.step == 2 ? 1 : f.step == 4 ? 2 : 3;
+  for (unsigned j = 0; j < f.rows; j++) {
+    const unsigned gj = j >> shift;
+    const unsigned fy = j & (f.step - 1);
+    const uint16_t *top    = &grid[gj * f.gridCols];
+    const uint16_t *bottom = &grid[min(gj + 1, (unsigned)f.gridRows - 1) * f.gridCols];
+    for (unsigned i = 0; i < f.cols; i++) {
+      const unsigned gi  = i >> shift;
+      const unsigned gi1 = min(gi + 1, (unsigned)f.gridCols - 1);
+      const unsigned fx  = i & (f.step - 1);
+      uint32_t t = top[gi]    * (f.step - fx) + top[gi1]    * fx;
+      uint32_t b = bottom[gi] * (f.step - fx) + bottom[gi1] * fx;
+      *field++ = ((t * (f.step - fy) + b * fy) >> (2 * shift)) >> 8;
+    }
+  }
+}
+
+#ifdef WLED_DEBUG_NOISE
+static uint32_t noiseCalls[3], noiseMicros[3]; // cache hit, scrolled, calculated
+static unsigned long noiseReport = 0;
+
+// compares getNoiseField() with the per pixel loop it replaces (measured once per report with parameters of last call)
+static void reportNoiseTiming(const NoiseField &f) {
+  if (millis() - noiseReport < 5000) return;
+  noiseReport = millis();
+  uint32_t us = micros();
+  uint32_t sink = 0;
+  for (unsigned j = 0; j < f.rows; j++) for (unsigned i = 0; i < f.cols; i++) {
+    const uint32_t x = f.x + i * f.scaleX, y = f.y + j * f.scaleY;
+    sink += (f.flags & NOISE_FIELD_8BIT) ? perlin8(x, y, f.z) : perlin16(x, y, f.z) >> 8;
+  }
+  us = micros() - us;
+  DEBUGOUT.printf_P(PSTR("Noise field %ux%u step %u: hit %uus (%u), scroll %uus (%u), full %uus (%u), per pixel %uus (%u)\n"), f.cols, f.rows, f.step,
+    noiseCalls[0] ? noiseMicros[0] / noiseCalls[0] : 0, noiseCalls[0],
+    noiseCalls[1] ? noiseMicros[1] / noiseCalls[1] : 0, noiseCalls[1],
+    noiseCalls[2] ? noiseMicros[2] / noiseCalls[2] : 0, noiseCalls[2], us, sink & 1);
+  memset(noiseCalls, 0, sizeof(noiseCalls));
+  memset(noiseMicros, 0, sizeof(noiseMicros));
+}
+#define NOISE_TIMING(kind, f) noiseMicros[kind] += micros() - noiseStart; noiseCalls[kind]++; reportNoiseTiming(f)
+#else
+#define NOISE_TIMING(kind, f)
+#endif
+
+const uint8_t *getNoiseField(unsigned cols, unsigned rows, uint32_t x, uint32_t y, uint32_t z, uint32_t scaleX, uint32_t scaleY, uint8_t flags) {
+  if (cols == 0 || rows == 0) return nullptr;
+  #ifdef WLED_DEBUG_NOISE
+  const uint32_t noiseStart = micros();
+  #endif
+  // grid step: noise is smooth enough to be interpolated within 1/4 of a noise cell
+  unsigned step = 1;
+  if (flags & NOISE_FIELD_FAST) {
+    const uint32_t cell = (flags & NOISE_FIELD_8BIT) ? 0x100 : 0x10000;
+    const uint32_t scale = max(scaleX, scaleY);
+    while (step < 8 && scale * step * 2 <= cell / 4) step *= 2;
+  }
+  const unsigned gridCols = (cols + step - 2) / step + 1; // last pixel needs to be on or before last grid point
+  const unsigned gridRows = (rows + step - 2) / step + 1;
+  const size_t   elemSize = step == 1 ? sizeof(uint8_t) : sizeof(uint16_t);
+
+  NoiseField *f = nullptr;
+  int shiftX = 0, shiftY = 0;
+  for (NoiseField &nf : noiseFields) {
+    if (!nf.data || nf.cols != cols || nf.rows != rows || nf.z != z || nf.scaleX != scaleX || nf.scaleY != scaleY || nf.step != step || nf.flags != flags) continue;
+    if (nf.x == x && nf.y == y) { // identical field
+      nf.lastUsed = millis();
+      NOISE_TIMING(0, nf);
+      return nf.field();
+    }
+    // can the field be scrolled by whole grid steps?
+    const int32_t dx = x - nf.x;
+    const int32_t dy = y - nf.y;
+    const int32_t gridX = scaleX * step;
+    const int32_t gridY = scaleY * step;
+    if ((dx && (gridX <= 0 || dx % gridX)) || (dy && (gridY <= 0 || dy % gridY))) continue;
+    const int sx = dx ? dx / gridX : 0;
+    const int sy = dy ? dy / gridY : 0;
+    if (abs(sx) >= (int)gridCols || abs(sy) >= (int)gridRows) continue;
+    f = &nf;
+    shiftX = sx;
+    shiftY = sy;
+    break;
+  }
+
+  if (f) {
+    // scroll grid and calculate missing columns/rows
+    uint8_t *grid = f->data;
+    const size_t   line  = gridCols * elemSize;
+    const unsigned absX = abs(shiftX);
+    const unsigned absY = abs(shiftY);
+    if (shiftY > 0)      memmove(grid, grid + absY * line, (gridRows - absY) * line);
+    else if (shiftY < 0) memmove(grid + absY * line, grid, (gridRows - absY) * line);
+    if (shiftX) for (unsigned j = 0; j < gridRows; j++) {
+      uint8_t *l = &grid[j * line];
+      if (shiftX > 0) memmove(l, l + absX * elemSize, (gridCols - absX) * elemSize);
+      else            memmove(l + absX * elemSize, l, (gridCols - absX) * elemSize);
+    }
+    f->x = x;
+    f->y = y;
+    const unsigned keepFrom = shiftY < 0 ? absY : 0;                 // rows kept from previous grid
+    const unsigned keepTo   = shiftY > 0 ? gridRows - absY : gridRows;
+    calcNoiseGrid(*f, 0, gridCols, 0, keepFrom);                      // new rows at top
+    calcNoiseGrid(*f, 0, gridCols, keepTo, gridRows);                 // new rows at bottom
+    if (shiftX > 0) calcNoiseGrid(*f, gridCols - absX, gridCols, keepFrom, keepTo); // new columns on the right
+    if (shiftX < 0) calcNoiseGrid(*f, 0, absX, keepFrom, keepTo);                   // new columns on the left
+  } else {
+    // use free slot or replace least recently used field; if all are in use (more segments than WLED_MAX_NOISE_FIELDS
+    // use noise fields) prefer one whose buffer is large enough, to avoid reallocating on every frame
+    const size_t size = step == 1 ? cols * rows : gridCols * gridRows * sizeof(uint16_t) + cols * rows;
+    NoiseField *lru = nullptr, *fits = nullptr;
+    for (NoiseField &nf : noiseFields) {
+      if (!lru || (lru->data && (!nf.data || (long)(nf.lastUsed - lru->lastUsed) < 0))) lru = &nf;
+      if (nf.data && nf.size >= size && (!fits || (long)(nf.lastUsed - fits->lastUsed) < 0)) fits = &nf;
+    }
+    f = (lru->data && fits) ? fits : lru;
+    if (f->size < size) {
+      uint8_t *data = static_cast<uint8_t*>(d_realloc_malloc(f->data, size)); // frees old buffer if reallocation fails
+      f->data = data;
+      f->size = data ? size : 0;
+      if (!data) return nullptr;
+    }
+    f->x = x;
+    f->y = y;
+    f->z = z;
+    f->scaleX = scaleX;
+    f->scaleY = scaleY;
+    f->cols = cols;
+    f->rows = rows;
+    f->gridCols = gridCols;
+    f->gridRows = gridRows;
+    f->step = step;
+    f->flags = flags;
+    calcNoiseGrid(*f, 0, gridCols, 0, gridRows);
+  }
+  f->lastUsed = millis();
+  if (step > 1) interpolateNoiseGrid(*f);
+  NOISE_TIMING(shiftX || shiftY ? 1 : 2, *f);
+  return f->field();
+}
+
+// frees noise fields that have not been used for a while
+void releaseNoiseFields(unsigned long idleTime) {
+  for (NoiseField &nf : noiseFields) {
+    if (nf.data && millis() - nf.lastUsed > idleTime) {
+      d_free(nf.data);
+      nf.data = nullptr;
+      nf.size = 0;
+    }
+  }
+}
+
 // Platform-agnostic SHA1 computation from String input
 String computeSHA1(const String& input) {
   #ifdef ESP8266
@@ -133,6 +133,7 @@ void WLED::loop()
     else if (!noWifiSleep)
       delay(1); //required to make sure ESP enters modem sleep (see #1184)
     #endif
+    if (!bootFirstFrame) bootFirstFrame = strip.getLastShow(); // time to first frame after power on
   }
   #ifdef WLED_DEBUG
   stripMillis = millis() - stripMillis;
@@ -252,7 +253,7 @@ void WLED::loop()
   }
 #endif
 
-  if (doReboot && (!doInitBusses || !configNeedsWrite)) // if busses have to be inited & saved, wait until next iteration
+  if (doReboot && (!doInitBusses || !configNeedsWrite) && !isFileWritePending()) // if busses have to be inited & saved (or are still being written), wait until next iteration
     reset();
 
 // DEBUG serial logging (every 30s)
@@ -362,8 +363,18 @@ void WLED::disableWatchdog() {
 }
 #endif
 
+// record duration of a boot phase and start timing the next one
+static void bootPhaseDone(unsigned phase, unsigned long &start)
+{
+  unsigned long now = millis();
+  bootPhaseMillis[phase] = now - start;
+  start = now;
+  DEBUG_PRINTF_P(PSTR("Boot phase %u took %u ms\n"), phase, (unsigned)bootPhaseMillis[phase]);
+}
+
 void WLED::setup()
 {
+  unsigned long setupStart = millis();
   #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_DISABLE_BROWNOUT_DET)
   WRITE_PERI_REG(RTC_CNTL_BROWN_OUT_REG, 0); //disable brownout detection
   #endif
@@ -430,6 +441,7 @@ void WLED::setup()
   } else {
     pDoc = new DynamicJsonDocument(JSON_BUFFER_SIZE);  // Use onboard RAM instead as a fallback
   }
+  initJSONPool(); // additional JSON documents for concurrent HTTP/WS responses (PSRAM only)
 #endif
 
 #if defined(ARDUINO_ARCH_ESP32)
@@ -449,6 +461,7 @@ void WLED::setup()
 
   DEBUG_PRINTF_P(PSTR("heap %u\n"), getFreeHeapSize());
 
+  unsigned long phaseStart = millis();
   bool fsinit = false;
   DEBUGFS_PRINTLN(F("Mount FS"));
 #ifdef ARDUINO_ARCH_ESP32
@@ -478,8 +491,10 @@ void WLED::setup()
       resetConfig();
     }
   }
+  bootPhaseDone(BOOT_PHASE_FS, phaseStart);
   DEBUG_PRINTLN(F("Reading config"));
   bool needsCfgSave = deserializeConfigFromFS();
+  bootPhaseDone(BOOT_PHASE_CFG, phaseStart);
   DEBUG_PRINTF_P(PSTR("heap %u\n"), getFreeHeapSize());
 
 #if defined(STATUSLED) && STATUSLED>=0
@@ -491,12 +506,15 @@ void WLED::setup()
 #endif
 
   DEBUG_PRINTLN(F("Initializing strip"));
+  phaseStart = millis(); // exclude status LED init
   beginStrip();
+  bootPhaseDone(BOOT_PHASE_STRIP, phaseStart);
   DEBUG_PRINTF_P(PSTR("heap %u\n"), getFreeHeapSize());
 
   DEBUG_PRINTLN(F("Usermods setup"));
   userSetup();
   UsermodManager::setup();
+  bootPhaseDone(BOOT_PHASE_UM, phaseStart);
   DEBUG_PRINTF_P(PSTR("heap %u\n"), getFreeHeapSize());
 
   if (needsCfgSave) serializeConfigToFS(); // usermods required new parameters; need to wait for strip to be initialised #4752
@@ -583,13 +601,18 @@ void WLED::setup()
   WRITE_PERI_REG(RTC_CNTL_BROWN_OUT_REG, 1); //enable brownout detector
   #endif
   markOTAvalid();
+
+  bootPhaseDone(BOOT_PHASE_NET, phaseStart);
+  bootPhaseDone(BOOT_PHASE_SETUP, setupStart);
 }
 
 void WLED::beginStrip()
 {
   // Initialize NeoPixel Strip and button
   strip.setTransition(0); // temporarily prevent transitions to reduce segment copies
+  unsigned long finalizeStart = millis();
   strip.finalizeInit(); // busses created during deserializeConfig() if config existed
+  bootPhaseDone(BOOT_PHASE_FINALIZE, finalizeStart);
   strip.makeAutoSegments();
   strip.setBrightness(0);
   strip.setShowCallback(handleOverlayDraw);
@@ -929,7 +952,9 @@ void WLED::handleConnection()
       sendImprovStateResponse(0x04);
       if (improvActive > 1) sendImprovIPRPCResult(ImprovRPCType::Command_Wifi);
     }
+    unsigned long ifStart = millis();
     initInterfaces();
+    if (!bootPhaseMillis[BOOT_PHASE_IF]) bootPhaseDone(BOOT_PHASE_IF, ifStart);
     userConnected();
     UsermodManager::connected();
     lastMqttReconnectAttempt = 0; // force immediate update
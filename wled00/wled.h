@@ -41,6 +41,7 @@
   #undef WLED_ENABLE_ADALIGHT      // disable has priority over enable
 #endif
 //#define WLED_ENABLE_DMX          // uses 3.5kb
+//#define WLED_ENABLE_PRESET_STORE // binary presets.bin instead of presets.json (generated on request), uses 4kb
 #ifndef WLED_DISABLE_LOXONE
   #define WLED_ENABLE_LOXONE       // uses 1.2kb
 #endif
@@ -433,6 +434,10 @@ WLED_GLOBAL char serverDescription[33] _INIT(SERVERNAME);  // use predefined nam
 #endif
 WLED_GLOBAL bool simplifiedUI          _INIT(false);   // enable simplified UI
 WLED_GLOBAL byte cacheInvalidate       _INIT(0);       // used to invalidate browser cache
+WLED_GLOBAL uint32_t stateVersion      _INIT(0);       // incremented on every state change (JSON response cache & ETag)
+WLED_GLOBAL uint32_t configVersion     _INIT(0);       // incremented on every config change (JSON response cache & ETag)
+WLED_GLOBAL uint32_t effectListVersion _INIT(0);       // incremented when effects are added (JSON response cache & ETag)
+WLED_GLOBAL uint32_t paletteVersion _INIT(0);          // incremented when custom palettes are (re)loaded, added or removed (JSON response cache & ETag)
 
 // Sync CONFIG
 WLED_GLOBAL NodesMap Nodes;
@@ -878,6 +883,10 @@ WLED_GLOBAL unsigned long ntpPacketSentTime _INIT(NTP_NEVER);
 WLED_GLOBAL IPAddress ntpServerIP;
 WLED_GLOBAL uint16_t ntpLocalPort _INIT(2390);
 WLED_GLOBAL uint16_t rolloverMillis _INIT(0);
+
+// boot profiling
+WLED_GLOBAL uint16_t bootPhaseMillis[BOOT_PHASES] _INIT_N(({ 0 })); // duration of individual boot phases (see BOOT_PHASE_*)
+WLED_GLOBAL unsigned long bootFirstFrame _INIT(0);                  // millis() when first frame was shown after boot
 WLED_GLOBAL float longitude _INIT(WLED_LON);
 WLED_GLOBAL float latitude _INIT(WLED_LAT);
 WLED_GLOBAL time_t sunrise _INIT(0);
@@ -888,6 +897,7 @@ WLED_GLOBAL Toki toki _INIT(Toki());
 WLED_GLOBAL size_t fsBytesUsed _INIT(0);
 WLED_GLOBAL size_t fsBytesTotal _INIT(0);
 WLED_GLOBAL unsigned long presetsModifiedTime _INIT(0L);
+WLED_GLOBAL uint32_t presetsWriteCount _INIT(0); // incremented by every write to presets file (presetsModifiedTime has only 1s resolution)
 WLED_GLOBAL bool doCloseFile _INIT(false);
 
 // presets
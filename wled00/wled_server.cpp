@@ -189,6 +189,16 @@ static String msgProcessor(const String& var)
 }
 
 
+// drops data derived from an uploaded or deleted file (called once file is complete or removed)
+static void invalidateFileDerivedData(const String &path) {
+  int slash = path.lastIndexOf('/');
+  const char *name = path.c_str() + slash + 1; // works with or without leading slash
+  if (strncmp_P(name, PSTR("ledmap"), 6) == 0 && path.endsWith(F(".json"))) WS2812FX::invalidateMap(atoi(name + 6)); // drop binary/cached copy
+  #ifdef WLED_ENABLE_GIF
+  if (path.endsWith(F(".gif"))) invalidateImageCache(); // drop pre-decoded frames
+  #endif
+}
+
 static void handleUpload(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool isFinal) {
   if (!correctPIN) {
     if (isFinal) request->send(401, FPSTR(CONTENT_TYPE_PLAIN), FPSTR(s_unlock_cfg));
@@ -202,17 +212,28 @@ static void handleUpload(AsyncWebServerRequest *request, const String& filename,
 
     request->_tempFile = WLED_FS.open(finalname, "w");
     DEBUG_PRINTF_P(PSTR("Uploading %s\n"), finalname.c_str());
-    if (finalname.equals(FPSTR(getPresetsFileName()))) presetsModifiedTime = toki.second();
+    if (finalname.equals(FPSTR(getPresetsFileName())) || finalname.equals(F("/presets.bin"))) invalidatePresetIndex();
   }
   if (len) {
     request->_tempFile.write(data,len);
   }
   if (isFinal) {
     request->_tempFile.close();
+    invalidateFileDerivedData(filename);
     if (filename.indexOf(F("cfg.json")) >= 0) { // check for filename with or without slash
       doReboot = true;
       request->send(200, FPSTR(CONTENT_TYPE_PLAIN), F("Config restore ok.\nRebooting..."));
+    #ifdef WLED_ENABLE_PRESET_STORE
+    } else if (filename.indexOf(F("presets.json")) >= 0) { // restore presets backup
+      requestPresetsImport(); // imported in loop, caches are invalidated once it succeeds
+      request->send(200, FPSTR(CONTENT_TYPE_PLAIN), F("Presets uploaded, restoring."));
+      return;
+    #endif
     } else {
+      if (filename.indexOf(F("presets.")) >= 0) { // presets.json (or presets.bin) replaced directly
+        presetsModifiedTime = toki.second();
+        presetsWriteCount++;
+      }
       if (filename.indexOf(F("palette")) >= 0 && filename.indexOf(F(".json")) >= 0) loadCustomPalettes();
       request->send(200, FPSTR(CONTENT_TYPE_PLAIN), F("File Uploaded!"));
     }
@@ -304,8 +325,10 @@ void createEditHandler() {
     if (func == "delete") {
       if (!WLED_FS.remove(path))
         request->send(500, FPSTR(CONTENT_TYPE_PLAIN), F("Delete failed"));
-      else
+      else {
+        invalidateFileDerivedData(path);
         request->send(200, FPSTR(CONTENT_TYPE_PLAIN), F("File deleted"));
+      }
       return;
     }
 
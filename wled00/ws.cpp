@@ -11,113 +11,415 @@ constexpr uint8_t BINARY_PROTOCOL_E131    = P_E131; // = 0, untested!
 constexpr uint8_t BINARY_PROTOCOL_ARTNET  = P_ARTNET; // = 1, untested!
 constexpr uint8_t BINARY_PROTOCOL_DDP     = P_DDP; // = 2
 
-uint16_t wsLiveClientId = 0;
 unsigned long wsLastLiveTime = 0;
-//uint8_t* wsFrameBuffer = nullptr;
+
+// reassembly of fragmented messages (messages split into multiple frames or frames split into multiple packets)
+#ifdef ESP8266
+#define WS_MAX_MESSAGE_SIZE  4096
+#define WS_MAX_FRAGMENTED    1     // number of clients with concurrent reassembly
+#elif defined(BOARD_HAS_PSRAM)
+#define WS_MAX_MESSAGE_SIZE  65536 // enough for a JSON_BUFFER_SIZE state or a full frame DDP packet
+#define WS_MAX_FRAGMENTED    4
+#else
+#define WS_MAX_MESSAGE_SIZE  16384
+#define WS_MAX_FRAGMENTED    2
+#endif
+
+struct WsFragmentBuffer {
+  uint32_t clientId;
+  uint8_t  opcode;  // message opcode (WS_TEXT or WS_BINARY)
+  size_t   len;     // received bytes
+  size_t   size;    // allocated bytes
+  uint8_t *data;    // allocated in PSRAM if available
+};
+static std::vector<WsFragmentBuffer> wsFragments;
+
+static void freeWsFragments(uint32_t clientId)
+{
+  for (auto it = wsFragments.begin(); it != wsFragments.end(); ++it) {
+    if (it->clientId != clientId) continue;
+    if (it->data) p_free(it->data);
+    wsFragments.erase(it);
+    return;
+  }
+}
 
 #define WS_LIVE_INTERVAL 40
+#define WS_LIVE_MAX_INTERVAL 500  // slowest adaptive live update interval (ms) for congested clients
+#define WS_LIVE_KEYFRAME     64   // full frame every n frames (resync)
+#define WS_LIVE_HEADER       8    // 'L', 3, flags, uint16 width, uint16 height, frame number
+#ifdef ESP8266
+#define WS_LIVE_MAX_CLIENTS  2
+#define WS_LIVE_MAX_PIXELS   1024 // larger setups fall back to the subsampled stream
+#else
+#define WS_LIVE_MAX_CLIENTS  4
+#define WS_LIVE_MAX_PIXELS   16384
+#endif
+
+/*
+ * Live LED view clients
+ * {"lv":true} subscribes to the subsampled raw RGB stream ('L' version 1 = 1D, 2 = 2D)
+ * {"lv":{"v":3,"565":false}} subscribes to the full resolution delta encoded stream ('L' version 3, see encodeLiveFrame())
+ * {"lv":false} unsubscribes; multiple clients may watch simultaneously
+ */
+struct WsLiveClient {
+  uint32_t clientId;
+  uint8_t  version;         // 1/2: legacy subsampled stream, 3: full resolution delta stream
+  bool     rgb565;          // quantize to RGB565 (version 3 only)
+  uint8_t  frame;           // frame counter (keyframe every WS_LIVE_KEYFRAME frames)
+  uint16_t interval;        // adaptive update interval (ms)
+  unsigned long lastSent;
+  uint16_t width, height;   // dimensions of previous frame
+  uint8_t *prev;            // previous frame as received by client (RGB888 or RGB565)
+};
+static std::vector<WsLiveClient> wsLiveClients;
+static uint8_t *wsLiveFrame = nullptr; // current frame scratch buffer (shared by all clients)
+static size_t   wsLiveFrameSize = 0;
+
+#ifdef ARDUINO_ARCH_ESP32
+// client lists are modified by WS events (async_tcp task) and used when sending from loop task
+static SemaphoreHandle_t wsMutex = xSemaphoreCreateRecursiveMutex();
+namespace {
+  struct WsLock {
+    WsLock()  { xSemaphoreTakeRecursive(wsMutex, portMAX_DELAY); }
+    ~WsLock() { xSemaphoreGiveRecursive(wsMutex); }
+  };
+}
+#else
+namespace {
+  struct WsLock {}; // single threaded
+}
+#endif
+
+/*
+ * Opt-in delta state protocol
+ * A client sends {"sub":{"state":true,"info":false,"bin":false,"ack":false}} to subscribe ({"sub":false} to leave).
+ * Subscribed clients receive only top-level state fields and segments that changed since the last message
+ * (or since the last acknowledged version {"ack":<v>} if "ack" was requested): {"v":<version>,"state":{...,"seg":[...]}}
+ * Deleted segments are sent as {"id":<id>,"stop":0}. Full snapshots ("full":true) are sent upon subscription
+ * and every WS_SNAPSHOT_INTERVAL ms for resync. With "bin" the state is sent as compact binary message (see writeBinaryDelta()).
+ */
+#define WS_TOPIC_STATE        0x01
+#define WS_TOPIC_INFO         0x02
+#define WS_SNAPSHOT_INTERVAL  60000 // full state snapshot for resync (ms)
+#define WS_INFO_INTERVAL      5000  // minimum interval for info updates to subscribed clients (unless config changed)
+#define WS_DELTA_TOP_KEYS     24    // number of tracked top-level state keys (others are always sent)
+#define WS_DELTA_MAX_UNACKED  8     // force snapshot if client does not acknowledge
+#ifdef ESP8266
+#define WS_MAX_SUBSCRIBERS    2
+#else
+#define WS_MAX_SUBSCRIBERS    8
+#endif
+#define WS_BIN_DELTA_HEADER   7     // 'D', protocol version, flags, uint32 state version
+#define WS_BIN_GLOBALS_SIZE   9
+#define WS_BIN_SEGMENT_SIZE   37    // id, 6x uint16 geometry, 12 bytes of settings, NUM_COLORS x RGBW
+
+struct WsSubscriber {
+  uint32_t clientId;
+  uint8_t  topics;
+  bool     binary;
+  bool     ackMode;
+  bool     needsSnapshot;
+  bool     pending;                        // changes could not be sent (client busy or out of memory), flushed by handleWs()
+  uint8_t  unacked;
+  uint32_t pendingVersion;                 // version of last message (ack mode)
+  uint32_t infoConfigVersion;
+  unsigned long lastSnapshot;
+  unsigned long lastInfo;
+  uint32_t baseTop[WS_DELTA_TOP_KEYS];     // hashes of top-level state key/values known to client
+  uint32_t baseSeg[MAX_NUM_SEGMENTS];      // hashes of segments known to client (0 = not present)
+  uint32_t pendingTop[WS_DELTA_TOP_KEYS];  // hashes sent but not yet acknowledged (ack mode)
+  uint32_t pendingSeg[MAX_NUM_SEGMENTS];
+};
+static std::vector<WsSubscriber> wsSubscribers;
+static std::vector<uint32_t> wsClientIds; // all connected clients (needed to serve legacy clients individually while subscribers exist)
+
+namespace {
+// Print adapter that only computes FNV-1a hash of printed content (to detect changes)
+class hashPrint : public Print {
+  uint32_t _hash;
+  public:
+  hashPrint() : _hash(2166136261UL) {};
+  size_t write(uint8_t c) { _hash = (_hash ^ c) * 16777619UL; return 1; }
+  size_t write(const uint8_t *buffer, size_t size) { for (size_t i = 0; i < size; i++) write(buffer[i]); return size; }
+  uint32_t hash() const { return _hash ? _hash : 1; } // 0 is reserved for "not present"
+};
+
+// Print adapter that only counts bytes (to determine buffer size)
+class countPrint : public Print {
+  size_t _count;
+  public:
+  countPrint() : _count(0) {};
+  size_t write(uint8_t c) { _count++; return 1; }
+  size_t write(const uint8_t *buffer, size_t size) { _count += size; return size; }
+  size_t size() const { return _count; }
+};
+
+// Print adapter for flat buffers
+class bufferPrint : public Print {
+  uint8_t* _buf;
+  size_t _size, _offset;
+  public:
+  bufferPrint(uint8_t* buf, size_t size) : _buf(buf), _size(size), _offset(0) {};
+  size_t write(const uint8_t *buffer, size_t size) {
+    size = std::min(size, _size - _offset);
+    memcpy(_buf + _offset, buffer, size);
+    _offset += size;
+    return size;
+  }
+  size_t write(uint8_t c) { return this->write(&c, 1); }
+  size_t size() const { return _offset; }
+};
+}; // anonymous namespace
+
+static WsSubscriber* findSubscriber(uint32_t clientId)
+{
+  for (auto &sub : wsSubscribers) if (sub.clientId == clientId) return &sub;
+  return nullptr;
+}
+
+static void removeSubscriber(uint32_t clientId)
+{
+  for (auto it = wsSubscribers.begin(); it != wsSubscribers.end(); ++it) {
+    if (it->clientId == clientId) { wsSubscribers.erase(it); return; }
+  }
+}
+
+// handles {"sub":{...}} request, returns false if subscription is not possible
+static bool wsSubscribe(AsyncWebSocketClient *client, JsonVariant sub)
+{
+  WsLock lock;
+  if (!sub.is<JsonObject>()) { // {"sub":false}
+    removeSubscriber(client->id());
+    if (wsSubscribers.empty()) wsSubscribers.shrink_to_fit();
+    return true;
+  }
+  WsSubscriber *s = findSubscriber(client->id());
+  if (!s) {
+    if (wsSubscribers.size() >= WS_MAX_SUBSCRIBERS) return false;
+    wsSubscribers.emplace_back();
+    s = &wsSubscribers.back();
+    memset(s, 0, sizeof(WsSubscriber));
+    s->clientId = client->id();
+  }
+  s->topics  = (getBoolVal(sub["state"], true) ? WS_TOPIC_STATE : 0) | (getBoolVal(sub["info"], false) ? WS_TOPIC_INFO : 0);
+  s->binary  = getBoolVal(sub[F("bin")], false);
+  s->ackMode = getBoolVal(sub[F("ack")], false);
+  s->needsSnapshot = true; // (re)subscription always starts with full snapshot
+  return true;
+}
+
+// handles {"ack":<version>}; client has received all messages up to version
+static void wsAcknowledge(uint32_t clientId, uint32_t version)
+{
+  WsLock lock;
+  WsSubscriber *s = findSubscriber(clientId);
+  if (!s || !s->ackMode || version != s->pendingVersion) return; // acknowledgements of older messages cannot be used as baseline
+  memcpy(s->baseTop, s->pendingTop, sizeof(s->baseTop));
+  memcpy(s->baseSeg, s->pendingSeg, sizeof(s->baseSeg));
+  s->unacked = 0;
+}
+
+static void setLiveClient(uint32_t clientId, JsonVariant lv)
+{
+  WsLock lock;
+  for (auto it = wsLiveClients.begin(); it != wsLiveClients.end(); ++it) {
+    if (it->clientId != clientId) continue;
+    if (it->prev) p_free(it->prev);
+    wsLiveClients.erase(it);
+    break;
+  }
+  if (lv.isNull() || (!lv.is<JsonObject>() && !lv.as<bool>())) {
+    if (wsLiveClients.empty() && wsLiveFrame) { p_free(wsLiveFrame); wsLiveFrame = nullptr; wsLiveFrameSize = 0; }
+    return;
+  }
+  if (wsLiveClients.size() >= WS_LIVE_MAX_CLIENTS) return;
+  WsLiveClient lc;
+  memset(&lc, 0, sizeof(lc));
+  lc.clientId = clientId;
+  lc.interval = WS_LIVE_INTERVAL;
+  if (lv.is<JsonObject>()) {
+    lc.version = lv["v"] | 1;
+    lc.rgb565  = lv[F("565")] | false;
+  }
+  wsLiveClients.push_back(lc);
+}
+
+// handles complete text (JSON) message
+static void handleWsText(AsyncWebSocketClient *client, uint8_t *data, size_t len)
+{
+  if (len > 0 && len < 10 && data[0] == 'p') {
+    // application layer ping/pong heartbeat.
+    // client-side socket layer ping packets are unanswered (investigate)
+    client->text(F("pong"));
+    return;
+  }
+
+  bool verboseResponse = false;
+  if (!requestJSONBufferLock(JSON_LOCK_WS_RECEIVE)) {
+    client->text(F("{\"error\":3}")); // ERR_NOBUF
+    return;
+  }
+
+  DeserializationError error = deserializeJson(*pDoc, data, len);
+  JsonObject root = pDoc->as<JsonObject>();
+  if (error || root.isNull()) {
+    releaseJSONBufferLock();
+    return;
+  }
+  if (root["v"] && root.size() == 1) {
+    //if the received value is just "{"v":true}", send only to this client
+    verboseResponse = true;
+  } else if (root.containsKey("lv")) {
+    setLiveClient(client->id(), root["lv"]);
+  } else if (root.containsKey(F("sub"))) {
+    if (!wsSubscribe(client, root[F("sub")])) DEBUG_PRINTLN(F("WS too many subscribers.")); // client will receive full state instead of snapshot
+    verboseResponse = true;
+  } else if (root.containsKey(F("ack")) && root.size() == 1) {
+    wsAcknowledge(client->id(), root[F("ack")].as<uint32_t>());
+  } else {
+    verboseResponse = deserializeState(root);
+  }
+  releaseJSONBufferLock();
+
+  if (!interfaceUpdateCallMode) { // individual client response only needed if no WS broadcast soon
+    if (verboseResponse) {
+      #ifndef WLED_DISABLE_MQTT
+      // publish state to MQTT as requested in wled#4643 even if only WS response selected
+      publishMqtt();
+      #endif
+      sendDataWs(client);
+    } else {
+      // we have to send something back otherwise WS connection closes
+      client->text(F("{\"success\":true}"));
+    }
+    // force broadcast in 500ms after updating client
+    //lastInterfaceUpdate = millis() - (INTERFACE_UPDATE_COOLDOWN -500); // ESP8266 does not like this
+  }
+}
+
+// handles complete binary (realtime) message
+// first byte determines protocol, the rest may contain several consecutive packets of that protocol
+// (i.e. all DDP packets or E1.31/Art-Net universes of a frame in a single message)
+static void handleWsBinary(AsyncWebSocketClient *client, uint8_t *data, size_t len)
+{
+  // Note: since e131_packet_t is "packed", the compiler handles alignment issues
+  //DEBUG_PRINTF_P(PSTR("WS binary message: len %u, byte0: %u\n"), len, data[0]);
+  if (len < 2) return;
+  const uint8_t protocol = data[0];
+  size_t offset = 1; // offset to skip protocol byte
+  while (offset < len) {
+    uint8_t *p = &data[offset];
+    size_t remaining = len - offset;
+    size_t pktLen;
+    switch (protocol) {
+      case BINARY_PROTOCOL_E131:
+        pktLen = remaining > E131_DMP_DATA ? E131_DMP_DATA + ((p[E131_DMP_COUNT] << 8) | p[E131_DMP_COUNT+1]) : SIZE_MAX;
+        break;
+      case BINARY_PROTOCOL_ARTNET:
+        pktLen = remaining > 18 ? 18 + ((p[16] << 8) | p[17]) : SIZE_MAX; // Art-Net header is 18 bytes, length is big endian
+        break;
+      case BINARY_PROTOCOL_DDP:
+        if (remaining < 10) return; // DDP header is 10 bytes
+        pktLen = 10 + ((p[8] << 8) | p[9]); // data length in bytes from DDP header
+        if (p[0] & DDP_TIMECODE_FLAG) pktLen += 4; // timecode flag adds 4 bytes to data length
+        break;
+      default:
+        return;
+    }
+    if (remaining < pktLen) {
+      // not enough data, prevent out of bounds read; single E1.31/Art-Net packets are forwarded as before (handler validates)
+      if (offset == 1 && protocol != BINARY_PROTOCOL_DDP) handleE131Packet((e131_packet_t*)p, client->remoteIP(), protocol);
+      return;
+    }
+    // could be a valid packet, forward to handler
+    handleE131Packet((e131_packet_t*)p, client->remoteIP(), protocol);
+    offset += pktLen;
+  }
+}
+
+// returns reassembly buffer after appending fragment, nullptr if message is discarded (too large, out of memory or out of order)
+static WsFragmentBuffer *appendWsFragment(uint32_t clientId, AwsFrameInfo *info, uint8_t *data, size_t len)
+{
+  WsFragmentBuffer *fb = nullptr;
+  for (auto &f : wsFragments) if (f.clientId == clientId) { fb = &f; break; }
+
+  if (info->num == 0 && info->index == 0) {
+    // first fragment of a new message
+    if (fb) freeWsFragments(clientId);
+    if (wsFragments.size() >= WS_MAX_FRAGMENTED) return nullptr;
+    wsFragments.push_back({clientId, info->opcode, 0, 0, nullptr});
+    fb = &wsFragments.back();
+  }
+  if (!fb) return nullptr; // start of message was discarded
+  if (fb->len + len > WS_MAX_MESSAGE_SIZE) {
+    DEBUG_PRINTLN(F("WS message too large."));
+    freeWsFragments(clientId);
+    return nullptr;
+  }
+  if (fb->len + len > fb->size) {
+    // grow buffer to hold the remainder of current frame (frame length is known, message length is not)
+    size_t newSize = MIN(WS_MAX_MESSAGE_SIZE, MAX(fb->len + (size_t)(info->len - info->index), fb->len + len));
+    uint8_t *newData = static_cast<uint8_t*>(p_malloc(newSize));
+    if (!newData) {
+      DEBUG_PRINTLN(F("WS reassembly buffer allocation failed."));
+      freeWsFragments(clientId);
+      return nullptr;
+    }
+    if (fb->data) {
+      memcpy(newData, fb->data, fb->len);
+      p_free(fb->data);
+    }
+    fb->data = newData;
+    fb->size = newSize;
+  }
+  memcpy(fb->data + fb->len, data, len);
+  fb->len += len;
+  return fb;
+}
 
 void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len)
 {
   if(type == WS_EVT_CONNECT){
     //client connected
     DEBUG_PRINTLN(F("WS client connected."));
+    {
+      WsLock lock;
+      wsClientIds.push_back(client->id());
+    }
     sendDataWs(client);
   } else if(type == WS_EVT_DISCONNECT){
     //client disconnected
-    if (client->id() == wsLiveClientId) wsLiveClientId = 0;
+    WsLock lock;
+    setLiveClient(client->id(), JsonVariant()); // remove live view client
+    freeWsFragments(client->id());
+    removeSubscriber(client->id());
+    for (auto it = wsClientIds.begin(); it != wsClientIds.end(); ++it) if (*it == client->id()) { wsClientIds.erase(it); break; }
     DEBUG_PRINTLN(F("WS client disconnected."));
   } else if(type == WS_EVT_DATA){
     // data packet
     AwsFrameInfo * info = (AwsFrameInfo*)arg;
-    if(info->final && info->index == 0 && info->len == len){
+    if(info->final && info->num == 0 && info->index == 0 && info->len == len){
       // the whole message is in a single frame and we got all of its data (max. 1428 bytes / ESP8266: 528 bytes)
-      if(info->opcode == WS_TEXT)
-      {
-        if (len > 0 && len < 10 && data[0] == 'p') {
-          // application layer ping/pong heartbeat.
-          // client-side socket layer ping packets are unanswered (investigate)
-          client->text(F("pong"));
-          return;
-        }
-
-        bool verboseResponse = false;
-        if (!requestJSONBufferLock(JSON_LOCK_WS_RECEIVE)) {
-          client->text(F("{\"error\":3}")); // ERR_NOBUF
-          return;
-        }
-
-        DeserializationError error = deserializeJson(*pDoc, data, len);
-        JsonObject root = pDoc->as<JsonObject>();
-        if (error || root.isNull()) {
-          releaseJSONBufferLock();
-          return;
-        }
-        if (root["v"] && root.size() == 1) {
-          //if the received value is just "{"v":true}", send only to this client
-          verboseResponse = true;
-        } else if (root.containsKey("lv")) {
-          wsLiveClientId = root["lv"] ? client->id() : 0;
-        } else {
-          verboseResponse = deserializeState(root);
-        }
-        releaseJSONBufferLock();
-
-        if (!interfaceUpdateCallMode) { // individual client response only needed if no WS broadcast soon
-          if (verboseResponse) {
-            #ifndef WLED_DISABLE_MQTT
-            // publish state to MQTT as requested in wled#4643 even if only WS response selected
-            publishMqtt();
-            #endif
-            sendDataWs(client);
-          } else {
-            // we have to send something back otherwise WS connection closes
-            client->text(F("{\"success\":true}"));
-          }
-          // force broadcast in 500ms after updating client
-          //lastInterfaceUpdate = millis() - (INTERFACE_UPDATE_COOLDOWN -500); // ESP8266 does not like this
-        }
-      }else if (info->opcode == WS_BINARY) {
-        // first byte determines protocol. Note: since e131_packet_t is "packed", the compiler handles alignment issues
-        //DEBUG_PRINTF_P(PSTR("WS binary message: len %u, byte0: %u\n"), len, data[0]);
-        int offset = 1; // offset to skip protocol byte
-        switch (data[0]) {
-          case BINARY_PROTOCOL_E131:
-            handleE131Packet((e131_packet_t*)&data[offset], client->remoteIP(), P_E131);
-            break;
-          case BINARY_PROTOCOL_ARTNET:
-            handleE131Packet((e131_packet_t*)&data[offset], client->remoteIP(), P_ARTNET);
-            break;
-          case BINARY_PROTOCOL_DDP:
-            if (len < 10 + offset) return; // DDP header is 10 bytes (+1 protocol byte)
-            size_t ddpDataLen = (data[8+offset] << 8) | data[9+offset]; // data length in bytes from DDP header
-            uint8_t flags = data[0+offset];
-            if ((flags & DDP_TIMECODE_FLAG) ) ddpDataLen += 4; // timecode flag adds 4 bytes to data length
-            if (len < (10 + offset + ddpDataLen)) return; // not enough data, prevent out of bounds read
-            // could be a valid DDP packet, forward to handler
-            handleE131Packet((e131_packet_t*)&data[offset], client->remoteIP(), P_DDP);
-        }
-      }
+      freeWsFragments(client->id()); // discard any incomplete message
+      if (info->opcode == WS_TEXT)        handleWsText(client, data, len);
+      else if (info->opcode == WS_BINARY) handleWsBinary(client, data, len);
     } else {
-      DEBUG_PRINTF_P(PSTR("WS multipart message: final %u index %u len %u total %u\n"), info->final, info->index, len, (uint32_t)info->len);
       //message is comprised of multiple frames or the frame is split into multiple packets
-      //if(info->index == 0){
-        //if (!wsFrameBuffer && len < 4096) wsFrameBuffer = new uint8_t[4096];
-      //}
-
-      //if (wsFrameBuffer && len < 4096 && info->index + info->)
-      //{
-
-      //}
-
-      if((info->index + len) == info->len){
-        if(info->final){
-          if(info->message_opcode == WS_TEXT) {
-            client->text(F("{\"error\":9}")); // ERR_JSON we do not handle split packets right now
-          }
-        }
+      DEBUG_PRINTF_P(PSTR("WS multipart message: final %u num %u index %u len %u total %u\n"), info->final, info->num, info->index, len, (uint32_t)info->len);
+      WsFragmentBuffer *fb = appendWsFragment(client->id(), info, data, len);
+      if (!fb) {
+        // message too large or out of memory, whole message is discarded
+        if (info->final && (info->index + len) == info->len && info->message_opcode == WS_TEXT) client->text(F("{\"error\":9}")); // ERR_JSON
+        return;
+      }
+      if (info->final && (info->index + len) == info->len) {
+        // last fragment of the last frame received, message complete
+        DEBUG_PRINTF_P(PSTR("WS message reassembled: %u bytes\n"), fb->len);
+        if (fb->opcode == WS_TEXT)        handleWsText(client, fb->data, fb->len);
+        else if (fb->opcode == WS_BINARY) handleWsBinary(client, fb->data, fb->len);
+        freeWsFragments(client->id());
       }
-      DEBUG_PRINTLN(F("WS multipart message."));
     }
   } else if(type == WS_EVT_ERROR){
     //error was received from the other end
@@ -132,11 +434,253 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
   }
 }
 
+// current hashes of serialized state (shared by all subscribers during a single sendDataWs() call)
+static uint32_t curTop[WS_DELTA_TOP_KEYS], curSeg[MAX_NUM_SEGMENTS];
+static uint32_t curBinTop, curBinSeg[MAX_NUM_SEGMENTS];
+
+static void hashJsonState(JsonObject state)
+{
+  memset(curTop, 0, sizeof(curTop));
+  memset(curSeg, 0, sizeof(curSeg));
+  size_t k = 0;
+  for (JsonPair kv : state) {
+    if (kv.key() == "seg") {
+      for (JsonObject seg : kv.value().as<JsonArray>()) {
+        unsigned id = seg["id"] | 0;
+        if (id >= MAX_NUM_SEGMENTS) continue;
+        hashPrint h;
+        serializeJson(seg, h);
+        curSeg[id] = h.hash();
+      }
+    } else if (k < WS_DELTA_TOP_KEYS) {
+      hashPrint h;
+      h.print(kv.key().c_str());
+      serializeJson(kv.value(), h);
+      curTop[k++] = h.hash();
+    }
+  }
+}
+
+static bool isKnownHash(const uint32_t *base, size_t n, uint32_t hash)
+{
+  for (size_t i = 0; i < n; i++) if (base[i] == hash) return true;
+  return false;
+}
+
+// writes JSON delta message; returns number of changed items (excluding info)
+static size_t writeJsonDelta(Print &out, const WsSubscriber &sub, JsonObject state, JsonObject info, bool full, bool withInfo)
+{
+  size_t changes = 0;
+  out.print(F("{\"v\":"));
+  out.print(stateVersion);
+  if (full) out.print(F(",\"full\":true"));
+  if (sub.topics & WS_TOPIC_STATE) {
+    out.print(F(",\"state\":{"));
+    bool first = true;
+    size_t k = 0;
+    for (JsonPair kv : state) {
+      if (kv.key() == "seg") continue;
+      // keys beyond WS_DELTA_TOP_KEYS are not tracked and always sent
+      if (!full && k < WS_DELTA_TOP_KEYS && isKnownHash(sub.baseTop, WS_DELTA_TOP_KEYS, curTop[k])) { k++; continue; }
+      k++;
+      if (!first) out.write(',');
+      first = false;
+      out.write('"'); out.print(kv.key().c_str()); out.print(F("\":"));
+      serializeJson(kv.value(), out);
+      changes++;
+    }
+    if (!first) out.write(',');
+    out.print(F("\"seg\":["));
+    first = true;
+    for (JsonObject seg : state["seg"].as<JsonArray>()) {
+      unsigned id = seg["id"] | 0;
+      if (!full && id < MAX_NUM_SEGMENTS && sub.baseSeg[id] == curSeg[id]) continue;
+      if (!first) out.write(',');
+      first = false;
+      serializeJson(seg, out);
+      changes++;
+    }
+    if (!full) for (size_t id = 0; id < MAX_NUM_SEGMENTS; id++) {
+      if (!sub.baseSeg[id] || curSeg[id]) continue; // segment was deleted
+      if (!first) out.write(',');
+      first = false;
+      out.printf_P(PSTR("{\"id\":%u,\"stop\":0}"), id);
+      changes++;
+    }
+    out.print(F("]}"));
+  }
+  if (withInfo) {
+    out.print(F(",\"info\":"));
+    serializeJson(info, out);
+  }
+  out.write('}');
+  return changes;
+}
+
+static inline void putU16(uint8_t *&p, uint16_t v) { *p++ = v & 0xFF; *p++ = v >> 8; }
+
+// global state record (WS_BIN_GLOBALS_SIZE bytes)
+static void encodeBinaryGlobals(uint8_t *p)
+{
+  *p++ = bri > 0;
+  *p++ = briLast;
+  putU16(p, transitionDelay/100);
+  *p++ = currentPreset;
+  *p++ = currentPlaylist < 0 ? 255 : currentPlaylist;
+  *p++ = strip.getMainSegmentId();
+  *p++ = realtimeOverride;
+  *p++ = nightlightActive;
+}
+
+// segment record (WS_BIN_SEGMENT_SIZE bytes), little endian; a segment with stop==0 is deleted/inactive
+static_assert(WS_BIN_SEGMENT_SIZE == 1 + 6*2 + 12 + NUM_COLORS*4, "Binary segment record size mismatch.");
+static void encodeBinarySegment(uint8_t *p, unsigned id)
+{
+  memset(p, 0, WS_BIN_SEGMENT_SIZE);
+  p[0] = id;
+  if (id >= strip.getSegmentsNum() || !strip.getSegment(id).isActive()) return;
+  const Segment &sg = strip.getSegment(id);
+  p++;
+  putU16(p, sg.options);
+  putU16(p, sg.start);
+  putU16(p, sg.stop);
+  putU16(p, sg.startY);
+  putU16(p, sg.stopY);
+  putU16(p, sg.offset);
+  *p++ = sg.grouping;
+  *p++ = sg.spacing;
+  *p++ = sg.opacity;
+  *p++ = sg.cct;
+  *p++ = sg.mode;
+  *p++ = sg.palette;
+  *p++ = sg.speed;
+  *p++ = sg.intensity;
+  *p++ = sg.custom1;
+  *p++ = sg.custom2;
+  *p++ = sg.custom3 | (sg.check1 << 5) | (sg.check2 << 6) | (sg.check3 << 7);
+  *p++ = sg.blendMode;
+  for (unsigned i = 0; i < NUM_COLORS; i++) {
+    *p++ = R(sg.colors[i]); *p++ = G(sg.colors[i]); *p++ = B(sg.colors[i]); *p++ = W(sg.colors[i]);
+  }
+}
+
+static void hashBinaryState()
+{
+  uint8_t rec[WS_BIN_SEGMENT_SIZE];
+  hashPrint g;
+  encodeBinaryGlobals(rec);
+  g.write(rec, WS_BIN_GLOBALS_SIZE);
+  curBinTop = g.hash();
+  for (size_t id = 0; id < MAX_NUM_SEGMENTS; id++) {
+    encodeBinarySegment(rec, id);
+    if ((rec[5] | (rec[6] << 8)) == 0) { curBinSeg[id] = 0; continue; } // stop == 0 -> not present
+    hashPrint h;
+    h.write(rec, WS_BIN_SEGMENT_SIZE);
+    curBinSeg[id] = h.hash();
+  }
+}
+
+/*
+ * Binary delta message (state topic only, info is sent as JSON text):
+ * 'D', 1 (protocol version), flags (bit0: full snapshot, bit1: globals present), uint32 state version,
+ * [globals: on, bri, transition (uint16, 100ms), ps, pl (255=none), mainseg, lor, nl.on],
+ * number of segment records, records: id, options (uint16), start, stop, startY, stopY, offset (uint16),
+ * grp, spc, opacity, cct, fx, pal, sx, ix, c1, c2, c3|o1<<5|o2<<6|o3<<7, bm, 3x RGBW
+ * Returns message size, writes only if buffer is given.
+ */
+static size_t writeBinaryDelta(uint8_t *buf, const WsSubscriber &sub, bool full)
+{
+  bool globals = full || sub.baseTop[0] != curBinTop;
+  size_t nSeg = 0;
+  for (size_t id = 0; id < MAX_NUM_SEGMENTS; id++) if (full ? curBinSeg[id] : sub.baseSeg[id] != curBinSeg[id]) nSeg++;
+  size_t len = WS_BIN_DELTA_HEADER + (globals ? WS_BIN_GLOBALS_SIZE : 0) + 1 + nSeg * WS_BIN_SEGMENT_SIZE;
+  if (!buf || (!globals && !nSeg)) return (globals || nSeg) ? len : 0;
+  uint8_t *p = buf;
+  *p++ = 'D';
+  *p++ = 1;
+  *p++ = full | (globals << 1);
+  *p++ = stateVersion; *p++ = stateVersion >> 8; *p++ = stateVersion >> 16; *p++ = stateVersion >> 24;
+  if (globals) { encodeBinaryGlobals(p); p += WS_BIN_GLOBALS_SIZE; }
+  *p++ = nSeg;
+  for (size_t id = 0; id < MAX_NUM_SEGMENTS; id++) {
+    if (full ? curBinSeg[id] : sub.baseSeg[id] != curBinSeg[id]) { encodeBinarySegment(p, id); p += WS_BIN_SEGMENT_SIZE; }
+  }
+  return len;
+}
+
+// sends state changes since last (acknowledged) message to a subscribed client; JSON buffer must be locked
+static void sendDeltaWs(WsSubscriber &sub, AsyncWebSocketClient *client, JsonObject state, JsonObject info)
+{
+  if (client->queueLength() > 0 && !sub.needsSnapshot) { sub.pending = true; return; } // client is lagging behind, handleWs() sends accumulated changes once its queue drains
+  unsigned long now = millis();
+  if (sub.unacked > WS_DELTA_MAX_UNACKED || now - sub.lastSnapshot > WS_SNAPSHOT_INTERVAL) sub.needsSnapshot = true;
+  bool full = sub.needsSnapshot;
+  bool withInfo = (sub.topics & WS_TOPIC_INFO) && (full || sub.infoConfigVersion != configVersion || now - sub.lastInfo > WS_INFO_INTERVAL);
+
+  if (sub.binary) {
+    if (withInfo) {
+      countPrint cnt;
+      cnt.print(F("{\"info\":")); serializeJson(info, cnt); cnt.write('}');
+      AsyncWebSocketBuffer wsBuf(cnt.size());
+      if (wsBuf) {
+        bufferPrint out(reinterpret_cast<uint8_t*>(wsBuf.data()), cnt.size());
+        out.print(F("{\"info\":")); serializeJson(info, out); out.write('}');
+        client->text(std::move(wsBuf));
+      }
+    }
+    size_t len = (sub.topics & WS_TOPIC_STATE) ? writeBinaryDelta(nullptr, sub, full) : 0;
+    if (len) {
+      AsyncWebSocketBuffer wsBuf(len);
+      if (!wsBuf) { sub.pending = true; return; } //out of memory, try again next time
+      writeBinaryDelta(reinterpret_cast<uint8_t*>(wsBuf.data()), sub, full);
+      client->binary(std::move(wsBuf));
+    }
+  } else {
+    countPrint cnt;
+    size_t changes = writeJsonDelta(cnt, sub, state, info, full, withInfo);
+    if (!changes && !withInfo && !full) { sub.pending = false; return; } // nothing to send
+    AsyncWebSocketBuffer wsBuf(cnt.size());
+    if (!wsBuf) { sub.pending = true; return; } //out of memory, try again next time
+    bufferPrint out(reinterpret_cast<uint8_t*>(wsBuf.data()), cnt.size());
+    writeJsonDelta(out, sub, state, info, full, withInfo);
+    client->text(std::move(wsBuf));
+  }
+
+  // update baseline
+  sub.pending = false;
+  const uint32_t *top = sub.binary ? &curBinTop : curTop;
+  const size_t   nTop = sub.binary ? 1 : WS_DELTA_TOP_KEYS;
+  const uint32_t *seg = sub.binary ? curBinSeg : curSeg;
+  if (sub.ackMode) {
+    memcpy(sub.pendingTop, top, nTop*sizeof(uint32_t));
+    memcpy(sub.pendingSeg, seg, sizeof(sub.pendingSeg));
+    sub.pendingVersion = stateVersion;
+    if (full) { // snapshot is the new baseline until acknowledged otherwise
+      memcpy(sub.baseTop, top, nTop*sizeof(uint32_t));
+      memcpy(sub.baseSeg, seg, sizeof(sub.baseSeg));
+    }
+    sub.unacked++;
+  } else {
+    memcpy(sub.baseTop, top, nTop*sizeof(uint32_t));
+    memcpy(sub.baseSeg, seg, sizeof(sub.baseSeg));
+  }
+  if (full) {
+    sub.needsSnapshot = false;
+    sub.lastSnapshot  = now;
+    sub.unacked       = 0;
+  }
+  if (withInfo) {
+    sub.lastInfo = now;
+    sub.infoConfigVersion = configVersion;
+  }
+}
+
 void sendDataWs(AsyncWebSocketClient * client)
 {
   if (!ws.count()) return;
 
-  if (!requestJSONBufferLock(JSON_LOCK_WS_SEND)) {
+  JsonDocument *doc = requestJSONPoolDoc(JSON_LOCK_WS_SEND);
+  if (!doc) {
     const char* error = PSTR("{\"error\":3}");
     if (client) {
       client->text(FPSTR(error)); // ERR_NOBUF
@@ -146,13 +690,32 @@ void sendDataWs(AsyncWebSocketClient * client)
     return;
   }
 
-  JsonObject state = pDoc->createNestedObject("state");
+  JsonObject state = doc->createNestedObject("state");
   serializeState(state);
-  JsonObject info  = pDoc->createNestedObject("info");
+  JsonObject info  = doc->createNestedObject("info");
   serializeInfo(info);
 
-  size_t len = measureJson(*pDoc);
-  DEBUG_PRINTF_P(PSTR("JSON buffer size: %u for WS request (%u).\n"), pDoc->memoryUsage(), len);
+  WsLock lock; // taken after JSON document (same order as in handleWsText()) to avoid deadlock
+  if (!wsSubscribers.empty()) {
+    bool hasBinary = false;
+    for (const auto &sub : wsSubscribers) hasBinary |= sub.binary;
+    hashJsonState(state);
+    if (hasBinary) hashBinaryState();
+    for (auto &sub : wsSubscribers) {
+      if (client && client->id() != sub.clientId) continue;
+      AsyncWebSocketClient *wsc = client ? client : ws.client(sub.clientId);
+      if (wsc) sendDeltaWs(sub, wsc, state, info);
+    }
+    // are there any legacy (non-subscribed) clients left?
+    if (client ? findSubscriber(client->id()) != nullptr : wsClientIds.size() <= wsSubscribers.size()) {
+      releaseJSONPoolDoc(doc);
+      return;
+    }
+  }
+  releaseJSONStateLock(doc); // pooled document is filled, allow state changes while sending
+
+  size_t len = measureJson(*doc);
+  DEBUG_PRINTF_P(PSTR("JSON buffer size: %u for WS request (%u).\n"), doc->memoryUsage(), len);
 
   // the following may no longer be necessary as heap management has been fixed by @willmmiles in AWS
   size_t heap1 = getFreeHeapSize();
@@ -165,24 +728,35 @@ void sendDataWs(AsyncWebSocketClient * client)
   size_t heap2 = 0; // ESP32 variants do not have the same issue and will work without checking heap allocation
   #endif
   if (!buffer || heap1-heap2<len) {
-    releaseJSONBufferLock();
+    releaseJSONPoolDoc(doc);
     DEBUG_PRINTLN(F("WS buffer allocation failed."));
     ws.closeAll(1013); //code 1013 = temporary overload, try again later
     ws.cleanupClients(0); //disconnect all clients to release memory
     return; //out of memory
   }
-  serializeJson(*pDoc, (char *)buffer.data(), len);
+  serializeJson(*doc, (char *)buffer.data(), len);
 
   DEBUG_PRINT(F("Sending WS data "));
   if (client) {
     DEBUG_PRINTLN(F("to a single client."));
     client->text(std::move(buffer));
-  } else {
+  } else if (wsSubscribers.empty()) {
     DEBUG_PRINTLN(F("to multiple clients."));
     ws.textAll(std::move(buffer));
+  } else {
+    DEBUG_PRINTLN(F("to legacy clients."));
+    for (uint32_t id : wsClientIds) {
+      if (findSubscriber(id)) continue;
+      AsyncWebSocketClient *wsc = ws.client(id);
+      if (!wsc) continue;
+      AsyncWebSocketBuffer copy(len);
+      if (!copy) break;
+      memcpy(copy.data(), buffer.data(), len);
+      wsc->text(std::move(copy));
+    }
   }
 
-  releaseJSONBufferLock();
+  releaseJSONPoolDoc(doc);
 }
 
 bool sendLiveLedsWs(uint32_t wsClient)
@@ -244,19 +818,167 @@ bool sendLiveLedsWs(uint32_t wsClient)
   return true;
 }
 
+static inline void putVarint(uint8_t *&p, size_t &len, uint32_t v)
+{
+  do {
+    uint8_t b = v & 0x7F;
+    v >>= 7;
+    if (v) b |= 0x80;
+    if (p) *p++ = b;
+    len++;
+  } while (v);
+}
+
+/*
+ * Encodes frame against previous frame (live view version 3). Operations are encoded as varint (count << 2 | type):
+ * type 0: skip count pixels (unchanged), type 1: count literal pixels follow, type 2: repeat following pixel count times
+ * Pixels are RGB (3 bytes) or RGB565 (2 bytes, little endian). Keyframes (no previous frame) contain no skip operations.
+ * Returns encoded size, writes only if out is given.
+ */
+static size_t encodeLiveFrame(uint8_t *out, const uint8_t *cur, const uint8_t *prev, size_t n, size_t bpp)
+{
+  size_t len = 0;
+  auto same   = [&](size_t i) { return prev && memcmp(cur + i*bpp, prev + i*bpp, bpp) == 0; };
+  auto repeat = [&](size_t i) { return i+2 < n && memcmp(cur + i*bpp, cur + (i+1)*bpp, bpp) == 0 && memcmp(cur + i*bpp, cur + (i+2)*bpp, bpp) == 0; };
+  size_t i = 0;
+  while (i < n) {
+    size_t j = i;
+    if (same(i)) {
+      while (j < n && same(j)) j++;
+      putVarint(out, len, ((j-i) << 2) | 0);
+    } else if (repeat(i)) {
+      while (j < n && memcmp(cur + i*bpp, cur + j*bpp, bpp) == 0) j++;
+      putVarint(out, len, ((j-i) << 2) | 2);
+      if (out) { memcpy(out, cur + i*bpp, bpp); out += bpp; }
+      len += bpp;
+    } else {
+      j++;
+      while (j < n && !(same(j) && (j+1 >= n || same(j+1))) && !repeat(j)) j++; // stop at unchanged or repeating run
+      putVarint(out, len, ((j-i) << 2) | 1);
+      if (out) { memcpy(out, cur + i*bpp, (j-i)*bpp); out += (j-i)*bpp; }
+      len += (j-i)*bpp;
+    }
+    i = j;
+  }
+  return len;
+}
+
+// sends full resolution frame (changed pixels only) to live view client, returns false if not sent
+static bool sendLiveLedsDeltaWs(WsLiveClient &lc, AsyncWebSocketClient *wsc)
+{
+  size_t w = strip.getLengthTotal();
+  size_t h = 1;
+#ifndef WLED_DISABLE_2D
+  if (strip.isMatrix) {
+    // ignore anything behind matrix (i.e. extra strip)
+    w = Segment::maxWidth;
+    h = Segment::maxHeight;
+  }
+#endif
+  const size_t n   = w*h;
+  const size_t bpp = lc.rgb565 ? 2 : 3;
+  if (n == 0 || n > WS_LIVE_MAX_PIXELS) return sendLiveLedsWs(lc.clientId); // too large, use subsampled stream
+
+  if (!lc.prev || lc.width != w || lc.height != h) {
+    if (lc.prev) p_free(lc.prev);
+    lc.prev = static_cast<uint8_t*>(p_malloc(n*bpp));
+    if (!lc.prev) return sendLiveLedsWs(lc.clientId); // out of memory, use subsampled stream
+    lc.width  = w;
+    lc.height = h;
+    lc.frame  = 0; // force keyframe
+  }
+  if (wsLiveFrameSize < n*3) {
+    if (wsLiveFrame) p_free(wsLiveFrame);
+    wsLiveFrame = static_cast<uint8_t*>(p_malloc(n*3));
+    wsLiveFrameSize = wsLiveFrame ? n*3 : 0;
+    if (!wsLiveFrame) return false;
+  }
+
+  uint8_t *cur = wsLiveFrame;
+  for (size_t i = 0; i < n; i++) {
+    uint32_t c = strip.getPixelColor(i); // note: LEDs mapped outside of valid range are set to black
+    uint8_t w8 = W(c);
+    uint8_t r = bri ? qadd8(w8, R(c)) : 0; //R, add white channel to RGB channels as a simple RGBW -> RGB map
+    uint8_t g = bri ? qadd8(w8, G(c)) : 0; //G
+    uint8_t b = bri ? qadd8(w8, B(c)) : 0; //B
+    if (lc.rgb565) {
+      uint16_t c565 = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+      *cur++ = c565 & 0xFF;
+      *cur++ = c565 >> 8;
+    } else {
+      *cur++ = r;
+      *cur++ = g;
+      *cur++ = b;
+    }
+  }
+
+  const bool keyframe = (lc.frame % WS_LIVE_KEYFRAME) == 0;
+  if (!keyframe && memcmp(wsLiveFrame, lc.prev, n*bpp) == 0) return true; // nothing changed
+  const uint8_t *prev = keyframe ? nullptr : lc.prev;
+  size_t len = encodeLiveFrame(nullptr, wsLiveFrame, prev, n, bpp);
+
+  AsyncWebSocketBuffer wsBuf(WS_LIVE_HEADER + len);
+  if (!wsBuf) return false; //out of memory
+  uint8_t* buffer = reinterpret_cast<uint8_t*>(wsBuf.data());
+  buffer[0] = 'L';
+  buffer[1] = 3; //version
+  buffer[2] = keyframe | (lc.rgb565 << 1);
+  buffer[3] = w & 0xFF; buffer[4] = w >> 8;
+  buffer[5] = h & 0xFF; buffer[6] = h >> 8;
+  buffer[7] = lc.frame;
+  encodeLiveFrame(buffer + WS_LIVE_HEADER, wsLiveFrame, prev, n, bpp);
+  memcpy(lc.prev, wsLiveFrame, n*bpp); // client now has this frame
+  lc.frame++;
+
+  wsc->binary(std::move(wsBuf));
+  return true;
+}
+
 void handleWs()
 {
-  if (millis() - wsLastLiveTime > WS_LIVE_INTERVAL)
+  unsigned long now = millis();
+  if (now - wsLastLiveTime > WS_LIVE_INTERVAL)
   {
     #ifdef ESP8266
     ws.cleanupClients(3);
     #else
     ws.cleanupClients();
     #endif
-    bool success = true;
-    if (wsLiveClientId) success = sendLiveLedsWs(wsLiveClientId);
-    wsLastLiveTime = millis();
-    if (!success) wsLastLiveTime -= 20; //try again in 20ms if failed due to non-empty WS queue
+    wsLastLiveTime = now;
+
+    // flush changes held back while a subscriber was busy and send periodic snapshots without waiting for a state change
+    uint32_t flushIds[WS_MAX_SUBSCRIBERS];
+    size_t nFlush = 0;
+    {
+      WsLock lock;
+      for (const auto &sub : wsSubscribers) {
+        if (!sub.pending && !sub.needsSnapshot && now - sub.lastSnapshot <= WS_SNAPSHOT_INTERVAL) continue;
+        AsyncWebSocketClient *wsc = ws.client(sub.clientId);
+        if (wsc && wsc->queueLength() == 0) flushIds[nFlush++] = sub.clientId;
+      }
+    }
+    // sendDataWs() locks JSON buffer first, WS lock must not be held here
+    for (size_t i = 0; i < nFlush; i++) {
+      AsyncWebSocketClient *wsc = ws.client(flushIds[i]);
+      if (wsc) sendDataWs(wsc);
+    }
+  }
+
+  WsLock lock; // client may be removed (and its frame freed) by WS event meanwhile
+  for (auto &lc : wsLiveClients) {
+    if (now - lc.lastSent < lc.interval) continue;
+    AsyncWebSocketClient *wsc = ws.client(lc.clientId);
+    if (!wsc) continue; // will be removed upon disconnect event
+    if (wsc->queueLength() > 0) {
+      // client (or network) cannot keep up: back off and try again later
+      lc.interval = MIN(WS_LIVE_MAX_INTERVAL, lc.interval + lc.interval/2);
+      lc.lastSent = now - lc.interval + 20; // retry in 20ms
+      continue;
+    }
+    bool success = (lc.version >= 3) ? sendLiveLedsDeltaWs(lc, wsc) : sendLiveLedsWs(lc.clientId);
+    lc.lastSent = now;
+    if (!success) lc.lastSent -= lc.interval - 20; //try again in 20ms if failed
+    else if (lc.interval > WS_LIVE_INTERVAL) lc.interval = MAX(WS_LIVE_INTERVAL, lc.interval - lc.interval/8); // recover rate
   }
 }
 